@@ -269,6 +269,15 @@ bool AbstractCommand::execute()
           }
           segments_.push_back(segment);
         }
+        if (segments_.empty()) {
+          // No free segment is left.  Take over the segment of a much
+          // slower connection so that it does not hold up the
+          // completion of the download.
+          auto segment = sm->stealSegment(getCuid());
+          if (segment) {
+            segments_.push_back(segment);
+          }
+        }
         if (segments_.empty()) {
           // TODO socket could be pooled here if pipelining is
           // enabled...  Hmm, I don't think if pipelining is enabled
@@ -455,6 +464,13 @@ bool AbstractCommand::prepareForRetry(time_t wait)
     }
   }
 
+  if (requestGroup_->shouldShedConnection(getCuid())) {
+    A2_LOG_INFO(fmt("CUID#%" PRId64 " - Closing this connection to reduce"
+                    " the number of connections.",
+                    getCuid()));
+    return true;
+  }
+
   auto command =
       make_unique<CreateRequestCommand>(getCuid(), requestGroup_, e_);
   if (wait == 0) {
@@ -773,7 +789,14 @@ std::string AbstractCommand::resolveHostname(std::vector<std::string>& addrs,
     return ipaddr;
   }
 
+  if (e_->isHostNotFoundCached(hostname, port)) {
+    throw DL_ABORT_EX2(fmt(MSG_NAME_RESOLUTION_FAILED, getCuid(),
+                           hostname.c_str(), "Host not found (cached)"),
+                       error_code::NAME_RESOLVE_ERROR);
+  }
+
   std::string ipaddr;
+  auto ttl = DNSCache::DEFAULT_TTL;
 #ifdef ENABLE_ASYNC_DNS
   if (getOption()->getAsBool(PREF_ASYNC_DNS)) {
     if (!asyncNameResolverMan_->started()) {
@@ -781,6 +804,9 @@ std::string AbstractCommand::resolveHostname(std::vector<std::string>& addrs,
     }
     switch (asyncNameResolverMan_->getStatus()) {
     case -1:
+      if (asyncNameResolverMan_->isNotFound()) {
+        e_->cacheHostNotFound(hostname, port);
+      }
       if (!isProxyRequest(req_->getProtocol(), getOption())) {
         e_->getRequestGroupMan()
             ->getOrCreateServerStat(req_->getHost(), req_->getProtocol())
@@ -800,6 +826,9 @@ std::string AbstractCommand::resolveHostname(std::vector<std::string>& addrs,
                                hostname.c_str(), "No address returned"),
                            error_code::NAME_RESOLVE_ERROR);
       }
+      if (asyncNameResolverMan_->getTTL() != -1) {
+        ttl = std::chrono::seconds(asyncNameResolverMan_->getTTL());
+      }
       break;
     }
   }
@@ -816,7 +845,7 @@ std::string AbstractCommand::resolveHostname(std::vector<std::string>& addrs,
   A2_LOG_INFO(fmt(MSG_NAME_RESOLUTION_COMPLETE, getCuid(), hostname.c_str(),
                   strjoin(std::begin(addrs), std::end(addrs), ", ").c_str()));
   for (const auto& addr : addrs) {
-    e_->cacheIPAddress(hostname, addr, port);
+    e_->cacheIPAddress(hostname, addr, port, ttl);
   }
   ipaddr = e_->findCachedIPAddress(hostname, port);
   return ipaddr;
@@ -43,6 +43,7 @@
 #include <cerrno>
 #include <cstring>
 #include <cassert>
+#include <vector>
 
 #include "File.h"
 #include "util.h"
@@ -53,6 +54,13 @@
 #include "DownloadFailureException.h"
 #include "error_code.h"
 #include "LogFactory.h"
+#include "a2functional.h"
+
+// O_DIRECT is not supported on Windows.  On Mac OS X, F_NOCACHE is
+// always set instead (see openFileWithFlags()).
+#if !defined(__MINGW32__) && defined(O_DIRECT) && defined(HAVE_POSIX_MEMALIGN)
+#  define A2_DIRECT_IO 1
+#endif
 
 namespace aria2 {
 
@@ -66,8 +74,14 @@ AbstractDiskWriter::AbstractDiskWriter(const std::string& filename)
       readOnly_(false),
       enableMmap_(false),
       mapaddr_(nullptr),
-      maplen_(0)
-
+      maplen_(0),
+      mapReadOnly_(false),
+      mapAdvised_(false),
+      enableDirectIO_(false),
+      directFd_(-1),
+      dataSync_(false),
+      dirty_(false),
+      closeSyncError_(0)
 {
 }
 
@@ -130,6 +144,14 @@ void AbstractDiskWriter::openFile(int64_t totalLength)
 
 void AbstractDiskWriter::closeFile()
 {
+  if (dataSync_) {
+    int errNum = syncFile();
+    if (errNum != 0) {
+      A2_LOG_ERROR(fmt("Syncing file %s failed: %s", filename_.c_str(),
+                       fileStrerror(errNum).c_str()));
+      closeSyncError_ = errNum;
+    }
+  }
 #if defined(HAVE_MMAP) || defined(__MINGW32__)
   if (mapaddr_) {
     int errNum = 0;
@@ -164,6 +186,12 @@ void AbstractDiskWriter::closeFile()
 #endif // !__MINGW32__
     fd_ = A2_BAD_FD;
   }
+#ifdef A2_DIRECT_IO
+  if (directFd_ != -1) {
+    close(directFd_);
+    directFd_ = -1;
+  }
+#endif // A2_DIRECT_IO
 }
 
 namespace {
@@ -243,6 +271,7 @@ void AbstractDiskWriter::openExistingFile(int64_t totalLength)
     flags |= O_RDWR;
   }
   fd_ = openFileWithFlags(filename_, flags, error_code::FILE_OPEN_ERROR);
+  openDirectFile();
 }
 
 void AbstractDiskWriter::createFile(int addFlags)
@@ -252,8 +281,224 @@ void AbstractDiskWriter::createFile(int addFlags)
   fd_ = openFileWithFlags(filename_,
                           O_CREAT | O_RDWR | O_TRUNC | O_BINARY | addFlags,
                           error_code::FILE_CREATE_ERROR);
+  openDirectFile();
+}
+
+void AbstractDiskWriter::openDirectFile()
+{
+#ifdef A2_DIRECT_IO
+  if (!enableDirectIO_) {
+    return;
+  }
+  int flags = O_DIRECT | (readOnly_ ? O_RDONLY : O_RDWR);
+  int fd;
+  while ((fd = a2open(utf8ToWChar(filename_).c_str(), flags, OPEN_MODE)) ==
+             -1 &&
+         errno == EINTR)
+    ;
+  if (fd == -1) {
+    int errNum = errno;
+    A2_LOG_INFO(fmt("Opening file %s for direct I/O failed: %s. Buffered I/O"
+                    " is used instead.",
+                    filename_.c_str(), util::safeStrerror(errNum).c_str()));
+    return;
+  }
+  util::make_fd_cloexec(fd);
+  directFd_ = fd;
+#endif // A2_DIRECT_IO
+}
+
+#ifdef A2_DIRECT_IO
+namespace {
+// The file offset, length and buffer address of direct I/O must be
+// aligned to the logical block size of the device.  4KiB covers both
+// 512 byte and 4KiB sector devices.
+constexpr size_t DIRECT_IO_ALIGNMENT = 4_k;
+constexpr size_t DIRECT_IO_BUFSIZE = 1_m;
+constexpr size_t MAX_POOLED_BUFFERS = 4;
+
+// Keeps the aligned buffers for direct I/O, so that they are not
+// allocated for each read and write.
+class AlignedBufferPool {
+public:
+  ~AlignedBufferPool()
+  {
+    for (auto buf : buffers_) {
+      free(buf);
+    }
+  }
+
+  unsigned char* get()
+  {
+    if (buffers_.empty()) {
+      return reinterpret_cast<unsigned char*>(util::allocateAlignedMemory(
+          DIRECT_IO_ALIGNMENT, DIRECT_IO_BUFSIZE));
+    }
+    auto buf = buffers_.back();
+    buffers_.pop_back();
+    return buf;
+  }
+
+  void put(unsigned char* buf)
+  {
+    if (buffers_.size() < MAX_POOLED_BUFFERS) {
+      buffers_.push_back(buf);
+    }
+    else {
+      free(buf);
+    }
+  }
+
+private:
+  std::vector<unsigned char*> buffers_;
+};
+
+AlignedBufferPool bufferPool;
+
+// Takes a buffer from bufferPool and returns it on destruction.
+class PooledBuffer {
+public:
+  PooledBuffer() : buf_(bufferPool.get()) {}
+  ~PooledBuffer() { bufferPool.put(buf_); }
+  unsigned char* get() const { return buf_; }
+
+private:
+  unsigned char* buf_;
+};
+
+int64_t alignDown(int64_t n)
+{
+  return n & ~static_cast<int64_t>(DIRECT_IO_ALIGNMENT - 1);
+}
+
+int64_t alignUp(int64_t n) { return alignDown(n + DIRECT_IO_ALIGNMENT - 1); }
+
+ssize_t preadDirect(int fd, unsigned char* buf, size_t len, int64_t offset)
+{
+  ssize_t r;
+  while ((r = pread(fd, buf, len, offset)) == -1 && errno == EINTR)
+    ;
+  return r;
 }
 
+ssize_t pwriteDirect(int fd, const unsigned char* buf, size_t len,
+                     int64_t offset)
+{
+  size_t nwrite = 0;
+  while (nwrite < len) {
+    ssize_t r;
+    while ((r = pwrite(fd, buf + nwrite, len - nwrite, offset + nwrite)) ==
+               -1 &&
+           errno == EINTR)
+      ;
+    if (r == -1) {
+      return -1;
+    }
+    nwrite += r;
+  }
+  return nwrite;
+}
+} // namespace
+
+ssize_t AbstractDiskWriter::writeDirect(const unsigned char* data, size_t len,
+                                        int64_t offset)
+{
+  a2_struct_stat st;
+  if (a2fstat(fd_, &st) == -1) {
+    return -1;
+  }
+  int64_t filesize = st.st_size;
+  PooledBuffer buf;
+  const int64_t end = offset + len;
+  int64_t pos = offset;
+  while (pos < end) {
+    int64_t blockStart = alignDown(pos);
+    int64_t chunkEnd =
+        std::min(end, blockStart + static_cast<int64_t>(DIRECT_IO_BUFSIZE));
+    int64_t alignedEnd = alignUp(chunkEnd);
+    int64_t lastStart = alignedEnd - DIRECT_IO_ALIGNMENT;
+    int64_t directBegin = blockStart;
+    int64_t directEnd = alignedEnd;
+    // A partial block is read and written back.  If it lies past the
+    // end of the file, it is written through fd_, so that the file is
+    // not extended beyond the data.
+    if (pos != blockStart) {
+      if (blockStart + static_cast<int64_t>(DIRECT_IO_ALIGNMENT) > filesize) {
+        directBegin += DIRECT_IO_ALIGNMENT;
+      }
+      else if (preadDirect(directFd_, buf.get(), DIRECT_IO_ALIGNMENT,
+                           blockStart) == -1) {
+        return -1;
+      }
+    }
+    if (chunkEnd != alignedEnd && lastStart >= directBegin) {
+      if (alignedEnd > filesize) {
+        directEnd = lastStart;
+      }
+      else if ((lastStart != blockStart || pos == blockStart) &&
+               preadDirect(directFd_, buf.get() + (lastStart - blockStart),
+                           DIRECT_IO_ALIGNMENT, lastStart) == -1) {
+        return -1;
+      }
+    }
+    if (directBegin < directEnd) {
+      memcpy(buf.get() + (pos - blockStart), data + (pos - offset),
+             chunkEnd - pos);
+      if (pwriteDirect(directFd_, buf.get() + (directBegin - blockStart),
+                       directEnd - directBegin, directBegin) == -1) {
+        return -1;
+      }
+      if (pos < directBegin &&
+          writeDataInternal(data + (pos - offset), directBegin - pos, pos) ==
+              -1) {
+        return -1;
+      }
+      if (directEnd < chunkEnd &&
+          writeDataInternal(data + (directEnd - offset), chunkEnd - directEnd,
+                            directEnd) == -1) {
+        return -1;
+      }
+    }
+    else if (writeDataInternal(data + (pos - offset), chunkEnd - pos, pos) ==
+             -1) {
+      return -1;
+    }
+    filesize = std::max(filesize, chunkEnd);
+    pos = chunkEnd;
+  }
+  return len;
+}
+
+ssize_t AbstractDiskWriter::readDirect(unsigned char* data, size_t len,
+                                       int64_t offset)
+{
+  PooledBuffer buf;
+  const int64_t end = offset + len;
+  int64_t pos = offset;
+  while (pos < end) {
+    int64_t blockStart = alignDown(pos);
+    int64_t chunkEnd =
+        std::min(end, blockStart + static_cast<int64_t>(DIRECT_IO_BUFSIZE));
+    auto r = preadDirect(directFd_, buf.get(), alignUp(chunkEnd) - blockStart,
+                         blockStart);
+    if (r == -1) {
+      return -1;
+    }
+    int64_t readEnd = std::min(chunkEnd, blockStart + r);
+    if (readEnd <= pos) {
+      break;
+    }
+    memcpy(data + (pos - offset), buf.get() + (pos - blockStart),
+           readEnd - pos);
+    pos = readEnd;
+    if (readEnd < chunkEnd) {
+      break;
+    }
+  }
+  return pos - offset;
+}
+#endif // A2_DIRECT_IO
+
 ssize_t AbstractDiskWriter::writeDataInternal(const unsigned char* data,
                                               size_t len, int64_t offset)
 {
@@ -338,95 +583,155 @@ void AbstractDiskWriter::seek(int64_t offset)
   }
 }
 
-void AbstractDiskWriter::ensureMmapWrite(size_t len, int64_t offset)
+void AbstractDiskWriter::unmapFile()
 {
 #if defined(HAVE_MMAP) || defined(__MINGW32__)
-  if (enableMmap_) {
-    if (mapaddr_) {
-      if (static_cast<int64_t>(len + offset) > maplen_) {
-        int errNum = 0;
+  int errNum = 0;
 #  ifdef __MINGW32__
-        if (!UnmapViewOfFile(mapaddr_)) {
-          errNum = GetLastError();
-        }
-        CloseHandle(mapView_);
-        mapView_ = INVALID_HANDLE_VALUE;
+  if (!UnmapViewOfFile(mapaddr_)) {
+    errNum = GetLastError();
+  }
+  CloseHandle(mapView_);
+  mapView_ = INVALID_HANDLE_VALUE;
 #  else  // !__MINGW32__
-        if (munmap(mapaddr_, maplen_) == -1) {
-          errNum = errno;
-        }
+  if (munmap(mapaddr_, maplen_) == -1) {
+    errNum = errno;
+  }
 #  endif // !__MINGW32__
-        if (errNum != 0) {
-          A2_LOG_ERROR(fmt("Unmapping file %s failed: %s", filename_.c_str(),
-                           fileStrerror(errNum).c_str()));
-        }
-        mapaddr_ = nullptr;
-        maplen_ = 0;
+  if (errNum != 0) {
+    A2_LOG_ERROR(fmt("Unmapping file %s failed: %s", filename_.c_str(),
+                     fileStrerror(errNum).c_str()));
+  }
+  mapaddr_ = nullptr;
+  maplen_ = 0;
+#endif // HAVE_MMAP || __MINGW32__
+}
+
+void AbstractDiskWriter::mapFile(int64_t filesize)
+{
+#if defined(HAVE_MMAP) || defined(__MINGW32__)
+  int errNum = 0;
+#  ifdef __MINGW32__
+  mapView_ = CreateFileMapping(fd_, 0, readOnly_ ? PAGE_READONLY
+                                                 : PAGE_READWRITE,
+                               filesize >> 32, filesize & 0xffffffffu, 0);
+  if (mapView_) {
+    mapaddr_ = reinterpret_cast<unsigned char*>(MapViewOfFile(
+        mapView_, readOnly_ ? FILE_MAP_READ : FILE_MAP_WRITE, 0, 0, 0));
+    if (!mapaddr_) {
+      errNum = GetLastError();
+      CloseHandle(mapView_);
+      mapView_ = INVALID_HANDLE_VALUE;
+    }
+  }
+  else {
+    errNum = GetLastError();
+  }
+#  else  // !__MINGW32__
+  // A file opened read-only cannot be mapped writable.
+  auto pa = mmap(nullptr, filesize,
+                 readOnly_ ? PROT_READ : PROT_READ | PROT_WRITE, MAP_SHARED,
+                 fd_, 0);
+
+  if (pa == MAP_FAILED) {
+    errNum = errno;
+  }
+  else {
+    mapaddr_ = reinterpret_cast<unsigned char*>(pa);
+  }
+#  endif // !__MINGW32__
+  if (mapaddr_) {
+    A2_LOG_DEBUG(fmt("Mapping file %s succeeded, length=%" PRId64 "",
+                     filename_.c_str(), static_cast<uint64_t>(filesize)));
+    maplen_ = filesize;
+    mapReadOnly_ = readOnly_;
+    mapAdvised_ = false;
+  }
+  else {
+    A2_LOG_WARN(fmt("Mapping file %s failed: %s", filename_.c_str(),
+                    fileStrerror(errNum).c_str()));
+    enableMmap_ = false;
+  }
+#endif // HAVE_MMAP || __MINGW32__
+}
+
+bool AbstractDiskWriter::checkMmapSize(int64_t filesize)
+{
+  if (filesize == 0) {
+    // mapping 0 length file is useless.  Also munmap with size ==
+    // 0 will fail with EINVAL.
+    enableMmap_ = false;
+    return false;
+  }
+
+  if (static_cast<uint64_t>(std::numeric_limits<size_t>::max()) <
+      static_cast<uint64_t>(filesize)) {
+    // filesize could overflow in 32bit OS with 64bit off_t type
+    // the filesize will be truncated if provided as a 32bit size_t
+    enableMmap_ = false;
+    return false;
+  }
+  return true;
+}
+
+void AbstractDiskWriter::ensureMmapWrite(size_t len, int64_t offset)
+{
+#if defined(HAVE_MMAP) || defined(__MINGW32__)
+  if (enableMmap_) {
+    if (mapaddr_) {
+      if (static_cast<int64_t>(len + offset) > maplen_ || mapReadOnly_) {
+        unmapFile();
         enableMmap_ = false;
       }
     }
     else {
       int64_t filesize = size();
-
-      if (filesize == 0) {
-        // mapping 0 length file is useless.  Also munmap with size ==
-        // 0 will fail with EINVAL.
-        enableMmap_ = false;
+      if (!checkMmapSize(filesize)) {
         return;
       }
-
-      if (static_cast<uint64_t>(std::numeric_limits<size_t>::max()) <
-          static_cast<uint64_t>(filesize)) {
-        // filesize could overflow in 32bit OS with 64bit off_t type
-        // the filesize will be truncated if provided as a 32bit size_t
-        enableMmap_ = false;
-        return;
-      }
-
-      int errNum = 0;
       if (static_cast<int64_t>(len + offset) <= filesize) {
-#  ifdef __MINGW32__
-        mapView_ = CreateFileMapping(fd_, 0, PAGE_READWRITE, filesize >> 32,
-                                     filesize & 0xffffffffu, 0);
-        if (mapView_) {
-          mapaddr_ = reinterpret_cast<unsigned char*>(
-              MapViewOfFile(mapView_, FILE_MAP_WRITE, 0, 0, 0));
-          if (!mapaddr_) {
-            errNum = GetLastError();
-            CloseHandle(mapView_);
-            mapView_ = INVALID_HANDLE_VALUE;
-          }
-        }
-        else {
-          errNum = GetLastError();
-        }
-#  else  // !__MINGW32__
-        auto pa =
-            mmap(nullptr, filesize, PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
-
-        if (pa == MAP_FAILED) {
-          errNum = errno;
-        }
-        else {
-          mapaddr_ = reinterpret_cast<unsigned char*>(pa);
-        }
-#  endif // !__MINGW32__
-        if (mapaddr_) {
-          A2_LOG_DEBUG(fmt("Mapping file %s succeeded, length=%" PRId64 "",
-                           filename_.c_str(), static_cast<uint64_t>(filesize)));
-          maplen_ = filesize;
-        }
-        else {
-          A2_LOG_WARN(fmt("Mapping file %s failed: %s", filename_.c_str(),
-                          fileStrerror(errNum).c_str()));
-          enableMmap_ = false;
-        }
+        mapFile(filesize);
       }
     }
   }
 #endif // HAVE_MMAP || __MINGW32__
 }
 
+void AbstractDiskWriter::ensureMmapRead()
+{
+#if defined(HAVE_MMAP) || defined(__MINGW32__)
+  // Only complete files are mapped for reading.  While downloading,
+  // the file is mapped by ensureMmapWrite() instead.
+  if (enableMmap_ && !mapaddr_ && readOnly_ && fd_ != A2_BAD_FD) {
+    int64_t filesize = size();
+    if (checkMmapSize(filesize)) {
+      mapFile(filesize);
+    }
+  }
+#endif // HAVE_MMAP || __MINGW32__
+}
+
+const unsigned char* AbstractDiskWriter::getMappedData(size_t len,
+                                                       int64_t offset)
+{
+  ensureMmapRead();
+  if (!mapaddr_ || offset < 0 ||
+      static_cast<int64_t>(len + offset) > maplen_) {
+    return nullptr;
+  }
+#if defined(HAVE_MMAP) && defined(HAVE_MADVISE)
+  if (!mapAdvised_) {
+    // Callers scan the file from the beginning to the end.
+    madvise(mapaddr_, maplen_, MADV_SEQUENTIAL);
+    mapAdvised_ = true;
+  }
+  static const int64_t pageSize = sysconf(_SC_PAGESIZE);
+  auto first = offset / pageSize * pageSize;
+  madvise(mapaddr_ + first, len + offset - first, MADV_WILLNEED);
+#endif // HAVE_MMAP && HAVE_MADVISE
+  return mapaddr_ + offset;
+}
+
 namespace {
 // Returns true if |errNum| indicates that disk is full.
 bool isDiskFullError(int errNum)
@@ -444,8 +749,18 @@ bool isDiskFullError(int errNum)
 void AbstractDiskWriter::writeData(const unsigned char* data, size_t len,
                                    int64_t offset)
 {
-  ensureMmapWrite(len, offset);
-  if (writeDataInternal(data, len, offset) < 0) {
+  ssize_t r;
+#ifdef A2_DIRECT_IO
+  if (directFd_ != -1) {
+    r = writeDirect(data, len, offset);
+  }
+  else
+#endif // A2_DIRECT_IO
+  {
+    ensureMmapWrite(len, offset);
+    r = writeDataInternal(data, len, offset);
+  }
+  if (r < 0) {
     int errNum = fileError();
     // If the error indicates disk full situation, throw
     // DownloadFailureException and abort download instantly.
@@ -462,13 +777,24 @@ void AbstractDiskWriter::writeData(const unsigned char* data, size_t len,
           error_code::FILE_IO_ERROR);
     }
   }
+  dirty_ = true;
 }
 
 ssize_t AbstractDiskWriter::readData(unsigned char* data, size_t len,
                                      int64_t offset)
 {
   ssize_t ret;
-  if ((ret = readDataInternal(data, len, offset)) < 0) {
+#ifdef A2_DIRECT_IO
+  if (directFd_ != -1) {
+    ret = readDirect(data, len, offset);
+  }
+  else
+#endif // A2_DIRECT_IO
+  {
+    ensureMmapRead();
+    ret = readDataInternal(data, len, offset);
+  }
+  if (ret < 0) {
     int errNum = fileError();
     throw DL_ABORT_EX3(
         errNum,
@@ -497,6 +823,7 @@ void AbstractDiskWriter::truncate(int64_t length)
         fmt("File truncation failed. cause: %s", fileStrerror(errNum).c_str()),
         error_code::FILE_IO_ERROR);
   }
+  dirty_ = true;
 }
 
 void AbstractDiskWriter::allocate(int64_t offset, int64_t length, bool sparse)
@@ -581,7 +908,79 @@ void AbstractDiskWriter::enableReadOnly() { readOnly_ = true; }
 
 void AbstractDiskWriter::disableReadOnly() { readOnly_ = false; }
 
-void AbstractDiskWriter::enableMmap() { enableMmap_ = true; }
+void AbstractDiskWriter::enableMmap()
+{
+  // mmap goes through the page cache, which direct I/O avoids.
+  enableMmap_ = !enableDirectIO_;
+}
+
+void AbstractDiskWriter::enableDirectIO()
+{
+  enableDirectIO_ = true;
+  enableMmap_ = false;
+}
+
+int AbstractDiskWriter::syncFile()
+{
+  if (fd_ == A2_BAD_FD || !dirty_) {
+    return 0;
+  }
+#ifdef __MINGW32__
+  if (mapaddr_ && !FlushViewOfFile(mapaddr_, 0)) {
+    return GetLastError();
+  }
+  if (!FlushFileBuffers(fd_)) {
+    return GetLastError();
+  }
+#else // !__MINGW32__
+#  ifdef HAVE_MMAP
+  if (mapaddr_ && msync(mapaddr_, maplen_, MS_SYNC) == -1) {
+    return errno;
+  }
+#  endif // HAVE_MMAP
+#  ifdef HAVE_FDATASYNC
+  if (fdatasync(fd_) == -1) {
+#  else  // !HAVE_FDATASYNC
+  if (fsync(fd_) == -1) {
+#  endif // !HAVE_FDATASYNC
+    return errno;
+  }
+#endif // !__MINGW32__
+  dirty_ = false;
+  return 0;
+}
+
+void AbstractDiskWriter::sync()
+{
+  int errNum = syncFile();
+  if (errNum == 0) {
+    errNum = closeSyncError_;
+  }
+  closeSyncError_ = 0;
+  if (errNum != 0) {
+    throw DL_ABORT_EX3(
+        errNum,
+        fmt(EX_FILE_WRITE, filename_.c_str(), fileStrerror(errNum).c_str()),
+        error_code::FILE_IO_ERROR);
+  }
+}
+
+void AbstractDiskWriter::enableDataSync() { dataSync_ = true; }
+
+size_t AbstractDiskWriter::getNumOpenFds() const
+{
+  return (fd_ != A2_BAD_FD) + (directFd_ != -1);
+}
+
+void AbstractDiskWriter::writeback(int64_t len, int64_t offset)
+{
+#ifdef HAVE_SYNC_FILE_RANGE
+  if (fd_ != A2_BAD_FD) {
+    // Errors are reported by the following sync().
+    sync_file_range(fd_, offset, len, SYNC_FILE_RANGE_WRITE);
+  }
+#endif // HAVE_SYNC_FILE_RANGE
+}
 
 void AbstractDiskWriter::dropCache(int64_t len, int64_t offset)
 {
@@ -57,14 +57,53 @@ private:
   bool enableMmap_;
   unsigned char* mapaddr_;
   int64_t maplen_;
+  // true if the file is mapped without write access.
+  bool mapReadOnly_;
+  // true if the access pattern was already told to the kernel.
+  bool mapAdvised_;
+
+  bool enableDirectIO_;
+  // The same file opened with O_DIRECT, or -1 if direct I/O is not
+  // used.
+  int directFd_;
+
+  // true if the file is synced when it is closed.
+  bool dataSync_;
+  // true if data was written since the last sync.
+  bool dirty_;
+  // The error of the sync done when the file was closed, or 0.  It
+  // is reported by the next sync().
+  int closeSyncError_;
 
   ssize_t writeDataInternal(const unsigned char* data, size_t len,
                             int64_t offset);
   ssize_t readDataInternal(unsigned char* data, size_t len, int64_t offset);
 
+  // Opens directFd_ if direct I/O is enabled.  If the file system
+  // does not support it, buffered I/O is used.
+  void openDirectFile();
+  // Writes and reads through directFd_.  Unaligned blocks at the both
+  // ends are read, modified and written back.  A partial block which
+  // would extend the file is written through fd_ instead.
+  ssize_t writeDirect(const unsigned char* data, size_t len, int64_t offset);
+  ssize_t readDirect(unsigned char* data, size_t len, int64_t offset);
+
   void seek(int64_t offset);
 
+  // Returns false and disables mmap if the file of length filesize
+  // cannot be mapped.
+  bool checkMmapSize(int64_t filesize);
+  // Maps the whole file.  The mapping is read-only if the file is
+  // opened in read-only mode.
+  void mapFile(int64_t filesize);
+  void unmapFile();
+
   void ensureMmapWrite(size_t len, int64_t offset);
+  void ensureMmapRead();
+
+  // Syncs the file if it is dirty.  Returns 0 on success, or the
+  // error code.
+  int syncFile();
 
 protected:
   void createFile(int addFlags = 0);
@@ -85,6 +124,9 @@ public:
   virtual ssize_t readData(unsigned char* data, size_t len,
                            int64_t offset) CXX11_OVERRIDE;
 
+  virtual const unsigned char* getMappedData(size_t len,
+                                             int64_t offset) CXX11_OVERRIDE;
+
   virtual void truncate(int64_t length) CXX11_OVERRIDE;
 
   // File must be opened before calling this function.
@@ -99,6 +141,19 @@ public:
 
   virtual void enableMmap() CXX11_OVERRIDE;
 
+  virtual void enableDirectIO() CXX11_OVERRIDE;
+
+  // Returns true if the file is opened for direct I/O.
+  bool isDirectIOActive() const { return directFd_ != -1; }
+
+  virtual size_t getNumOpenFds() const CXX11_OVERRIDE;
+
+  virtual void sync() CXX11_OVERRIDE;
+
+  virtual void enableDataSync() CXX11_OVERRIDE;
+
+  virtual void writeback(int64_t len, int64_t offset) CXX11_OVERRIDE;
+
   virtual void dropCache(int64_t len, int64_t offset) CXX11_OVERRIDE;
 };
 
@@ -38,8 +38,6 @@
 #include "DiskWriter.h"
 #include "FileEntry.h"
 #include "TruncFileAllocationIterator.h"
-#include "WrDiskCacheEntry.h"
-#include "LogFactory.h"
 #ifdef HAVE_SOME_FALLOCATE
 #  include "FallocFileAllocationIterator.h"
 #endif // HAVE_SOME_FALLOCATE
@@ -94,15 +92,6 @@ ssize_t AbstractSingleDiskAdaptor::readDataDropCache(unsigned char* data,
   return rv;
 }
 
-void AbstractSingleDiskAdaptor::writeCache(const WrDiskCacheEntry* entry)
-{
-  for (auto& d : entry->getDataSet()) {
-    A2_LOG_DEBUG(fmt("Cache flush goff=%" PRId64 ", len=%lu", d->goff,
-                     static_cast<unsigned long>(d->len)));
-    writeData(d->data + d->offset, d->len, d->goff);
-  }
-}
-
 bool AbstractSingleDiskAdaptor::fileExists()
 {
   return File(getFilePath()).exists();
@@ -147,6 +136,29 @@ void AbstractSingleDiskAdaptor::disableReadOnly()
 
 void AbstractSingleDiskAdaptor::enableMmap() { diskWriter_->enableMmap(); }
 
+const unsigned char* AbstractSingleDiskAdaptor::getMappedData(size_t len,
+                                                              int64_t offset)
+{
+  return diskWriter_->getMappedData(len, offset);
+}
+
+void AbstractSingleDiskAdaptor::enableDirectIO()
+{
+  diskWriter_->enableDirectIO();
+}
+
+void AbstractSingleDiskAdaptor::enableDataSync()
+{
+  diskWriter_->enableDataSync();
+}
+
+void AbstractSingleDiskAdaptor::sync() { diskWriter_->sync(); }
+
+void AbstractSingleDiskAdaptor::writeback(int64_t len, int64_t offset)
+{
+  diskWriter_->writeback(len, offset);
+}
+
 void AbstractSingleDiskAdaptor::cutTrailingGarbage()
 {
   if (File(getFilePath()).size() > totalLength_) {
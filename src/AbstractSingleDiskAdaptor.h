@@ -70,7 +70,8 @@ public:
   virtual ssize_t readDataDropCache(unsigned char* data, size_t len,
                                     int64_t offset) CXX11_OVERRIDE;
 
-  virtual void writeCache(const WrDiskCacheEntry* entry) CXX11_OVERRIDE;
+  virtual const unsigned char* getMappedData(size_t len,
+                                             int64_t offset) CXX11_OVERRIDE;
 
   virtual bool fileExists() CXX11_OVERRIDE;
 
@@ -91,6 +92,16 @@ public:
 
   virtual void enableMmap() CXX11_OVERRIDE;
 
+  // Make sure that DiskWriter is set before calling this function.
+  virtual void enableDirectIO() CXX11_OVERRIDE;
+
+  // Make sure that DiskWriter is set before calling this function.
+  virtual void enableDataSync() CXX11_OVERRIDE;
+
+  virtual void sync() CXX11_OVERRIDE;
+
+  virtual void writeback(int64_t len, int64_t offset) CXX11_OVERRIDE;
+
   virtual void cutTrailingGarbage() CXX11_OVERRIDE;
 
   virtual const std::string& getFilePath() = 0;
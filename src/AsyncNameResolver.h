@@ -46,9 +46,20 @@
 
 namespace aria2 {
 
+// ares_getaddrinfo() has been added since c-ares 1.16.0.  Unlike
+// ares_gethostbyname(), it tells the TTL of the records.
+#if ARES_VERSION >= 0x011000
+#  define A2_ARES_GETADDRINFO 1
+#endif // ARES_VERSION >= 0x011000
+
 class AsyncNameResolver {
+#ifdef A2_ARES_GETADDRINFO
+  friend void callback(void* arg, int status, int timeouts,
+                       struct ares_addrinfo* res);
+#else  // !A2_ARES_GETADDRINFO
   friend void callback(void* arg, int status, int timeouts,
                        struct hostent* host);
+#endif // !A2_ARES_GETADDRINFO
 
 public:
   enum STATUS {
@@ -66,6 +77,10 @@ private:
   std::vector<std::string> resolvedAddresses_;
   std::string error_;
   std::string hostname_;
+  // The smallest TTL of resolved addresses in seconds, or -1 if unknown.
+  int ttl_;
+  // true if the name does not exist (NXDOMAIN).
+  bool notFound_;
 
 public:
   AsyncNameResolver(int family
@@ -86,6 +101,10 @@ public:
 
   const std::string& getError() const { return error_; }
 
+  int getTTL() const { return ttl_; }
+
+  bool isNotFound() const { return notFound_; }
+
   STATUS getStatus() const { return status_; }
 
   int getFds(fd_set* rfdsPtr, fd_set* wfdsPtr) const;
@@ -194,6 +194,34 @@ const std::string& AsyncNameResolverMan::getLastError() const
   return A2STR::NIL;
 }
 
+int AsyncNameResolverMan::getTTL() const
+{
+  int ttl = -1;
+  for (size_t i = 0; i < numResolver_; ++i) {
+    if (asyncNameResolver_[i]->getStatus() ==
+        AsyncNameResolver::STATUS_SUCCESS) {
+      auto t = asyncNameResolver_[i]->getTTL();
+      if (t != -1 && (ttl == -1 || t < ttl)) {
+        ttl = t;
+      }
+    }
+  }
+  return ttl;
+}
+
+bool AsyncNameResolverMan::isNotFound() const
+{
+  if (numResolver_ == 0) {
+    return false;
+  }
+  for (size_t i = 0; i < numResolver_; ++i) {
+    if (!asyncNameResolver_[i]->isNotFound()) {
+      return false;
+    }
+  }
+  return true;
+}
+
 void AsyncNameResolverMan::reset(DownloadEngine* e, Command* command)
 {
   disableNameResolverCheck(e, command);
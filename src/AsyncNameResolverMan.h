@@ -76,6 +76,12 @@ public:
   int getStatus() const;
   // Returns last error string
   const std::string& getLastError() const;
+  // Returns the smallest TTL in seconds of the resolved addresses, or
+  // -1 if it is unknown.
+  int getTTL() const;
+  // Returns true if all resolvers reported that the name does not
+  // exist.
+  bool isNotFound() const;
   // Resets state. Also removes resolvers from DownloadEngine.
   void reset(DownloadEngine* e, Command* command);
 
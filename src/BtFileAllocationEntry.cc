@@ -67,8 +67,11 @@ void BtFileAllocationEntry::prepareForNextAction(
   auto& option = rg->getOption();
 
   BtSetup().setup(commands, rg, e, option.get());
+  // Completed files do not grow, so that they can be mapped without
+  // file allocation.
   if (option->getAsBool(PREF_ENABLE_MMAP) &&
-      option->get(PREF_FILE_ALLOCATION) != V_NONE &&
+      (option->get(PREF_FILE_ALLOCATION) != V_NONE ||
+       rg->downloadFinished()) &&
       diskAdaptor->size() <= option->getAsLLInt(PREF_MAX_MMAP_LIMIT)) {
     diskAdaptor->enableMmap();
   }
@@ -59,6 +59,8 @@
 #include "array_fun.h"
 #include "WrDiskCache.h"
 #include "WrDiskCacheEntry.h"
+#include "RdDiskCache.h"
+#include "RequestGroup.h"
 #include "DownloadFailureException.h"
 #include "BtRejectMessage.h"
 
@@ -113,6 +115,9 @@ void BtPieceMessage::doReceivedAction()
                      static_cast<unsigned long>(slot->getBlockIndex())));
     if (piece->hasBlock(slot->getBlockIndex())) {
       A2_LOG_DEBUG("Already have this block.");
+      if (getPieceStorage()->isEndGame()) {
+        getPieceStorage()->addEndGameDuplicateLength(blockLength_);
+      }
       return;
     }
     if (piece->getWrDiskCacheEntry()) {
@@ -148,6 +153,11 @@ void BtPieceMessage::doReceivedAction()
     A2_LOG_DEBUG(fmt("CUID#%" PRId64
                      " - RequestSlot not found, index=%lu, begin=%d",
                      getCuid(), static_cast<unsigned long>(index_), begin_));
+    if (getPieceStorage()->isEndGame()) {
+      // Most likely we have sent cancel for this block, because it
+      // was downloaded from another peer.
+      getPieceStorage()->addEndGameDuplicateLength(blockLength_);
+    }
   }
 }
 
@@ -218,8 +228,21 @@ void BtPieceMessage::pushPieceData(int64_t offset, int32_t length) const
   auto buf = std::vector<unsigned char>(length + MESSAGE_HEADER_LENGTH);
   createMessageHeader(buf.data());
   ssize_t r;
-  r = getPieceStorage()->getDiskAdaptor()->readData(
-      buf.data() + MESSAGE_HEADER_LENGTH, length, offset);
+  auto rdDiskCache = getPieceStorage()->getRdDiskCache();
+  auto group = downloadContext_->getOwnerRequestGroup();
+  if (rdDiskCache && group) {
+    int64_t pieceOffset =
+        static_cast<int64_t>(index_) * downloadContext_->getPieceLength();
+    r = rdDiskCache->readData(
+        buf.data() + MESSAGE_HEADER_LENGTH, length, group->getGID(), index_,
+        offset - pieceOffset, pieceOffset,
+        getPieceStorage()->getPieceLength(index_),
+        getPieceStorage()->getDiskAdaptor().get());
+  }
+  else {
+    r = getPieceStorage()->getDiskAdaptor()->readData(
+        buf.data() + MESSAGE_HEADER_LENGTH, length, offset);
+  }
   if (r == length) {
     const auto& peer = getPeer();
     getPeerConnection()->pushBytes(
@@ -36,6 +36,7 @@
 
 #include <cstring>
 #include <cstdarg>
+#include <cerrno>
 #include <ostream>
 
 #include "a2io.h"
@@ -80,13 +81,21 @@ int BufferedFile::onClose()
 {
   int rv = 0;
   if (fp_) {
-    fflush(fp_);
+    if (fflush(fp_) == EOF) {
+      rv = EOF;
+    }
 #ifndef __MINGW32__
-    fsync(fileno(fp_));
+    // fsync fails with EINVAL on pipes and terminals, which is not an
+    // error here.
+    if (fsync(fileno(fp_)) == -1 && errno != EINVAL) {
+      rv = EOF;
+    }
 #else  // __MINGW32__
     _commit(fileno(fp_));
 #endif // __MINGW32__
-    rv = fclose(fp_);
+    if (fclose(fp_) == EOF) {
+      rv = EOF;
+    }
     fp_ = nullptr;
   }
   return rv;
@@ -0,0 +1,86 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "ConnectionTuner.h"
+
+#include <algorithm>
+
+namespace aria2 {
+
+namespace {
+// An added connection must increase the download speed by this ratio
+// to be worth keeping.
+constexpr double MIN_GAIN = 0.1;
+} // namespace
+
+ConnectionTuner::ConnectionTuner()
+    : prevConnections_(0), prevSpeed_(0), holdRounds_(0)
+{
+}
+
+int ConnectionTuner::update(int numConnections, int downloadSpeed,
+                            int maxConnections)
+{
+  int next = numConnections;
+  if (holdRounds_ > 0) {
+    --holdRounds_;
+  }
+  else if (prevConnections_ > 0 && numConnections > prevConnections_) {
+    // A connection was added in the last round.
+    if (downloadSpeed > prevSpeed_ * (1 + MIN_GAIN)) {
+      next = numConnections + 1;
+    }
+    else {
+      if (downloadSpeed < prevSpeed_) {
+        next = prevConnections_;
+      }
+      holdRounds_ = HOLD_ROUNDS;
+    }
+  }
+  else {
+    // Probe whether one more connection helps.
+    next = numConnections + 1;
+  }
+  prevConnections_ = numConnections;
+  prevSpeed_ = downloadSpeed;
+  return std::max(1, std::min(next, maxConnections));
+}
+
+int ConnectionTuner::notifyServerBusy(int numConnections)
+{
+  holdRounds_ = HOLD_ROUNDS;
+  return std::max(1, numConnections / 2);
+}
+
+} // namespace aria2
@@ -0,0 +1,75 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_CONNECTION_TUNER_H
+#define D_CONNECTION_TUNER_H
+
+#include "common.h"
+
+namespace aria2 {
+
+// Chooses the number of connections of a download by hill climbing:
+// a connection is added while it increases the download speed, and
+// removed again when it decreases it.  The number of connections is
+// halved when the server tells that it is busy.
+class ConnectionTuner {
+public:
+  ConnectionTuner();
+
+  // Returns the number of connections to use for the next round,
+  // given that numConnections connections achieved downloadSpeed
+  // during the last round.  The returned value is in [1,
+  // maxConnections].
+  int update(int numConnections, int downloadSpeed, int maxConnections);
+
+  // Tells that the server responded with 503 or 429 while
+  // numConnections connections were open.  Returns the number of
+  // connections to use from now on, which is the half of
+  // numConnections, at least 1.  update() keeps the number for
+  // HOLD_ROUNDS rounds afterwards.
+  int notifyServerBusy(int numConnections);
+
+  // The number of rounds the number of connections is kept after it
+  // stopped paying off or the server was busy.
+  static const int HOLD_ROUNDS = 6;
+
+private:
+  int prevConnections_;
+  int prevSpeed_;
+  int holdRounds_;
+};
+
+} // namespace aria2
+
+#endif // D_CONNECTION_TUNER_H
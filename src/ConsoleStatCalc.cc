@@ -347,8 +347,9 @@ void ConsoleStatCalc::calculateStat(const DownloadEngine* e)
   }
 
   {
-    auto& entry = e->getFileAllocationMan()->getPickedEntry();
-    if (entry) {
+    auto& entries = e->getFileAllocationMan()->getPickedEntries();
+    if (!entries.empty()) {
+      auto& entry = entries.front();
       o << " [FileAlloc:#"
         << GroupId::toAbbrevHex(entry->getRequestGroup()->getGID()) << " "
         << sizeFormatter(entry->getCurrentLength()) << "B/"
@@ -360,8 +361,11 @@ void ConsoleStatCalc::calculateStat(const DownloadEngine* e)
         o << "--";
       }
       o << "%)]";
-      if (e->getFileAllocationMan()->hasNext()) {
-        o << "(+" << e->getFileAllocationMan()->countEntryInQueue() << ")";
+      // The other entries being allocated and the queued ones
+      size_t rest = entries.size() - 1 +
+                    e->getFileAllocationMan()->countEntryInQueue();
+      if (rest > 0) {
+        o << "(+" << rest << ")";
       }
     }
   }
@@ -52,6 +52,10 @@
 #include "a2functional.h"
 #include "FileEntry.h"
 #include "DlAbortEx.h"
+#include "BtRegistry.h"
+#include "UDPTrackerClient.h"
+#include "DHTConstants.h"
+#include "wallclock.h"
 #include "fmt.h"
 
 namespace aria2 {
@@ -113,6 +117,14 @@ void DHTAutoSaveCommand::save()
                         dhtFile.c_str()),
                     e);
   }
+  if (family_ == AF_INET) {
+    const auto& udpTrackerClient =
+        getDownloadEngine()->getBtRegistry()->getUDPTrackerClient();
+    if (udpTrackerClient) {
+      udpTrackerClient->saveConnectionIds(
+          dhtFile + UDPT_CONNECTION_ID_FILE_SUFFIX, global::wallclock());
+    }
+  }
 }
 
 void DHTAutoSaveCommand::setLocalNode(const std::shared_ptr<DHTNode>& localNode)
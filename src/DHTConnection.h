@@ -48,8 +48,15 @@ public:
   virtual ssize_t receiveMessage(unsigned char* data, size_t len,
                                  std::string& host, uint16_t& port) = 0;
 
+  // Queues the message to be sent to host:port.  Returns len if the
+  // message is queued, or 0 if the queue is full.  The queued
+  // messages are sent by flushMessages().
   virtual ssize_t sendMessage(const unsigned char* data, size_t len,
                               const std::string& host, uint16_t port) = 0;
+
+  // Sends messages queued by sendMessage() as many as possible.
+  // Returns the number of messages still left in the queue.
+  virtual size_t flushMessages() = 0;
 };
 
 } // namespace aria2
@@ -36,6 +36,8 @@
 
 #include <utility>
 #include <algorithm>
+#include <cstring>
+#include <array>
 
 #include "LogFactory.h"
 #include "Logger.h"
@@ -44,12 +46,32 @@
 #include "SocketCore.h"
 #include "SimpleRandomizer.h"
 #include "fmt.h"
+#include "a2functional.h"
 
 namespace aria2 {
 
+namespace {
+// The number of datagrams read by one system call.
+constexpr size_t RECV_BATCH = 16;
+// The maximum size of datagram we can receive.  DHT messages and UDP
+// tracker responses are far smaller than this.
+constexpr size_t MAX_DATAGRAM_LENGTH = 4_k;
+// The maximum number of messages queued by sendMessage().
+constexpr size_t MAX_SEND_QUEUE = 1024;
+} // namespace
+
 DHTConnectionImpl::DHTConnectionImpl(int family)
-    : socket_(std::make_shared<SocketCore>(SOCK_DGRAM)), family_(family)
+    : socket_(std::make_shared<SocketCore>(SOCK_DGRAM)),
+      family_(family),
+      recvBuffer_(RECV_BATCH * MAX_DATAGRAM_LENGTH),
+      recvDatagrams_(RECV_BATCH),
+      recvCount_(0),
+      recvIndex_(0)
 {
+  for (size_t i = 0; i < RECV_BATCH; ++i) {
+    recvDatagrams_[i].data = recvBuffer_.data() + i * MAX_DATAGRAM_LENGTH;
+    recvDatagrams_[i].capacity = MAX_DATAGRAM_LENGTH;
+  }
 }
 
 DHTConnectionImpl::~DHTConnectionImpl() = default;
@@ -91,21 +113,62 @@ bool DHTConnectionImpl::bind(uint16_t& port, const std::string& addr)
 ssize_t DHTConnectionImpl::receiveMessage(unsigned char* data, size_t len,
                                           std::string& host, uint16_t& port)
 {
-  Endpoint remoteEndpoint;
-  ssize_t length = socket_->readDataFrom(data, len, remoteEndpoint);
-  if (length == 0) {
-    return length;
+  if (recvIndex_ == recvCount_) {
+    recvIndex_ = 0;
+    recvCount_ = socket_->readDataFromBatch(recvDatagrams_.data(),
+                                            recvDatagrams_.size());
+    if (recvCount_ == 0) {
+      return 0;
+    }
   }
-
+  const auto& dg = recvDatagrams_[recvIndex_++];
+  auto remoteEndpoint =
+      util::getNumericNameInfo(&dg.addr.su.sa, dg.addr.suLength);
   host = remoteEndpoint.addr;
   port = remoteEndpoint.port;
-  return length;
+  len = std::min(len, dg.length);
+  memcpy(data, dg.data, len);
+  return len;
 }
 
 ssize_t DHTConnectionImpl::sendMessage(const unsigned char* data, size_t len,
                                        const std::string& host, uint16_t port)
 {
-  return socket_->writeData(data, len, host, port);
+  if (sendQueue_.size() >= MAX_SEND_QUEUE) {
+    return 0;
+  }
+  sendQueue_.emplace_back(std::vector<unsigned char>(data, data + len),
+                          socket_->resolveDatagramAddr(host, port));
+  return len;
+}
+
+size_t DHTConnectionImpl::flushMessages()
+{
+  std::array<Datagram, A2_DATAGRAM_BATCH_MAX> dgrams;
+  while (!sendQueue_.empty()) {
+    size_t num = std::min(sendQueue_.size(), dgrams.size());
+    for (size_t i = 0; i < num; ++i) {
+      auto& ent = sendQueue_[i];
+      dgrams[i].data = ent.first.data();
+      dgrams[i].length = ent.first.size();
+      dgrams[i].addr = ent.second;
+    }
+    size_t nsent;
+    try {
+      nsent = socket_->writeDataToBatch(dgrams.data(), num);
+    }
+    catch (RecoverableException& e) {
+      A2_LOG_INFO_EX("Failed to send UDP message.", e);
+      // Drop the message which caused the error.  For DHT messages,
+      // DHTMessageTracker eventually treats it as timeout.
+      nsent = 1;
+    }
+    sendQueue_.erase(std::begin(sendQueue_), std::begin(sendQueue_) + nsent);
+    if (socket_->wantWrite()) {
+      break;
+    }
+  }
+  return sendQueue_.size();
 }
 
 } // namespace aria2
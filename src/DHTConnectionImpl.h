@@ -38,8 +38,11 @@
 #include "DHTConnection.h"
 
 #include <memory>
+#include <vector>
+#include <deque>
 
 #include "SegList.h"
+#include "a2netcompat.h"
 
 namespace aria2 {
 
@@ -51,6 +54,17 @@ private:
 
   int family_;
 
+  // Buffer for the datagrams read at once by receiveMessage().
+  std::vector<unsigned char> recvBuffer_;
+  std::vector<Datagram> recvDatagrams_;
+  // The number of datagrams in recvDatagrams_ and the index of the
+  // next one to be returned by receiveMessage().
+  size_t recvCount_;
+  size_t recvIndex_;
+
+  // Messages queued by sendMessage() and their destination.
+  std::deque<std::pair<std::vector<unsigned char>, SockAddr>> sendQueue_;
+
 public:
   DHTConnectionImpl(int family);
 
@@ -85,6 +99,8 @@ public:
                               const std::string& host,
                               uint16_t port) CXX11_OVERRIDE;
 
+  virtual size_t flushMessages() CXX11_OVERRIDE;
+
   const std::shared_ptr<SocketCore>& getSocket() const { return socket_; }
 };
 
@@ -64,8 +64,17 @@ constexpr auto DHT_PEER_ANNOUNCE_INTERVAL = 15_min;
 
 constexpr auto DHT_PEER_ANNOUNCE_CHECK_INTERVAL = 5_min;
 
+// The maximum number of peers stored per infohash.  If a new peer is
+// announced when the limit is reached, the least recently updated
+// peer is replaced.
+constexpr size_t DHT_PEER_ANNOUNCE_MAX_PEERS = 500;
+
 constexpr auto DHT_TOKEN_UPDATE_INTERVAL = 10_min;
 
+// UDP tracker connection IDs are saved in the file whose name is the
+// DHT routing table file name (IPv4) followed by this suffix.
+constexpr char UDPT_CONNECTION_ID_FILE_SUFFIX[] = ".udpt";
+
 } // namespace aria2
 
 #endif // D_DHT_CONSTANTS_H
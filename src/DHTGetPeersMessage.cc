@@ -36,6 +36,7 @@
 
 #include <cstring>
 #include <array>
+#include <algorithm>
 
 #include "DHTNode.h"
 #include "DHTRoutingTable.h"
@@ -43,7 +44,6 @@
 #include "DHTMessageDispatcher.h"
 #include "DHTMessageCallback.h"
 #include "DHTPeerAnnounceStorage.h"
-#include "Peer.h"
 #include "DHTTokenTracker.h"
 #include "DHTGetPeersReplyMessage.h"
 #include "util.h"
@@ -51,6 +51,7 @@
 #include "DownloadContext.h"
 #include "Option.h"
 #include "SocketCore.h"
+#include "bittorrent_helper.h"
 
 namespace aria2 {
 
@@ -71,7 +72,7 @@ DHTGetPeersMessage::DHTGetPeersMessage(
   memcpy(infoHash_, infoHash, DHT_ID_LENGTH);
 }
 
-void DHTGetPeersMessage::addLocalPeer(std::vector<std::shared_ptr<Peer>>& peers)
+void DHTGetPeersMessage::addLocalPeer(std::vector<std::string>& compactPeers)
 {
   if (!btRegistry_) {
     return;
@@ -97,33 +98,37 @@ void DHTGetPeersMessage::addLocalPeer(std::vector<std::shared_ptr<Peer>>& peers)
     return;
   }
 
-  auto tcpPort = btRegistry_->getTcpPort();
-  if (std::find_if(std::begin(peers), std::end(peers),
-                   [&externalIP, tcpPort](const std::shared_ptr<Peer>& peer) {
-                     return peer->getIPAddress() == externalIP &&
-                            peer->getPort() == tcpPort;
-                   }) != std::end(peers)) {
+  std::array<unsigned char, COMPACT_LEN_IPV6> compact;
+  auto compactlen = bittorrent::packcompact(compact.data(), externalIP,
+                                            btRegistry_->getTcpPort());
+  if (compactlen == 0) {
+    return;
+  }
+  std::string localPeer(compact.data(), compact.data() + compactlen);
+  if (std::find(std::begin(compactPeers), std::end(compactPeers),
+                localPeer) != std::end(compactPeers)) {
     return;
   }
 
-  peers.push_back(std::make_shared<Peer>(externalIP, tcpPort));
+  compactPeers.push_back(std::move(localPeer));
 }
 
 void DHTGetPeersMessage::doReceivedAction()
 {
   std::string token = tokenTracker_->generateToken(
       infoHash_, getRemoteNode()->getIPAddress(), getRemoteNode()->getPort());
-  std::vector<std::shared_ptr<Peer>> peers;
-  peerAnnounceStorage_->getPeers(peers, infoHash_);
+  // Peers are stored in compact form, and sent as they are.
+  std::vector<std::string> compactPeers;
+  peerAnnounceStorage_->getCompactPeers(compactPeers, infoHash_);
 
   // Check to see localhost has the contents which has same infohash
-  addLocalPeer(peers);
+  addLocalPeer(compactPeers);
 
   std::vector<std::shared_ptr<DHTNode>> nodes;
   getRoutingTable()->getClosestKNodes(nodes, infoHash_);
   getMessageDispatcher()->addMessageToQueue(
       getMessageFactory()->createGetPeersReplyMessage(
-          getRemoteNode(), std::move(nodes), std::move(peers), token,
+          getRemoteNode(), std::move(nodes), std::move(compactPeers), token,
           getTransactionID()));
 }
 
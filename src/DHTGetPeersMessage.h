@@ -47,7 +47,6 @@ namespace aria2 {
 class DHTPeerAnnounceStorage;
 class DHTTokenTracker;
 class BtRegistry;
-class Peer;
 
 class DHTGetPeersMessage : public DHTQueryMessage {
 private:
@@ -61,7 +60,7 @@ private:
 
   int family_;
 
-  void addLocalPeer(std::vector<std::shared_ptr<Peer>>& peers);
+  void addLocalPeer(std::vector<std::string>& compactPeers);
 
 protected:
   virtual std::string toStringOptional() const CXX11_OVERRIDE;
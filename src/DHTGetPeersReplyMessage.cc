@@ -102,7 +102,7 @@ std::unique_ptr<Dict> DHTGetPeersReplyMessage::getResponse()
     rDict->put(family_ == AF_INET ? NODES : NODES6,
                String::g(std::begin(buffer), last));
   }
-  if (!values_.empty()) {
+  if (!values_.empty() || !compactValues_.empty()) {
     // Limit the size of values list.  The maximum size of UDP datagram
     // is limited to 65535 bytes. aria2 uses 20bytes token and 2byte
     // transaction ID. The size of get_peers reply message without
@@ -139,6 +139,14 @@ std::unique_ptr<Dict> DHTGetPeersReplyMessage::getResponse()
         valuesList->append(String::g(compact.data(), compactlen));
       }
     }
+    const size_t compactLen = bittorrent::getCompactLength(family_);
+    for (auto i = std::begin(compactValues_);
+         i != std::end(compactValues_) && valuesList->size() < MAX_VALUES_SIZE;
+         ++i) {
+      if ((*i).size() == compactLen) {
+        valuesList->append(*i);
+      }
+    }
     rDict->put(VALUES, std::move(valuesList));
   }
   return rDict;
@@ -157,7 +165,8 @@ void DHTGetPeersReplyMessage::accept(DHTMessageCallback* callback)
 std::string DHTGetPeersReplyMessage::toStringOptional() const
 {
   return fmt("token=%s, values=%lu, nodes=%lu", util::toHex(token_).c_str(),
-             static_cast<unsigned long>(values_.size()),
+             static_cast<unsigned long>(values_.size() +
+                                        compactValues_.size()),
              static_cast<unsigned long>(closestKNodes_.size()));
 }
 
@@ -173,4 +182,10 @@ void DHTGetPeersReplyMessage::setValues(
   values_ = std::move(peers);
 }
 
+void DHTGetPeersReplyMessage::setCompactValues(
+    std::vector<std::string> compactPeers)
+{
+  compactValues_ = std::move(compactPeers);
+}
+
 } // namespace aria2
@@ -55,6 +55,9 @@ private:
 
   std::vector<std::shared_ptr<Peer>> values_;
 
+  // Peers in compact form, sent after values_.
+  std::vector<std::string> compactValues_;
+
 protected:
   virtual std::string toStringOptional() const CXX11_OVERRIDE;
 
@@ -86,6 +89,13 @@ public:
 
   void setValues(std::vector<std::shared_ptr<Peer>> peers);
 
+  const std::vector<std::string>& getCompactValues() const
+  {
+    return compactValues_;
+  }
+
+  void setCompactValues(std::vector<std::string> compactPeers);
+
   const std::string& getToken() const { return token_; }
 
   static const std::string GET_PEERS;
@@ -164,6 +164,9 @@ bool DHTInteractionCommand::execute()
       udpTrackerClient_->requestFail(UDPT_ERR_NETWORK);
     }
   }
+  // DHT messages and UDP tracker requests queued above are sent in
+  // batch here.
+  connection_->flushMessages();
   e_->addRoutineCommand(std::unique_ptr<Command>(this));
   return false;
 }
@@ -100,7 +100,7 @@ public:
   virtual std::unique_ptr<DHTGetPeersReplyMessage> createGetPeersReplyMessage(
       const std::shared_ptr<DHTNode>& remoteNode,
       std::vector<std::shared_ptr<DHTNode>> closestKNodes,
-      std::vector<std::shared_ptr<Peer>> peers, const std::string& token,
+      std::vector<std::string> compactPeers, const std::string& token,
       const std::string& transactionID) = 0;
 
   virtual std::unique_ptr<DHTAnnouncePeerMessage>
@@ -446,22 +446,25 @@ DHTMessageFactoryImpl::createGetPeersReplyMessage(
     }
   }
   const String* token = getString(rDict, DHTGetPeersReplyMessage::TOKEN);
-  return createGetPeersReplyMessage(remoteNode, std::move(nodes),
-                                    std::move(peers), token->s(),
-                                    transactionID);
+  auto m = make_unique<DHTGetPeersReplyMessage>(family_, localNode_, remoteNode,
+                                                token->s(), transactionID);
+  m->setClosestKNodes(std::move(nodes));
+  m->setValues(std::move(peers));
+  setCommonProperty(m.get());
+  return m;
 }
 
 std::unique_ptr<DHTGetPeersReplyMessage>
 DHTMessageFactoryImpl::createGetPeersReplyMessage(
     const std::shared_ptr<DHTNode>& remoteNode,
     std::vector<std::shared_ptr<DHTNode>> closestKNodes,
-    std::vector<std::shared_ptr<Peer>> values, const std::string& token,
+    std::vector<std::string> compactPeers, const std::string& token,
     const std::string& transactionID)
 {
   auto m = make_unique<DHTGetPeersReplyMessage>(family_, localNode_, remoteNode,
                                                 token, transactionID);
   m->setClosestKNodes(std::move(closestKNodes));
-  m->setValues(std::move(values));
+  m->setCompactValues(std::move(compactPeers));
   setCommonProperty(m.get());
   return m;
 }
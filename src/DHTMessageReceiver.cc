@@ -68,6 +68,20 @@ DHTMessageReceiver::receiveMessage(const std::string& remoteAddr,
 {
   try {
     bool isReply = false;
+    {
+      // Replies which we are not waiting for (e.g., they arrive after
+      // timeout) are dropped here without decoding the whole message.
+      std::string y, t;
+      if (bencode2::peekDictString(data, length, DHTMessage::Y, y) &&
+          (y == DHTResponseMessage::R || y == DHTUnknownMessage::E) &&
+          bencode2::peekDictString(data, length, DHTMessage::T, t) &&
+          !tracker_->isTracked(t, remoteAddr, remotePort)) {
+        A2_LOG_DEBUG(fmt("Untracked DHT reply. TransactionID=%s From:%s:%u",
+                         util::toHex(t).c_str(), remoteAddr.c_str(),
+                         remotePort));
+        return handleUnknownMessage(data, length, remoteAddr, remotePort);
+      }
+    }
     auto decoded = bencode2::decode(data, length);
     const Dict* dict = downcast<Dict>(decoded);
     if (dict) {
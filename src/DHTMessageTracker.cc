@@ -35,6 +35,8 @@
 #include "DHTMessageTracker.h"
 
 #include <utility>
+#include <algorithm>
+#include <cassert>
 
 #include "DHTMessage.h"
 #include "DHTMessageCallback.h"
@@ -48,6 +50,7 @@
 #include "DlAbortEx.h"
 #include "DHTConstants.h"
 #include "fmt.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
@@ -60,9 +63,44 @@ void DHTMessageTracker::addMessage(DHTMessage* message,
                                    std::chrono::seconds timeout,
                                    std::unique_ptr<DHTMessageCallback> callback)
 {
-  entries_.push_back(make_unique<DHTMessageTrackerEntry>(
-      message->getRemoteNode(), message->getTransactionID(),
-      message->getMessageType(), std::move(timeout), std::move(callback)));
+  auto deadline = global::wallclock();
+  deadline.advance(timeout);
+  auto i = entries_.emplace(
+      std::move(deadline),
+      make_unique<DHTMessageTrackerEntry>(
+          message->getRemoteNode(), message->getTransactionID(),
+          message->getMessageType(), std::move(timeout), std::move(callback)));
+  index_.emplace(message->getTransactionID(), i);
+}
+
+DHTMessageTracker::IndexMap::const_iterator
+DHTMessageTracker::findEntry(const std::string& transactionID,
+                             const std::string& ipaddr, uint16_t port) const
+{
+  auto range = index_.equal_range(transactionID);
+  for (auto i = range.first; i != range.second; ++i) {
+    if ((*i).second->second->match(transactionID, ipaddr, port)) {
+      return i;
+    }
+  }
+  return std::end(index_);
+}
+
+std::unique_ptr<DHTMessageTrackerEntry>
+DHTMessageTracker::popEntry(IndexMap::const_iterator i)
+{
+  auto j = (*i).second;
+  auto entry = std::move((*j).second);
+  index_.erase(i);
+  entries_.erase(j);
+  return entry;
+}
+
+bool DHTMessageTracker::isTracked(const std::string& transactionID,
+                                  const std::string& ipaddr,
+                                  uint16_t port) const
+{
+  return findEntry(transactionID, ipaddr, port) != std::end(index_);
 }
 
 std::pair<std::unique_ptr<DHTResponseMessage>,
@@ -77,38 +115,36 @@ DHTMessageTracker::messageArrived(const Dict* dict, const std::string& ipaddr,
   }
   A2_LOG_DEBUG(fmt("Searching tracker entry for TransactionID=%s, Remote=%s:%u",
                    util::toHex(tid->s()).c_str(), ipaddr.c_str(), port));
-  for (auto i = std::begin(entries_), eoi = std::end(entries_); i != eoi; ++i) {
-    if ((*i)->match(tid->s(), ipaddr, port)) {
-      auto entry = std::move(*i);
-      entries_.erase(i);
-      A2_LOG_DEBUG("Tracker entry found.");
-      auto& targetNode = entry->getTargetNode();
-      try {
-        auto message = factory_->createResponseMessage(
-            entry->getMessageType(), dict, targetNode->getIPAddress(),
-            targetNode->getPort());
-
-        auto rtt = std::chrono::duration_cast<std::chrono::milliseconds>(
-            entry->getElapsed());
+  auto i = findEntry(tid->s(), ipaddr, port);
+  if (i != std::end(index_)) {
+    auto entry = popEntry(i);
+    A2_LOG_DEBUG("Tracker entry found.");
+    auto& targetNode = entry->getTargetNode();
+    try {
+      auto message = factory_->createResponseMessage(
+          entry->getMessageType(), dict, targetNode->getIPAddress(),
+          targetNode->getPort());
+
+      auto rtt = std::chrono::duration_cast<std::chrono::milliseconds>(
+          entry->getElapsed());
+      A2_LOG_DEBUG(
+          fmt("RTT is %" PRId64 "", static_cast<int64_t>(rtt.count())));
+      message->getRemoteNode()->updateRTT(rtt);
+      if (*targetNode != *message->getRemoteNode()) {
+        // Node ID has changed. Drop previous node ID from
+        // DHTRoutingTable
         A2_LOG_DEBUG(
-            fmt("RTT is %" PRId64 "", static_cast<int64_t>(rtt.count())));
-        message->getRemoteNode()->updateRTT(rtt);
-        if (*targetNode != *message->getRemoteNode()) {
-          // Node ID has changed. Drop previous node ID from
-          // DHTRoutingTable
-          A2_LOG_DEBUG(
-              fmt("Node ID has changed: old:%s, new:%s",
-                  util::toHex(targetNode->getID(), DHT_ID_LENGTH).c_str(),
-                  util::toHex(message->getRemoteNode()->getID(), DHT_ID_LENGTH)
-                      .c_str()));
-          routingTable_->dropNode(targetNode);
-        }
-        return std::make_pair(std::move(message), entry->popCallback());
-      }
-      catch (RecoverableException& e) {
-        handleTimeoutEntry(entry.get());
-        throw;
+            fmt("Node ID has changed: old:%s, new:%s",
+                util::toHex(targetNode->getID(), DHT_ID_LENGTH).c_str(),
+                util::toHex(message->getRemoteNode()->getID(), DHT_ID_LENGTH)
+                    .c_str()));
+        routingTable_->dropNode(targetNode);
       }
+      return std::make_pair(std::move(message), entry->popCallback());
+    }
+    catch (RecoverableException& e) {
+      handleTimeoutEntry(entry.get());
+      throw;
     }
   }
   A2_LOG_DEBUG("Tracker entry not found.");
@@ -142,31 +178,30 @@ void DHTMessageTracker::handleTimeoutEntry(DHTMessageTrackerEntry* entry)
 
 void DHTMessageTracker::handleTimeout()
 {
-  entries_.erase(
-      std::remove_if(std::begin(entries_), std::end(entries_),
-                     [&](const std::unique_ptr<DHTMessageTrackerEntry>& ent) {
-                       if (ent->isTimeout()) {
-                         handleTimeoutEntry(ent.get());
-                         return true;
-                       }
-                       else {
-                         return false;
-                       }
-                     }),
-      std::end(entries_));
+  auto& now = global::wallclock();
+  while (!entries_.empty() && (*std::begin(entries_)).first <= now) {
+    auto i = std::begin(entries_);
+    auto range = index_.equal_range((*i).second->getTransactionID());
+    auto j = std::find_if(range.first, range.second,
+                          [&i](const IndexMap::value_type& v) {
+                            return v.second == i;
+                          });
+    assert(j != range.second);
+    auto entry = popEntry(j);
+    handleTimeoutEntry(entry.get());
+  }
 }
 
 const DHTMessageTrackerEntry*
 DHTMessageTracker::getEntryFor(const DHTMessage* message) const
 {
-  for (auto& ent : entries_) {
-    if (ent->match(message->getTransactionID(),
-                   message->getRemoteNode()->getIPAddress(),
-                   message->getRemoteNode()->getPort())) {
-      return ent.get();
-    }
+  auto i = findEntry(message->getTransactionID(),
+                     message->getRemoteNode()->getIPAddress(),
+                     message->getRemoteNode()->getPort());
+  if (i == std::end(index_)) {
+    return nullptr;
   }
-  return nullptr;
+  return (*i).second->second.get();
 }
 
 size_t DHTMessageTracker::countEntry() const { return entries_.size(); }
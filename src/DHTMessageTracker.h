@@ -38,10 +38,12 @@
 #include "common.h"
 
 #include <utility>
-#include <deque>
+#include <map>
+#include <unordered_map>
 #include <memory>
 
 #include "a2time.h"
+#include "TimerA2.h"
 #include "ValueBase.h"
 
 namespace aria2 {
@@ -55,7 +57,24 @@ class DHTMessageTrackerEntry;
 
 class DHTMessageTracker {
 private:
-  std::deque<std::unique_ptr<DHTMessageTrackerEntry>> entries_;
+  // Outstanding entries ordered by their deadline, so that
+  // handleTimeout() only touches expired entries.
+  typedef std::multimap<Timer, std::unique_ptr<DHTMessageTrackerEntry>>
+      EntryMap;
+  EntryMap entries_;
+
+  // Index of entries_ by transaction ID.  Transaction IDs are chosen
+  // at random, so more than one entry may share the same key.
+  typedef std::unordered_multimap<std::string, EntryMap::iterator> IndexMap;
+  IndexMap index_;
+
+  IndexMap::const_iterator findEntry(const std::string& transactionID,
+                                     const std::string& ipaddr,
+                                     uint16_t port) const;
+
+  // Removes the entry pointed by i from entries_ and index_, and
+  // returns it.
+  std::unique_ptr<DHTMessageTrackerEntry> popEntry(IndexMap::const_iterator i);
 
   DHTRoutingTable* routingTable_;
 
@@ -72,6 +91,12 @@ public:
             std::unique_ptr<DHTMessageCallback>>
   messageArrived(const Dict* dict, const std::string& ipaddr, uint16_t port);
 
+  // Returns true if a reply from ipaddr:port with transactionID is
+  // expected.  This is used to drop unsolicited replies before they
+  // are fully decoded.
+  bool isTracked(const std::string& transactionID, const std::string& ipaddr,
+                 uint16_t port) const;
+
   void handleTimeout();
 
   // Made public so that unnamed functor can access this
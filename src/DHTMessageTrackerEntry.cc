@@ -91,6 +91,11 @@ const std::shared_ptr<DHTNode>& DHTMessageTrackerEntry::getTargetNode() const
   return targetNode_;
 }
 
+const std::string& DHTMessageTrackerEntry::getTransactionID() const
+{
+  return transactionID_;
+}
+
 const std::string& DHTMessageTrackerEntry::getMessageType() const
 {
   return messageType_;
@@ -78,6 +78,7 @@ public:
              uint16_t port) const;
 
   const std::shared_ptr<DHTNode>& getTargetNode() const;
+  const std::string& getTransactionID() const;
   const std::string& getMessageType() const;
   const std::unique_ptr<DHTMessageCallback>& getCallback() const;
   std::unique_ptr<DHTMessageCallback> popCallback();
@@ -53,7 +53,16 @@ void DHTPeerAnnounceEntry::addPeerAddrEntry(const PeerAddrEntry& entry)
 {
   auto i = std::find(peerAddrEntries_.begin(), peerAddrEntries_.end(), entry);
   if (i == peerAddrEntries_.end()) {
-    peerAddrEntries_.push_back(entry);
+    if (peerAddrEntries_.size() < DHT_PEER_ANNOUNCE_MAX_PEERS) {
+      peerAddrEntries_.push_back(entry);
+    }
+    else {
+      *std::min_element(std::begin(peerAddrEntries_),
+                        std::end(peerAddrEntries_),
+                        [](const PeerAddrEntry& lhs, const PeerAddrEntry& rhs) {
+                          return lhs.getLastUpdated() < rhs.getLastUpdated();
+                        }) = entry;
+    }
   }
   else {
     (*i).notifyUpdate();
@@ -78,6 +87,19 @@ void DHTPeerAnnounceEntry::removeStalePeerAddrEntry(
       std::end(peerAddrEntries_));
 }
 
+Timer DHTPeerAnnounceEntry::getOldestUpdated() const
+{
+  if (peerAddrEntries_.empty()) {
+    return lastUpdated_;
+  }
+  return std::min_element(
+             std::begin(peerAddrEntries_), std::end(peerAddrEntries_),
+             [](const PeerAddrEntry& lhs, const PeerAddrEntry& rhs) {
+               return lhs.getLastUpdated() < rhs.getLastUpdated();
+             })
+      ->getLastUpdated();
+}
+
 bool DHTPeerAnnounceEntry::empty() const { return peerAddrEntries_.empty(); }
 
 void DHTPeerAnnounceEntry::getPeers(
@@ -88,6 +110,15 @@ void DHTPeerAnnounceEntry::getPeers(
   }
 }
 
+void DHTPeerAnnounceEntry::getCompactPeers(
+    std::vector<std::string>& compactPeers) const
+{
+  for (const auto& p : peerAddrEntries_) {
+    compactPeers.emplace_back(p.getCompact(),
+                              p.getCompact() + p.getCompactLength());
+  }
+}
+
 void DHTPeerAnnounceEntry::notifyUpdate()
 {
   lastUpdated_ = global::wallclock();
@@ -62,7 +62,9 @@ public:
   ~DHTPeerAnnounceEntry();
 
   // add peer addr entry.
-  // if it already exists, update "Last Updated" property.
+  // if it already exists, update "Last Updated" property.  If the
+  // number of entries reaches DHT_PEER_ANNOUNCE_MAX_PEERS, the least
+  // recently updated entry is replaced with entry.
   void addPeerAddrEntry(const PeerAddrEntry& entry);
 
   size_t countPeerAddrEntry() const;
@@ -74,6 +76,10 @@ public:
 
   void removeStalePeerAddrEntry(const std::chrono::seconds& timeout);
 
+  // Returns the "Last Updated" property of the least recently updated
+  // peer addr entry.  If there is no entry, returns getLastUpdated().
+  Timer getOldestUpdated() const;
+
   bool empty() const;
 
   const Timer& getLastUpdated() const { return lastUpdated_; }
@@ -83,6 +89,10 @@ public:
   const unsigned char* getInfoHash() const { return infoHash_; }
 
   void getPeers(std::vector<std::shared_ptr<Peer>>& peers) const;
+
+  // Appends the peers in compact form, as they are sent in get_peers
+  // reply.
+  void getCompactPeers(std::vector<std::string>& compactPeers) const;
 };
 
 } // namespace aria2
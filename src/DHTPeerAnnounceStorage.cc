@@ -57,28 +57,14 @@ DHTPeerAnnounceStorage::DHTPeerAnnounceStorage()
 {
 }
 
-bool DHTPeerAnnounceStorage::InfoHashLess::
-operator()(const std::shared_ptr<DHTPeerAnnounceEntry>& lhs,
-           const std::shared_ptr<DHTPeerAnnounceEntry>& rhs) const
-{
-  return memcmp(lhs->getInfoHash(), rhs->getInfoHash(), DHT_ID_LENGTH) < 0;
-}
+DHTPeerAnnounceStorage::~DHTPeerAnnounceStorage() = default;
 
-std::shared_ptr<DHTPeerAnnounceEntry>
-DHTPeerAnnounceStorage::getPeerAnnounceEntry(const unsigned char* infoHash)
+void DHTPeerAnnounceStorage::scheduleExpiry(const DHTPeerAnnounceEntry* entry,
+                                            const std::string& infoHash)
 {
-  auto entry = std::make_shared<DHTPeerAnnounceEntry>(infoHash);
-
-  auto i = entries_.lower_bound(entry);
-
-  if (i != entries_.end() &&
-      memcmp(infoHash, (*i)->getInfoHash(), DHT_ID_LENGTH) == 0) {
-    entry = *i;
-  }
-  else {
-    entries_.insert(i, entry);
-  }
-  return entry;
+  auto expiry = entry->getOldestUpdated();
+  expiry.advance(DHT_PEER_ANNOUNCE_PURGE_INTERVAL);
+  expiryQueue_.emplace(std::move(expiry), infoHash);
 }
 
 void DHTPeerAnnounceStorage::addPeerAnnounce(const unsigned char* infoHash,
@@ -88,24 +74,38 @@ void DHTPeerAnnounceStorage::addPeerAnnounce(const unsigned char* infoHash,
   A2_LOG_DEBUG(fmt("Adding %s:%u to peer announce list: infoHash=%s",
                    ipaddr.c_str(), port,
                    util::toHex(infoHash, DHT_ID_LENGTH).c_str()));
-  getPeerAnnounceEntry(infoHash)->addPeerAddrEntry(PeerAddrEntry(ipaddr, port));
+  std::string key(&infoHash[0], &infoHash[DHT_ID_LENGTH]);
+  auto& entry = entries_[key];
+  bool added = !entry;
+  if (added) {
+    entry = make_unique<DHTPeerAnnounceEntry>(infoHash);
+  }
+  entry->addPeerAddrEntry(PeerAddrEntry(ipaddr, port, global::wallclock()));
+  if (added) {
+    scheduleExpiry(entry.get(), key);
+  }
 }
 
 bool DHTPeerAnnounceStorage::contains(const unsigned char* infoHash) const
 {
-  auto entry = std::make_shared<DHTPeerAnnounceEntry>(infoHash);
-  return std::binary_search(entries_.begin(), entries_.end(), entry,
-                            InfoHashLess());
+  return entries_.count(std::string(&infoHash[0], &infoHash[DHT_ID_LENGTH]));
 }
 
 void DHTPeerAnnounceStorage::getPeers(std::vector<std::shared_ptr<Peer>>& peers,
                                       const unsigned char* infoHash)
 {
-  auto entry = std::make_shared<DHTPeerAnnounceEntry>(infoHash);
+  auto i = entries_.find(std::string(&infoHash[0], &infoHash[DHT_ID_LENGTH]));
+  if (i != std::end(entries_)) {
+    (*i).second->getPeers(peers);
+  }
+}
 
-  auto i = entries_.find(entry);
-  if (i != entries_.end()) {
-    (*i)->getPeers(peers);
+void DHTPeerAnnounceStorage::getCompactPeers(
+    std::vector<std::string>& compactPeers, const unsigned char* infoHash)
+{
+  auto i = entries_.find(std::string(&infoHash[0], &infoHash[DHT_ID_LENGTH]));
+  if (i != std::end(entries_)) {
+    (*i).second->getCompactPeers(compactPeers);
   }
 }
 
@@ -113,17 +113,22 @@ void DHTPeerAnnounceStorage::handleTimeout()
 {
   A2_LOG_DEBUG(fmt("Now purge peer announces(%lu entries) which are timed out.",
                    static_cast<unsigned long>(entries_.size())));
-  std::for_each(std::begin(entries_), std::end(entries_),
-                [](const std::shared_ptr<DHTPeerAnnounceEntry>& e) {
-                  e->removeStalePeerAddrEntry(DHT_PEER_ANNOUNCE_PURGE_INTERVAL);
-                });
-
-  for (auto i = std::begin(entries_); i != std::end(entries_);) {
-    if ((*i)->empty()) {
-      entries_.erase(i++);
+  auto& now = global::wallclock();
+  while (!expiryQueue_.empty() && (*std::begin(expiryQueue_)).first <= now) {
+    auto infoHash = std::move((*std::begin(expiryQueue_)).second);
+    expiryQueue_.erase(std::begin(expiryQueue_));
+    auto i = entries_.find(infoHash);
+    if (i == std::end(entries_)) {
+      continue;
+    }
+    auto& entry = (*i).second;
+    entry->removeStalePeerAddrEntry(DHT_PEER_ANNOUNCE_PURGE_INTERVAL);
+    if (entry->empty()) {
+      entries_.erase(i);
     }
     else {
-      ++i;
+      // Some peers were updated after the expiry was scheduled.
+      scheduleExpiry(entry.get(), infoHash);
     }
   }
   A2_LOG_DEBUG(fmt("Currently %lu peer announce entries",
@@ -133,7 +138,8 @@ void DHTPeerAnnounceStorage::handleTimeout()
 void DHTPeerAnnounceStorage::announcePeer()
 {
   A2_LOG_DEBUG("Now announcing peer.");
-  for (auto& e : entries_) {
+  for (auto& kv : entries_) {
+    auto& e = kv.second;
     if (e->getLastUpdated().difference(global::wallclock()) <
         DHT_PEER_ANNOUNCE_INTERVAL) {
       continue;
@@ -37,11 +37,14 @@
 
 #include "common.h"
 
-#include <set>
+#include <map>
+#include <unordered_map>
 #include <vector>
 #include <string>
 #include <memory>
 
+#include "TimerA2.h"
+
 namespace aria2 {
 
 class Peer;
@@ -51,17 +54,18 @@ class DHTTaskFactory;
 
 class DHTPeerAnnounceStorage {
 private:
-  class InfoHashLess {
-  public:
-    bool operator()(const std::shared_ptr<DHTPeerAnnounceEntry>& lhs,
-                    const std::shared_ptr<DHTPeerAnnounceEntry>& rhs) const;
-  };
-  typedef std::set<std::shared_ptr<DHTPeerAnnounceEntry>, InfoHashLess>
-      DHTPeerAnnounceEntrySet;
-  DHTPeerAnnounceEntrySet entries_;
-
-  std::shared_ptr<DHTPeerAnnounceEntry>
-  getPeerAnnounceEntry(const unsigned char* infoHash);
+  // Peer announce entries keyed by infohash.
+  std::unordered_map<std::string, std::unique_ptr<DHTPeerAnnounceEntry>>
+      entries_;
+
+  // Infohashes keyed by the time when the least recently updated peer
+  // of the entry expires.  Each entry has exactly one element here,
+  // so that handleTimeout() only visits the entries which may have
+  // stale peers.
+  std::multimap<Timer, std::string> expiryQueue_;
+
+  void scheduleExpiry(const DHTPeerAnnounceEntry* entry,
+                      const std::string& infoHash);
 
   DHTTaskQueue* taskQueue_;
 
@@ -70,6 +74,8 @@ private:
 public:
   DHTPeerAnnounceStorage();
 
+  ~DHTPeerAnnounceStorage();
+
   void addPeerAnnounce(const unsigned char* infoHash, const std::string& ipaddr,
                        uint16_t port);
 
@@ -78,6 +84,9 @@ public:
   void getPeers(std::vector<std::shared_ptr<Peer>>& peers,
                 const unsigned char* infoHash);
 
+  void getCompactPeers(std::vector<std::string>& compactPeers,
+                       const unsigned char* infoHash);
+
   // drop peer announce entry which is not updated in the past
   // DHT_PEER_ANNOUNCE_PURGE_INTERVAL seconds.
   void handleTimeout();
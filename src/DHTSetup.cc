@@ -64,6 +64,9 @@
 #include "DHTMessageTrackerEntry.h"
 #include "DHTMessageEntry.h"
 #include "UDPTrackerClient.h"
+#include "DHTConstants.h"
+#include "File.h"
+#include "wallclock.h"
 #include "BtRegistry.h"
 #include "prefs.h"
 #include "Option.h"
@@ -150,6 +153,12 @@ DHTSetup::setup(DownloadEngine* e, int family)
     auto tokenTracker = make_unique<DHTTokenTracker>();
     // For now, UDPTrackerClient was enabled along with DHT
     auto udpTrackerClient = std::make_shared<UDPTrackerClient>();
+    if (family == AF_INET) {
+      auto udptFile = dhtFile + UDPT_CONNECTION_ID_FILE_SUFFIX;
+      if (File(udptFile).isFile()) {
+        udpTrackerClient->loadConnectionIds(udptFile, global::wallclock());
+      }
+    }
     const auto messageTimeout =
         e->getOption()->getAsInt(PREF_DHT_MESSAGE_TIMEOUT);
     // wiring up
@@ -34,9 +34,19 @@
 /* copyright --> */
 #include "DNSCache.h"
 #include "A2STR.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
+constexpr std::chrono::seconds DNSCache::DEFAULT_TTL;
+constexpr std::chrono::seconds DNSCache::NEGATIVE_TTL;
+
+namespace {
+// Records with very short TTL would expire between name resolution
+// and connection attempts to each address.
+constexpr auto MIN_TTL = std::chrono::seconds(10);
+} // namespace
+
 DNSCache::AddrEntry::AddrEntry(const std::string& addr)
     : addr_(addr), good_(true)
 {
@@ -56,7 +66,7 @@ DNSCache::AddrEntry& DNSCache::AddrEntry::operator=(const AddrEntry& c)
 }
 
 DNSCache::CacheEntry::CacheEntry(const std::string& hostname, uint16_t port)
-    : hostname_(hostname), port_(port)
+    : hostname_(hostname), port_(port), negative_(false)
 {
 }
 
@@ -70,6 +80,8 @@ DNSCache::CacheEntry& DNSCache::CacheEntry::operator=(const CacheEntry& c)
     hostname_ = c.hostname_;
     port_ = c.port_;
     addrEntries_ = c.addrEntries_;
+    expiry_ = c.expiry_;
+    negative_ = c.negative_;
   }
   return *this;
 }
@@ -132,6 +144,11 @@ void DNSCache::CacheEntry::markBad(const std::string& addr)
   }
 }
 
+bool DNSCache::CacheEntry::isExpired() const
+{
+  return expiry_ <= global::wallclock();
+}
+
 bool DNSCache::CacheEntry::operator<(const CacheEntry& e) const
 {
   int r = hostname_.compare(e.hostname_);
@@ -160,33 +177,84 @@ DNSCache& DNSCache::operator=(const DNSCache& c)
   return *this;
 }
 
-const std::string& DNSCache::find(const std::string& hostname,
-                                  uint16_t port) const
+std::shared_ptr<DNSCache::CacheEntry>
+DNSCache::findEntry(const std::string& hostname, uint16_t port) const
 {
   auto target = std::make_shared<CacheEntry>(hostname, port);
   auto i = entries_.find(target);
-  if (i == entries_.end()) {
+  if (i == entries_.end() || (*i)->isExpired()) {
+    return nullptr;
+  }
+  return *i;
+}
+
+void DNSCache::evictExpired()
+{
+  for (auto i = std::begin(entries_); i != std::end(entries_);) {
+    if ((*i)->isExpired()) {
+      i = entries_.erase(i);
+    }
+    else {
+      ++i;
+    }
+  }
+}
+
+const std::string& DNSCache::find(const std::string& hostname,
+                                  uint16_t port) const
+{
+  auto entry = findEntry(hostname, port);
+  if (!entry) {
     return A2STR::NIL;
   }
   else {
-    return (*i)->getGoodAddr();
+    return entry->getGoodAddr();
   }
 }
 
 void DNSCache::put(const std::string& hostname, const std::string& ipaddr,
-                   uint16_t port)
+                   uint16_t port, std::chrono::seconds ttl)
 {
+  ttl = std::max(ttl, MIN_TTL);
+  evictExpired();
   auto target = std::make_shared<CacheEntry>(hostname, port);
   auto i = entries_.lower_bound(target);
   if (i != entries_.end() && *(*i) == *target) {
-    (*i)->add(ipaddr);
+    auto& entry = *i;
+    if (entry->negative_) {
+      entry->addrEntries_.clear();
+      entry->negative_ = false;
+      entry->expiry_ = global::wallclock();
+      entry->expiry_.advance(ttl);
+    }
+    entry->add(ipaddr);
   }
   else {
     target->add(ipaddr);
+    target->expiry_ = global::wallclock();
+    target->expiry_.advance(ttl);
     entries_.insert(i, target);
   }
 }
 
+void DNSCache::putNegative(const std::string& hostname, uint16_t port,
+                           std::chrono::seconds ttl)
+{
+  evictExpired();
+  auto target = std::make_shared<CacheEntry>(hostname, port);
+  target->negative_ = true;
+  target->expiry_ = global::wallclock();
+  target->expiry_.advance(ttl);
+  entries_.erase(target);
+  entries_.insert(target);
+}
+
+bool DNSCache::isNegative(const std::string& hostname, uint16_t port) const
+{
+  auto entry = findEntry(hostname, port);
+  return entry && entry->negative_;
+}
+
 void DNSCache::markBad(const std::string& hostname, const std::string& ipaddr,
                        uint16_t port)
 {
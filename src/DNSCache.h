@@ -43,6 +43,7 @@
 #include <vector>
 
 #include "a2functional.h"
+#include "TimerA2.h"
 
 namespace aria2 {
 
@@ -63,6 +64,10 @@ private:
     std::string hostname_;
     uint16_t port_;
     std::vector<AddrEntry> addrEntries_;
+    // The time when this entry expires
+    Timer expiry_;
+    // true if hostname_ does not exist.  addrEntries_ is empty.
+    bool negative_;
 
     CacheEntry(const std::string& hostname, uint16_t port);
     CacheEntry(const CacheEntry& c);
@@ -92,6 +97,8 @@ private:
 
     void markBad(const std::string& addr);
 
+    bool isExpired() const;
+
     bool operator<(const CacheEntry& e) const;
 
     bool operator==(const CacheEntry& e) const;
@@ -102,6 +109,16 @@ private:
       CacheEntrySet;
   CacheEntrySet entries_;
 
+  // Returns the entry for hostname and port if it exists and has not
+  // expired.  Otherwise returns null.
+  std::shared_ptr<CacheEntry> findEntry(const std::string& hostname,
+                                        uint16_t port) const;
+
+  // Removes the expired entries, including the negative ones.  This
+  // is done whenever an entry is put, so that the cache does not keep
+  // the hosts which are no longer used.
+  void evictExpired();
+
 public:
   DNSCache();
   DNSCache(const DNSCache& c);
@@ -115,20 +132,36 @@ public:
   void findAll(OutputIterator out, const std::string& hostname,
                uint16_t port) const
   {
-    auto target = std::make_shared<CacheEntry>(hostname, port);
-    auto i = entries_.find(target);
-    if (i != entries_.end()) {
-      (*i)->getAllGoodAddrs(out);
+    auto entry = findEntry(hostname, port);
+    if (entry) {
+      entry->getAllGoodAddrs(out);
     }
   }
 
+  // Caches ipaddr for hostname and port for ttl.  If the existing
+  // entry has expired or is negative, it is replaced.
   void put(const std::string& hostname, const std::string& ipaddr,
-           uint16_t port);
+           uint16_t port, std::chrono::seconds ttl = DEFAULT_TTL);
+
+  // Caches the fact that hostname does not exist for ttl.
+  void putNegative(const std::string& hostname, uint16_t port,
+                   std::chrono::seconds ttl = NEGATIVE_TTL);
+
+  // Returns true if hostname is cached as non-existent.
+  bool isNegative(const std::string& hostname, uint16_t port) const;
 
   void markBad(const std::string& hostname, const std::string& ipaddr,
                uint16_t port);
 
   void remove(const std::string& hostname, uint16_t port);
+
+  // Returns the number of the cached entries, including the expired
+  // ones which are not evicted yet.
+  size_t size() const { return entries_.size(); }
+
+  // Used when the resolver does not tell TTL.
+  static constexpr std::chrono::seconds DEFAULT_TTL = std::chrono::seconds(300);
+  static constexpr std::chrono::seconds NEGATIVE_TTL = std::chrono::seconds(60);
 };
 
 } // namespace aria2
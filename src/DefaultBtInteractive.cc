@@ -567,6 +567,12 @@ void DefaultBtInteractive::doInteractionProcessing()
       perSecTimer_ = global::wallclock();
       dispatcher_->checkRequestSlotAndDoNecessaryThing();
     }
+    else if (pieceStorage_->isEndGame()) {
+      // In end game mode, the same block is requested from several
+      // peers.  Send cancel as soon as one of them arrives, so that
+      // the others do not waste bandwidth on it.
+      dispatcher_->checkRequestSlotAndDoNecessaryThing();
+    }
     numReceivedMessage_ = receiveMessages();
     detectMessageFlooding();
     decideChoking();
@@ -71,9 +71,21 @@ DefaultBtMessageDispatcher::DefaultBtMessageDispatcher()
 {
 }
 
+namespace {
+void releaseBlock(const RequestSlot* slot, cuid_t cuid)
+{
+  if (slot->getPiece()) {
+    slot->getPiece()->removeBlockRequester(slot->getBlockIndex(), cuid);
+  }
+}
+} // namespace
+
 DefaultBtMessageDispatcher::~DefaultBtMessageDispatcher()
 {
   A2_LOG_DEBUG("DefaultBtMessageDispatcher::deleted");
+  for (auto& slot : requestSlots_) {
+    releaseBlock(slot.get(), cuid_);
+  }
 }
 
 void DefaultBtMessageDispatcher::addMessageToQueue(
@@ -154,6 +166,7 @@ void abortOutstandingRequest(const RequestSlot* slot,
                    slot->getBegin(),
                    static_cast<unsigned long>(slot->getBlockIndex())));
   piece->cancelBlock(slot->getBlockIndex());
+  piece->removeBlockRequester(slot->getBlockIndex(), cuid);
 }
 } // namespace
 
@@ -191,6 +204,7 @@ void DefaultBtMessageDispatcher::doChokedAction()
                        slot->getBegin(),
                        static_cast<unsigned long>(slot->getBlockIndex())));
       slot->getPiece()->cancelBlock(slot->getBlockIndex());
+      releaseBlock(slot.get(), cuid_);
     }
   }
   requestSlots_.erase(
@@ -221,6 +235,7 @@ void DefaultBtMessageDispatcher::checkRequestSlotAndDoNecessaryThing()
                        slot->getBegin(),
                        static_cast<unsigned long>(slot->getBlockIndex())));
       slot->getPiece()->cancelBlock(slot->getBlockIndex());
+      releaseBlock(slot.get(), cuid_);
       peer_->snubbing(true);
     }
     else if (slot->getPiece()->hasBlock(slot->getBlockIndex())) {
@@ -230,6 +245,7 @@ void DefaultBtMessageDispatcher::checkRequestSlotAndDoNecessaryThing()
                        static_cast<unsigned long>(slot->getBlockIndex())));
       addMessageToQueue(messageFactory_->createCancelMessage(
           slot->getIndex(), slot->getBegin(), slot->getLength()));
+      releaseBlock(slot.get(), cuid_);
     }
   }
   requestSlots_.erase(
@@ -286,6 +302,9 @@ void DefaultBtMessageDispatcher::removeOutstandingRequest(
 void DefaultBtMessageDispatcher::addOutstandingRequest(
     std::unique_ptr<RequestSlot> slot)
 {
+  if (slot->getPiece()) {
+    slot->getPiece()->addBlockRequester(slot->getBlockIndex(), cuid_);
+  }
   requestSlots_.push_back(std::move(slot));
 }
 
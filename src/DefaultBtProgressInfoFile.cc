@@ -46,6 +46,7 @@
 #include "Logger.h"
 #include "prefs.h"
 #include "DlAbortEx.h"
+#include "RecoverableException.h"
 #include "message.h"
 #include "File.h"
 #include "util.h"
@@ -202,6 +203,12 @@ void DefaultBtProgressInfoFile::save()
 
   lastDigest_ = std::move(digest);
 
+  if (pieceStorage_ && option_->getAsBool(PREF_DURABLE_SAVE)) {
+    // The control file must not record data which are not on the
+    // storage device yet.
+    pieceStorage_->syncData();
+  }
+
   A2_LOG_INFO(fmt(MSG_SAVING_SEGMENT_FILE, filename_.c_str()));
   std::string filenameTemp = filename_;
   filenameTemp += "__temp";
@@ -210,7 +217,8 @@ void DefaultBtProgressInfoFile::save()
     if (!fp) {
       throw DL_ABORT_EX(fmt(EX_SEGMENT_FILE_WRITE, filename_.c_str()));
     }
-
+    // save(fp) closes fp, which flushes and fsyncs it.  Its contents
+    // are on the storage device before it replaces filename_.
     save(fp);
   }
 
@@ -399,6 +407,19 @@ void DefaultBtProgressInfoFile::load()
 void DefaultBtProgressInfoFile::removeFile()
 {
   if (exists()) {
+    if (pieceStorage_ && option_->getAsBool(PREF_DURABLE_SAVE)) {
+      try {
+        pieceStorage_->syncData();
+      }
+      catch (RecoverableException& e) {
+        // Keep the control file so that data which may not be on the
+        // storage device are downloaded again.
+        A2_LOG_ERROR_EX(fmt("Not removing control file %s",
+                            filename_.c_str()),
+                        e);
+        return;
+      }
+    }
     File f(filename_);
     f.remove();
   }
@@ -197,43 +197,55 @@ DefaultBtRequestFactory::createRequestMessages(size_t max, bool endGame)
 std::vector<std::unique_ptr<BtRequestMessage>>
 DefaultBtRequestFactory::createRequestMessagesOnEndGame(size_t max)
 {
-  auto requests = std::vector<std::unique_ptr<BtRequestMessage>>{};
-  for (auto itr = std::begin(pieces_), eoi = std::end(pieces_);
-       itr != eoi && requests.size() < max; ++itr) {
-    auto& piece = *itr;
+  // Collect all missing blocks which are not requested to this peer
+  // yet, and request the ones which the fewest other peers are
+  // working on first.  This spreads requests over the remaining
+  // blocks instead of asking every peer for the same blocks.
+  struct Candidate {
+    std::shared_ptr<Piece> piece;
+    size_t blockIndex;
+    size_t numRequester;
+  };
+  auto candidates = std::vector<Candidate>{};
+  for (auto& piece : pieces_) {
     const size_t mislen = piece->getBitfieldLength();
     auto misbitfield = make_unique<unsigned char[]>(mislen);
 
     piece->getAllMissingBlockIndexes(misbitfield.get(), mislen);
 
-    auto missingBlockIndexes = std::vector<size_t>{};
     size_t blockIndex = 0;
     for (size_t i = 0; i < mislen; ++i) {
       unsigned char bits = misbitfield[i];
       unsigned char mask = 128;
       for (size_t bi = 0; bi < 8; ++bi, mask >>= 1, ++blockIndex) {
-        if (bits & mask) {
-          missingBlockIndexes.push_back(blockIndex);
+        if ((bits & mask) &&
+            !dispatcher_->isOutstandingRequest(piece->getIndex(),
+                                               blockIndex)) {
+          candidates.push_back(Candidate{
+              piece, blockIndex, piece->countBlockRequester(blockIndex)});
         }
       }
     }
-    std::shuffle(std::begin(missingBlockIndexes), std::end(missingBlockIndexes),
-                 *SimpleRandomizer::getInstance());
-    for (auto bitr = std::begin(missingBlockIndexes),
-              eoi2 = std::end(missingBlockIndexes);
-         bitr != eoi2 && requests.size() < max; ++bitr) {
-      size_t blockIndex = *bitr;
-      if (!dispatcher_->isOutstandingRequest(piece->getIndex(), blockIndex)) {
-        A2_LOG_DEBUG(
-            fmt("Creating RequestMessage index=%lu, begin=%u,"
-                " blockIndex=%lu",
-                static_cast<unsigned long>(piece->getIndex()),
-                static_cast<unsigned int>(blockIndex * piece->getBlockLength()),
-                static_cast<unsigned long>(blockIndex)));
-        requests.push_back(
-            messageFactory_->createRequestMessage(piece, blockIndex));
-      }
-    }
+  }
+  std::shuffle(std::begin(candidates), std::end(candidates),
+               *SimpleRandomizer::getInstance());
+  std::stable_sort(std::begin(candidates), std::end(candidates),
+                   [](const Candidate& lhs, const Candidate& rhs) {
+                     return lhs.numRequester < rhs.numRequester;
+                   });
+  auto requests = std::vector<std::unique_ptr<BtRequestMessage>>{};
+  for (auto itr = std::begin(candidates), eoi = std::end(candidates);
+       itr != eoi && requests.size() < max; ++itr) {
+    auto& piece = (*itr).piece;
+    A2_LOG_DEBUG(fmt("Creating RequestMessage index=%lu, begin=%u,"
+                     " blockIndex=%lu, requesters=%lu",
+                     static_cast<unsigned long>(piece->getIndex()),
+                     static_cast<unsigned int>((*itr).blockIndex *
+                                               piece->getBlockLength()),
+                     static_cast<unsigned long>((*itr).blockIndex),
+                     static_cast<unsigned long>((*itr).numRequester)));
+    requests.push_back(
+        messageFactory_->createRequestMessage(piece, (*itr).blockIndex));
   }
   return requests;
 }
@@ -67,6 +67,7 @@
 #include "SingletonHolder.h"
 #include "Notifier.h"
 #include "WrDiskCache.h"
+#include "WrDiskCacheEntry.h"
 #include "RequestGroup.h"
 #include "SimpleRandomizer.h"
 #ifdef ENABLE_BITTORRENT
@@ -84,6 +85,7 @@ DefaultPieceStorage::DefaultPieceStorage(
       diskWriterFactory_(std::make_shared<DefaultDiskWriterFactory>()),
       endGame_(false),
       endGamePieceNum_(END_GAME_PIECE_NUM),
+      endGameDuplicateLength_(0),
       option_(option),
       // The DefaultBtInteractive has the default value of
       // lastHaveIndex of 0, so we need to make nextHaveIndex_ more
@@ -92,7 +94,8 @@ DefaultPieceStorage::DefaultPieceStorage(
       pieceStatMan_(std::make_shared<PieceStatMan>(
           downloadContext->getNumPieces(), true)),
       pieceSelector_(make_unique<RarestPieceSelector>(pieceStatMan_)),
-      wrDiskCache_(nullptr)
+      wrDiskCache_(nullptr),
+      rdDiskCache_(nullptr)
 {
   const std::string& pieceSelectorOpt =
       option_->get(PREF_STREAM_PIECE_SELECTOR);
@@ -112,6 +115,21 @@ DefaultPieceStorage::DefaultPieceStorage(
     streamPieceSelector_ =
         make_unique<GeomStreamPieceSelector>(bitfieldMan_.get(), 1.5);
   }
+  // Pieces which lie entirely in pad files (BEP 47) are all zeros,
+  // and never need to be downloaded.
+  int64_t pieceLength = downloadContext_->getPieceLength();
+  for (auto& fe : downloadContext_->getFileEntries()) {
+    if (!fe->isPadFile() || fe->getLength() == 0) {
+      continue;
+    }
+    size_t first = (fe->getOffset() + pieceLength - 1) / pieceLength;
+    size_t last = fe->getLastOffset() == downloadContext_->getTotalLength()
+                      ? downloadContext_->getNumPieces()
+                      : fe->getLastOffset() / pieceLength;
+    if (first < last) {
+      bitfieldMan_->setBitRange(first, last - 1);
+    }
+  }
 }
 
 DefaultPieceStorage::~DefaultPieceStorage() = default;
@@ -471,6 +489,13 @@ void DefaultPieceStorage::completePiece(const std::shared_ptr<Piece>& piece)
   bitfieldMan_->setBit(piece->getIndex());
   bitfieldMan_->unsetUseBit(piece->getIndex());
   addPieceStats(piece->getIndex());
+  if (diskAdaptor_ && option_->getAsBool(PREF_DURABLE_SAVE)) {
+    // Start writeback now, so that the sync done when the control
+    // file is saved has less to wait for.
+    diskAdaptor_->writeback(piece->getLength(),
+                            static_cast<int64_t>(piece->getIndex()) *
+                                downloadContext_->getPieceLength());
+  }
   if (downloadFinished()) {
     downloadContext_->resetDownloadStopTime();
     if (isSelectiveDownloadingMode()) {
@@ -482,6 +507,11 @@ void DefaultPieceStorage::completePiece(const std::shared_ptr<Piece>& piece)
     else {
       A2_LOG_INFO(MSG_DOWNLOAD_COMPLETED);
     }
+    if (endGame_) {
+      A2_LOG_INFO(fmt("End game: %" PRId64 " bytes were downloaded more"
+                      " than once.",
+                      endGameDuplicateLength_));
+    }
 #ifdef ENABLE_BITTORRENT
     if (downloadContext_->hasAttribute(CTX_ATTR_BT)) {
       if (!bittorrent::getTorrentAttrs(downloadContext_)->metadata.empty()) {
@@ -497,11 +527,17 @@ void DefaultPieceStorage::completePiece(const std::shared_ptr<Piece>& piece)
         diskAdaptor_->openFile();
 #  endif // __MINGW32__
         auto group = downloadContext_->getOwnerRequestGroup();
-
-        util::executeHookByOptName(group, option_,
-                                   PREF_ON_BT_DOWNLOAD_COMPLETE);
-        SingletonHolder<Notifier>::instance()->notifyDownloadEvent(
-            EVENT_ON_BT_DOWNLOAD_COMPLETE, group);
+        if (option_->blank(PREF_COMPLETED_DIR)) {
+          util::executeHookByOptName(group, option_,
+                                     PREF_ON_BT_DOWNLOAD_COMPLETE);
+          SingletonHolder<Notifier>::instance()->notifyDownloadEvent(
+              EVENT_ON_BT_DOWNLOAD_COMPLETE, group);
+        }
+        else {
+          // The download keeps seeding from the new location.  The
+          // hooks are executed after the files are moved.
+          group->requestMoveCompletedFiles();
+        }
 
         group->enableSeedOnly();
       }
@@ -651,6 +687,8 @@ void DefaultPieceStorage::initStorage()
     multiDiskAdaptor->setFileEntries(downloadContext_->getFileEntries().begin(),
                                      downloadContext_->getFileEntries().end());
     multiDiskAdaptor->setPieceLength(downloadContext_->getPieceLength());
+    multiDiskAdaptor->setPartsStorePath(downloadContext_->getBasePath() +
+                                        ".parts");
     diskAdaptor_ = std::move(multiDiskAdaptor);
   }
   if (option_->get(PREF_FILE_ALLOCATION) == V_FALLOC) {
@@ -659,6 +697,46 @@ void DefaultPieceStorage::initStorage()
   else if (option_->get(PREF_FILE_ALLOCATION) == V_TRUNC) {
     diskAdaptor_->setFileAllocationMethod(DiskAdaptor::FILE_ALLOC_TRUNC);
   }
+  if (option_->getAsBool(PREF_ENABLE_DIRECT_IO)) {
+    diskAdaptor_->enableDirectIO();
+  }
+  if (option_->getAsBool(PREF_DURABLE_SAVE)) {
+    diskAdaptor_->enableDataSync();
+  }
+}
+
+// not unittested
+void DefaultPieceStorage::reopenStorage()
+{
+  // The files are complete, and only read while seeding.
+  if (downloadContext_->getFileEntries().size() == 1) {
+    // DiskWriter keeps the path it was created with.
+    auto directDiskAdaptor =
+        std::static_pointer_cast<DirectDiskAdaptor>(diskAdaptor_);
+    directDiskAdaptor->setDiskWriter(
+        diskWriterFactory_->newDiskWriter(directDiskAdaptor->getFilePath()));
+    directDiskAdaptor->enableReadOnly();
+    if (option_->getAsBool(PREF_ENABLE_DIRECT_IO)) {
+      directDiskAdaptor->enableDirectIO();
+    }
+    if (option_->getAsBool(PREF_DURABLE_SAVE)) {
+      directDiskAdaptor->enableDataSync();
+    }
+  }
+  else {
+    auto multiDiskAdaptor =
+        std::static_pointer_cast<MultiDiskAdaptor>(diskAdaptor_);
+    multiDiskAdaptor->enableReadOnly();
+    multiDiskAdaptor->setPartsStorePath(downloadContext_->getBasePath() +
+                                        ".parts");
+  }
+  diskAdaptor_->openFile();
+  // DiskWriters are created again above.  See also
+  // BtFileAllocationEntry.
+  if (option_->getAsBool(PREF_ENABLE_MMAP) &&
+      diskAdaptor_->size() <= option_->getAsLLInt(PREF_MAX_MMAP_LIMIT)) {
+    diskAdaptor_->enableMmap();
+  }
 }
 
 void DefaultPieceStorage::setBitfield(const unsigned char* bitfield,
@@ -702,6 +780,28 @@ void DefaultPieceStorage::flushWrDiskCacheEntry()
   }
 }
 
+void DefaultPieceStorage::syncData()
+{
+  if (!diskAdaptor_) {
+    return;
+  }
+  if (wrDiskCache_) {
+    for (auto& piece : usedPieces_) {
+      if (piece->getWrDiskCacheEntry()) {
+        piece->flushWrCache(wrDiskCache_);
+        if (piece->getWrDiskCacheEntry()->getError() !=
+            WrDiskCacheEntry::CACHE_ERR_SUCCESS) {
+          throw DL_ABORT_EX2(
+              fmt("Write disk cache flush failure index=%lu",
+                  static_cast<unsigned long>(piece->getIndex())),
+              piece->getWrDiskCacheEntry()->getErrorCode());
+        }
+      }
+    }
+  }
+  diskAdaptor_->sync();
+}
+
 int32_t DefaultPieceStorage::getPieceLength(size_t index)
 {
   return bitfieldMan_->getBlockLength(index);
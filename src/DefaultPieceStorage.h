@@ -82,6 +82,7 @@ private:
 
   bool endGame_;
   size_t endGamePieceNum_;
+  int64_t endGameDuplicateLength_;
   const Option* option_;
 
   // The next unique index on HaveEntry, which is ever strictly
@@ -95,6 +96,7 @@ private:
   std::unique_ptr<StreamPieceSelector> streamPieceSelector_;
 
   WrDiskCache* wrDiskCache_;
+  RdDiskCache* rdDiskCache_;
 #ifdef ENABLE_BITTORRENT
   void getMissingPiece(std::vector<std::shared_ptr<Piece>>& pieces,
                        size_t minMissingBlocks, const unsigned char* bitfield,
@@ -202,6 +204,8 @@ public:
 
   virtual void initStorage() CXX11_OVERRIDE;
 
+  virtual void reopenStorage() CXX11_OVERRIDE;
+
   virtual void setupFileFilter() CXX11_OVERRIDE;
 
   virtual void clearFileFilter() CXX11_OVERRIDE;
@@ -230,12 +234,26 @@ public:
 
   virtual void enterEndGame() CXX11_OVERRIDE { endGame_ = true; }
 
+  virtual void addEndGameDuplicateLength(int64_t length) CXX11_OVERRIDE
+  {
+    endGameDuplicateLength_ += length;
+  }
+
+  virtual int64_t getEndGameDuplicateLength() CXX11_OVERRIDE
+  {
+    return endGameDuplicateLength_;
+  }
+
   virtual std::shared_ptr<DiskAdaptor> getDiskAdaptor() CXX11_OVERRIDE;
 
   virtual WrDiskCache* getWrDiskCache() CXX11_OVERRIDE;
 
+  virtual RdDiskCache* getRdDiskCache() CXX11_OVERRIDE { return rdDiskCache_; }
+
   virtual void flushWrDiskCacheEntry() CXX11_OVERRIDE;
 
+  virtual void syncData() CXX11_OVERRIDE;
+
   virtual int32_t getPieceLength(size_t index) CXX11_OVERRIDE;
 
   virtual void advertisePiece(cuid_t cuid, size_t index,
@@ -300,6 +318,8 @@ public:
   std::unique_ptr<PieceSelector> popPieceSelector();
 
   void setWrDiskCache(WrDiskCache* wrDiskCache) { wrDiskCache_ = wrDiskCache; }
+
+  void setRdDiskCache(RdDiskCache* rdDiskCache) { rdDiskCache_ = rdDiskCache; }
 };
 
 } // namespace aria2
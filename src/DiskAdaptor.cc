@@ -33,13 +33,63 @@
  */
 /* copyright --> */
 #include "DiskAdaptor.h"
+
+#include <vector>
+
 #include "FileEntry.h"
 #include "OpenedFileCounter.h"
+#include "WrDiskCacheEntry.h"
+#include "LogFactory.h"
+#include "fmt.h"
+#include "a2functional.h"
 
 namespace aria2 {
 
+namespace {
+// Upper bound of the data coalesced into one write.
+constexpr size_t MAX_COALESCE_LENGTH = 1_m;
+} // namespace
+
 DiskAdaptor::DiskAdaptor() : fileAllocationMethod_(FILE_ALLOC_ADAPTIVE) {}
 
 DiskAdaptor::~DiskAdaptor() = default;
 
+void DiskAdaptor::writeCache(const WrDiskCacheEntry* entry)
+{
+  auto& dataSet = entry->getDataSet();
+  std::vector<unsigned char> buf;
+  int64_t goff = 0;
+  for (auto i = std::begin(dataSet), eoi = std::end(dataSet); i != eoi; ++i) {
+    auto d = *i;
+    if (!buf.empty() && goff + static_cast<int64_t>(buf.size()) == d->goff &&
+        buf.size() + d->len <= MAX_COALESCE_LENGTH) {
+      buf.insert(std::end(buf), d->data + d->offset,
+                 d->data + d->offset + d->len);
+      continue;
+    }
+    if (!buf.empty()) {
+      A2_LOG_DEBUG(fmt("Cache flush goff=%" PRId64 ", len=%lu", goff,
+                       static_cast<unsigned long>(buf.size())));
+      writeData(buf.data(), buf.size(), goff);
+      buf.clear();
+    }
+    auto next = std::next(i);
+    if (next != eoi &&
+        d->goff + static_cast<int64_t>(d->len) == (*next)->goff &&
+        d->len + (*next)->len <= MAX_COALESCE_LENGTH) {
+      goff = d->goff;
+      buf.assign(d->data + d->offset, d->data + d->offset + d->len);
+      continue;
+    }
+    A2_LOG_DEBUG(fmt("Cache flush goff=%" PRId64 ", len=%lu", d->goff,
+                     static_cast<unsigned long>(d->len)));
+    writeData(d->data + d->offset, d->len, d->goff);
+  }
+  if (!buf.empty()) {
+    A2_LOG_DEBUG(fmt("Cache flush goff=%" PRId64 ", len=%lu", goff,
+                     static_cast<unsigned long>(buf.size())));
+    writeData(buf.data(), buf.size(), goff);
+  }
+}
+
 } // namespace aria2
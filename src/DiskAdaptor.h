@@ -96,6 +96,20 @@ public:
   // have been opened before this method call.
   virtual void enableMmap() {}
 
+  // Enables direct I/O.  This must be called before files are opened.
+  virtual void enableDirectIO() {}
+
+  // Makes sure that the files are synced before they are closed.
+  // This must be called before files are opened.
+  virtual void enableDataSync() {}
+
+  // Makes the data written so far durable.
+  virtual void sync() {}
+
+  // Starts writing back the data in range [offset, offset + len)
+  // without waiting for it.
+  virtual void writeback(int64_t len, int64_t offset) {}
+
   // Assumed each file length is stored in fileEntries or DiskAdaptor knows it.
   // If each actual file's length is larger than that, truncate file to that
   // length.
@@ -111,8 +125,18 @@ public:
   virtual ssize_t readDataDropCache(unsigned char* data, size_t len,
                                     int64_t offset) = 0;
 
-  // Writes cached data to the underlying disk.
-  virtual void writeCache(const WrDiskCacheEntry* entry) = 0;
+  // Returns the pointer to the memory mapped data in range [offset,
+  // offset + len), or nullptr if it is not available, for example,
+  // because the range spans several files.  The pointer is valid
+  // until the next call to the other functions of this object.
+  virtual const unsigned char* getMappedData(size_t len, int64_t offset)
+  {
+    return nullptr;
+  }
+
+  // Writes cached data to the underlying disk.  Contiguous data are
+  // coalesced into one write.
+  virtual void writeCache(const WrDiskCacheEntry* entry);
 
   void setFileAllocationMethod(FileAllocationMethod method)
   {
@@ -121,11 +145,6 @@ public:
 
   int getFileAllocationMethod() const { return fileAllocationMethod_; }
 
-  // Closes at most |numClose| files if possible. This method is used to
-  // ensure that global number of open file stays under certain limit.
-  // Returns the number of closed files.
-  virtual size_t tryCloseFile(size_t numClose) { return 0; }
-
   void
   setOpenedFileCounter(std::shared_ptr<OpenedFileCounter> openedFileCounter)
   {
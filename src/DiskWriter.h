@@ -83,6 +83,34 @@ public:
   // Enables mmap.
   virtual void enableMmap() {}
 
+  // Enables direct I/O, which bypasses the page cache.  This takes
+  // effect when the file is opened next time, and disables mmap.
+  virtual void enableDirectIO() {}
+
+  // Returns the number of file descriptors held by this object.  The
+  // default implementation returns 0.
+  virtual size_t getNumOpenFds() const { return 0; }
+
+  // Returns the pointer to the memory mapped data in range [offset,
+  // offset + len), or nullptr if the range is not mapped.  The
+  // default implementation returns nullptr.
+  virtual const unsigned char* getMappedData(size_t len, int64_t offset)
+  {
+    return nullptr;
+  }
+
+  // Makes the data and the size of the file durable.  If sync is
+  // enabled by enableDataSync(), it is also done when the file is
+  // closed, and its error is thrown by the next call of this
+  // function.  The default implementation does nothing.
+  virtual void sync() {}
+
+  virtual void enableDataSync() {}
+
+  // Starts writing back the data in range [offset, offset + len)
+  // without waiting for it.  The default implementation does nothing.
+  virtual void writeback(int64_t len, int64_t offset) {}
+
   // Drops cache in range [offset, offset + len)
   virtual void dropCache(int64_t len, int64_t offset) {}
 };
@@ -94,7 +94,7 @@ DownloadCommand::DownloadCommand(
     }
   }
 
-  peerStat_ = req->initPeerStat();
+  peerStat_ = req->initPeerStat(getCuid());
   peerStat_->downloadStart();
   getSegmentMan()->registerPeerStat(peerStat_);
 
@@ -343,6 +343,12 @@ bool DownloadCommand::prepareForNextSegment()
     return true;
   }
   else {
+    // The connection tuner may want fewer connections, e.g., after the
+    // server responded with 503.  Surplus connections stop here
+    // instead of going on with the next segment.
+    if (getRequestGroup()->shouldShedConnection(getCuid())) {
+      return prepareForRetry(0);
+    }
     // The number of segments should be 1 in order to pass through the next
     // segment.
     if (getSegments().size() == 1) {
@@ -97,6 +97,10 @@ constexpr auto DEFAULT_REFRESH_INTERVAL = 1_s;
 DownloadEngine::DownloadEngine(std::unique_ptr<EventPoll> eventPoll)
     : eventPoll_(std::move(eventPoll)),
       haltRequested_(0),
+      socketPoolSize_(0),
+      socketPoolHits_(0),
+      socketPoolMisses_(0),
+      socketPoolEvicted_(0),
       noWait_(true),
       refreshInterval_(DEFAULT_REFRESH_INTERVAL),
       lastRefresh_(Timer::zero()),
@@ -309,12 +313,36 @@ void DownloadEngine::addRoutineCommand(std::unique_ptr<Command> command)
   routineCommands_.push_back(std::move(command));
 }
 
+namespace {
+// The maximum number of pooled sockets per key.  This is the upper
+// bound of --max-connection-per-server.
+constexpr size_t SOCKET_POOL_MAX_PER_KEY = 16;
+// The maximum number of pooled sockets in total
+constexpr size_t SOCKET_POOL_MAX = 1024;
+} // namespace
+
 void DownloadEngine::poolSocket(const std::string& key,
                                 const SocketPoolEntry& entry)
 {
+  if (socketPoolSize_ >= SOCKET_POOL_MAX) {
+    evictSocketPool();
+    if (socketPoolSize_ >= SOCKET_POOL_MAX) {
+      A2_LOG_INFO(fmt("SocketPool is full. Not pooling socket for %s",
+                      key.c_str()));
+      ++socketPoolEvicted_;
+      return;
+    }
+  }
   A2_LOG_INFO(fmt("Pool socket for %s", key.c_str()));
-  std::multimap<std::string, SocketPoolEntry>::value_type p(key, entry);
-  socketPool_.insert(p);
+  auto& entries = socketPool_[key];
+  if (entries.size() >= SOCKET_POOL_MAX_PER_KEY) {
+    // Drop the least recently pooled one.
+    entries.pop_front();
+    --socketPoolSize_;
+    ++socketPoolEvicted_;
+  }
+  entries.push_back(entry);
+  ++socketPoolSize_;
 }
 
 void DownloadEngine::evictSocketPool()
@@ -323,17 +351,29 @@ void DownloadEngine::evictSocketPool()
     return;
   }
 
-  std::multimap<std::string, SocketPoolEntry> newPool;
   A2_LOG_DEBUG("Scanning SocketPool and erasing timed out entry.");
-  for (auto& elem : socketPool_) {
-    if (!elem.second.isTimeout()) {
-      newPool.insert(elem);
+  size_t numEvicted = 0;
+  for (auto i = socketPool_.begin(); i != socketPool_.end();) {
+    auto& entries = (*i).second;
+    auto last = std::remove_if(
+        entries.begin(), entries.end(),
+        [](const SocketPoolEntry& e) { return e.isTimeout(); });
+    numEvicted += entries.end() - last;
+    entries.erase(last, entries.end());
+    if (entries.empty()) {
+      i = socketPool_.erase(i);
+    }
+    else {
+      ++i;
     }
   }
-  A2_LOG_DEBUG(
-      fmt("%lu entries removed.",
-          static_cast<unsigned long>(socketPool_.size() - newPool.size())));
-  socketPool_ = std::move(newPool);
+  socketPoolSize_ -= numEvicted;
+  socketPoolEvicted_ += numEvicted;
+  A2_LOG_DEBUG(fmt("%lu entries removed. SocketPool: %lu entries, %" PRIu64
+                   " hits, %" PRIu64 " misses, %" PRIu64 " evicted",
+                   static_cast<unsigned long>(numEvicted),
+                   static_cast<unsigned long>(socketPoolSize_), socketPoolHits_,
+                   socketPoolMisses_, socketPoolEvicted_));
 }
 
 namespace {
@@ -435,22 +475,42 @@ void DownloadEngine::poolSocket(const std::shared_ptr<Request>& request,
   }
 }
 
-std::multimap<std::string, DownloadEngine::SocketPoolEntry>::iterator
-DownloadEngine::findSocketPoolEntry(const std::string& key)
+bool DownloadEngine::popSocketPoolEntry(SocketPoolEntry& entry,
+                                        const std::string& key)
 {
-  std::pair<std::multimap<std::string, SocketPoolEntry>::iterator,
-            std::multimap<std::string, SocketPoolEntry>::iterator>
-      range = socketPool_.equal_range(key);
-  for (auto i = range.first, eoi = range.second; i != eoi; ++i) {
-    const SocketPoolEntry& e = (*i).second;
+  auto i = socketPool_.find(key);
+  if (i == socketPool_.end()) {
+    ++socketPoolMisses_;
+    return false;
+  }
+  auto& entries = (*i).second;
+  bool found = false;
+  // The most recently pooled socket is the least likely to be closed
+  // by the peer.
+  while (!entries.empty()) {
+    auto e = std::move(entries.back());
+    entries.pop_back();
+    --socketPoolSize_;
     // We assume that if socket is readable it means peer shutdowns
     // connection and the socket will receive EOF. So skip it.
     if (!e.isTimeout() && !e.getSocket()->isReadable(0)) {
       A2_LOG_INFO(fmt("Found socket for %s", key.c_str()));
-      return i;
+      entry = std::move(e);
+      found = true;
+      break;
     }
+    ++socketPoolEvicted_;
+  }
+  if (entries.empty()) {
+    socketPool_.erase(i);
+  }
+  if (found) {
+    ++socketPoolHits_;
   }
-  return socketPool_.end();
+  else {
+    ++socketPoolMisses_;
+  }
+  return found;
 }
 
 std::shared_ptr<SocketCore>
@@ -458,14 +518,12 @@ DownloadEngine::popPooledSocket(const std::string& ipaddr, uint16_t port,
                                 const std::string& proxyhost,
                                 uint16_t proxyport)
 {
-  std::shared_ptr<SocketCore> s;
-  auto i = findSocketPoolEntry(
-      createSockPoolKey(ipaddr, port, A2STR::NIL, proxyhost, proxyport));
-  if (i != socketPool_.end()) {
-    s = (*i).second.getSocket();
-    socketPool_.erase(i);
+  SocketPoolEntry e(nullptr, 0_s);
+  if (popSocketPoolEntry(e, createSockPoolKey(ipaddr, port, A2STR::NIL,
+                                              proxyhost, proxyport))) {
+    return e.getSocket();
   }
-  return s;
+  return nullptr;
 }
 
 std::shared_ptr<SocketCore>
@@ -474,15 +532,13 @@ DownloadEngine::popPooledSocket(std::string& options, const std::string& ipaddr,
                                 const std::string& proxyhost,
                                 uint16_t proxyport)
 {
-  std::shared_ptr<SocketCore> s;
-  auto i = findSocketPoolEntry(
-      createSockPoolKey(ipaddr, port, username, proxyhost, proxyport));
-  if (i != socketPool_.end()) {
-    s = (*i).second.getSocket();
-    options = (*i).second.getOptions();
-    socketPool_.erase(i);
+  SocketPoolEntry e(nullptr, 0_s);
+  if (popSocketPoolEntry(
+          e, createSockPoolKey(ipaddr, port, username, proxyhost, proxyport))) {
+    options = e.getOptions();
+    return e.getSocket();
   }
-  return s;
+  return nullptr;
 }
 
 std::shared_ptr<SocketCore>
@@ -544,9 +600,22 @@ DownloadEngine::findCachedIPAddress(const std::string& hostname,
 }
 
 void DownloadEngine::cacheIPAddress(const std::string& hostname,
-                                    const std::string& ipaddr, uint16_t port)
+                                    const std::string& ipaddr, uint16_t port,
+                                    std::chrono::seconds ttl)
+{
+  dnsCache_->put(hostname, ipaddr, port, std::move(ttl));
+}
+
+void DownloadEngine::cacheHostNotFound(const std::string& hostname,
+                                       uint16_t port)
+{
+  dnsCache_->putNegative(hostname, port);
+}
+
+bool DownloadEngine::isHostNotFoundCached(const std::string& hostname,
+                                          uint16_t port) const
 {
-  dnsCache_->put(hostname, ipaddr, port);
+  return dnsCache_->isNegative(hostname, port);
 }
 
 void DownloadEngine::markBadIPAddress(const std::string& hostname,
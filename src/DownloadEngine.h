@@ -40,6 +40,7 @@
 #include <string>
 #include <deque>
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <memory>
 
@@ -119,8 +120,19 @@ private:
     const std::string& getOptions() const { return options_; }
   };
 
-  // key = IP address:port, value = SocketPoolEntry
-  std::multimap<std::string, SocketPoolEntry> socketPool_;
+  // key = IP address:port, value = SocketPoolEntry in the order of
+  // pooling; the most recently pooled one comes last.
+  typedef std::unordered_map<std::string, std::deque<SocketPoolEntry>>
+      SocketPool;
+  SocketPool socketPool_;
+
+  // The number of SocketPoolEntry in socketPool_
+  size_t socketPoolSize_;
+
+  // Statistics of socketPool_
+  uint64_t socketPoolHits_;
+  uint64_t socketPoolMisses_;
+  uint64_t socketPoolEvicted_;
 
   Timer lastSocketPoolScan_;
 
@@ -160,8 +172,10 @@ private:
 
   void poolSocket(const std::string& key, const SocketPoolEntry& entry);
 
-  std::multimap<std::string, SocketPoolEntry>::iterator
-  findSocketPoolEntry(const std::string& key);
+  // Removes the most recently pooled usable SocketPoolEntry for key
+  // from socketPool_ and stores it in entry.  Unusable entries found
+  // on the way are evicted.  Returns true if such entry is found.
+  bool popSocketPoolEntry(SocketPoolEntry& entry, const std::string& key);
 
   std::unique_ptr<RequestGroupMan> requestGroupMan_;
   std::unique_ptr<FileAllocationMan> fileAllocationMan_;
@@ -289,6 +303,14 @@ public:
 
   void evictSocketPool();
 
+  size_t getSocketPoolSize() const { return socketPoolSize_; }
+
+  uint64_t getSocketPoolHits() const { return socketPoolHits_; }
+
+  uint64_t getSocketPoolMisses() const { return socketPoolMisses_; }
+
+  uint64_t getSocketPoolEvicted() const { return socketPoolEvicted_; }
+
   const std::unique_ptr<CookieStorage>& getCookieStorage() const;
 
 #ifdef ENABLE_BITTORRENT
@@ -311,7 +333,14 @@ public:
   }
 
   void cacheIPAddress(const std::string& hostname, const std::string& ipaddr,
-                      uint16_t port);
+                      uint16_t port,
+                      std::chrono::seconds ttl = DNSCache::DEFAULT_TTL);
+
+  // Caches the fact that hostname does not exist.
+  void cacheHostNotFound(const std::string& hostname, uint16_t port);
+
+  // Returns true if hostname is cached as non-existent.
+  bool isHostNotFoundCached(const std::string& hostname, uint16_t port) const;
 
   void markBadIPAddress(const std::string& hostname, const std::string& ipaddr,
                         uint16_t port);
@@ -48,6 +48,8 @@
 #include "FillRequestGroupCommand.h"
 #include "FileAllocationDispatcherCommand.h"
 #include "AutoSaveCommand.h"
+#include "TuneConnectionCommand.h"
+#include "WrDiskCacheFlushCommand.h"
 #include "SaveSessionCommand.h"
 #include "HaveEraseCommand.h"
 #include "TimedHaltCommand.h"
@@ -156,9 +158,11 @@ std::unique_ptr<DownloadEngine> DownloadEngineFactory::newDownloadEngine(
     auto requestGroupMan = make_unique<RequestGroupMan>(
         std::move(requestGroups), MAX_CONCURRENT_DOWNLOADS, op);
     requestGroupMan->initWrDiskCache();
+    requestGroupMan->initRdDiskCache();
     e->setRequestGroupMan(std::move(requestGroupMan));
   }
-  e->setFileAllocationMan(make_unique<FileAllocationMan>());
+  e->setFileAllocationMan(make_unique<FileAllocationMan>(
+      op->getAsInt(PREF_MAX_CONCURRENT_FILE_ALLOCATIONS)));
   e->setCheckIntegrityMan(make_unique<CheckIntegrityMan>());
   e->addRoutineCommand(
       make_unique<FillRequestGroupCommand>(e->newCUID(), e.get()));
@@ -168,6 +172,12 @@ std::unique_ptr<DownloadEngine> DownloadEngineFactory::newDownloadEngine(
       e->newCUID(), e->getCheckIntegrityMan().get(), e.get()));
   e->addRoutineCommand(
       make_unique<EvictSocketPoolCommand>(e->newCUID(), e.get(), 30_s));
+  e->addRoutineCommand(
+      make_unique<TuneConnectionCommand>(e->newCUID(), e.get(), 5_s));
+  if (e->getRequestGroupMan()->getWrDiskCache()) {
+    e->addRoutineCommand(
+        make_unique<WrDiskCacheFlushCommand>(e->newCUID(), e.get(), 1_s));
+  }
 
   if (op->getAsInt(PREF_AUTO_SAVE_INTERVAL) > 0) {
     e->addRoutineCommand(make_unique<AutoSaveCommand>(
@@ -311,6 +311,129 @@ bool File::renameTo(const std::string& dest)
 #endif // !__MINGW32__
 }
 
+#ifndef __MINGW32__
+namespace {
+// Copies the data from the current offset of srcfd to dstfd.
+bool copyData(int srcfd, int dstfd)
+{
+#  ifdef HAVE_COPY_FILE_RANGE
+  // The data is copied inside the kernel, or shared between the files
+  // if the file system supports it.
+  bool copied = false;
+  for (;;) {
+    ssize_t r = copy_file_range(srcfd, nullptr, dstfd, nullptr, 1 << 30, 0);
+    if (r > 0) {
+      copied = true;
+      continue;
+    }
+    if (r == 0) {
+      return true;
+    }
+    if (errno == EINTR) {
+      continue;
+    }
+    // Older kernels and some file systems cannot copy between
+    // different file systems.
+    if (!copied && (errno == EXDEV || errno == ENOSYS || errno == EINVAL ||
+                    errno == EOPNOTSUPP)) {
+      break;
+    }
+    return false;
+  }
+#  endif // HAVE_COPY_FILE_RANGE
+  std::vector<unsigned char> buf(64 * 1024);
+  for (;;) {
+    ssize_t r;
+    while ((r = read(srcfd, buf.data(), buf.size())) == -1 && errno == EINTR)
+      ;
+    if (r == -1) {
+      return false;
+    }
+    if (r == 0) {
+      return true;
+    }
+    for (ssize_t off = 0; off < r;) {
+      ssize_t w;
+      while ((w = write(dstfd, buf.data() + off, r - off)) == -1 &&
+             errno == EINTR)
+        ;
+      if (w == -1) {
+        return false;
+      }
+      off += w;
+    }
+  }
+}
+} // namespace
+#endif // !__MINGW32__
+
+bool File::copyTo(const std::string& dest)
+{
+#ifdef __MINGW32__
+  // CopyFileW keeps the modification time.
+  return CopyFileW(utf8ToWChar(name_).c_str(), utf8ToWChar(dest).c_str(),
+                   FALSE);
+#else  // !__MINGW32__
+  int srcfd;
+  while ((srcfd = a2open(name_.c_str(), O_RDONLY | O_BINARY, OPEN_MODE)) ==
+             -1 &&
+         errno == EINTR)
+    ;
+  if (srcfd == -1) {
+    return false;
+  }
+  a2_struct_stat st;
+  int dstfd = -1;
+  if (a2fstat(srcfd, &st) == 0) {
+    while ((dstfd = a2open(dest.c_str(),
+                           O_CREAT | O_WRONLY | O_TRUNC | O_BINARY,
+                           OPEN_MODE)) == -1 &&
+           errno == EINTR)
+      ;
+  }
+  if (dstfd == -1) {
+    int errNum = errno;
+    close(srcfd);
+    errno = errNum;
+    return false;
+  }
+  bool rv = copyData(srcfd, dstfd);
+  int errNum = errno;
+  if (close(dstfd) == -1 && rv) {
+    rv = false;
+    errNum = errno;
+  }
+  close(srcfd);
+  if (!rv) {
+    File(dest).remove();
+    errno = errNum;
+    return false;
+  }
+  File(dest).utime(Time(st.st_atime), Time(st.st_mtime));
+  return true;
+#endif // !__MINGW32__
+}
+
+bool File::moveTo(const std::string& dest)
+{
+  if (renameTo(dest)) {
+    return true;
+  }
+#ifndef __MINGW32__
+  // MinGW's renameTo() already copies the file to another volume.
+  if (errno == EXDEV && copyTo(dest)) {
+    if (remove()) {
+      name_ = dest;
+      return true;
+    }
+    int errNum = errno;
+    File(dest).remove();
+    errno = errNum;
+  }
+#endif // !__MINGW32__
+  return false;
+}
+
 bool File::utime(const Time& actime, const Time& modtime) const
 {
 #if defined(HAVE_UTIMES) && !defined(__MINGW32__)
@@ -116,6 +116,14 @@ public:
 
   bool renameTo(const std::string& dest);
 
+  // Copies the contents of this file to |dest|, keeping its
+  // modification time.  |dest| is replaced if it exists.
+  bool copyTo(const std::string& dest);
+
+  // Renames this file to |dest|.  If |dest| is on another file
+  // system, the file is copied and then removed.
+  bool moveTo(const std::string& dest);
+
   bool utime(const Time& actime, const Time& modtime) const;
 
   Time getModifiedTime();
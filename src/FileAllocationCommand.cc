@@ -62,7 +62,8 @@ FileAllocationCommand::FileAllocationCommand(
 
 FileAllocationCommand::~FileAllocationCommand()
 {
-  getDownloadEngine()->getFileAllocationMan()->dropPickedEntry();
+  getDownloadEngine()->getFileAllocationMan()->dropPickedEntry(
+      fileAllocationEntry_);
 }
 
 bool FileAllocationCommand::executeInternal()
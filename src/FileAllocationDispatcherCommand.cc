@@ -35,6 +35,8 @@
 #include "FileAllocationDispatcherCommand.h"
 #include "FileAllocationEntry.h"
 #include "FileAllocationCommand.h"
+#include "DownloadEngine.h"
+#include "RequestGroupMan.h"
 #include "message.h"
 #include "Logger.h"
 #include "LogFactory.h"
@@ -45,17 +47,33 @@ namespace aria2 {
 
 FileAllocationDispatcherCommand::FileAllocationDispatcherCommand(
     cuid_t cuid, FileAllocationMan* fileAllocMan, DownloadEngine* e)
-    : SequentialDispatcherCommand<FileAllocationEntry>{cuid, fileAllocMan, e}
+    : Command{cuid}, fileAllocMan_{fileAllocMan}, e_{e}
 {
+  setStatusRealtime();
+}
+
+bool FileAllocationDispatcherCommand::execute()
+{
+  if (e_->getRequestGroupMan()->downloadFinished() || e_->isHaltRequested()) {
+    return true;
+  }
+  while (fileAllocMan_->hasNext() && fileAllocMan_->canPick()) {
+    e_->addCommand(createCommand(fileAllocMan_->pickNext()));
+
+    e_->setNoWait(true);
+  }
+
+  e_->addRoutineCommand(std::unique_ptr<Command>(this));
+  return false;
 }
 
 std::unique_ptr<Command>
 FileAllocationDispatcherCommand::createCommand(FileAllocationEntry* entry)
 {
-  cuid_t newCUID = getDownloadEngine()->newCUID();
+  cuid_t newCUID = e_->newCUID();
   A2_LOG_INFO(fmt(MSG_FILE_ALLOCATION_DISPATCH, newCUID));
   return make_unique<FileAllocationCommand>(newCUID, entry->getRequestGroup(),
-                                            getDownloadEngine(), entry);
+                                            e_, entry);
 }
 
 } // namespace aria2
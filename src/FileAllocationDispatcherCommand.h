@@ -35,22 +35,32 @@
 #ifndef D_FILE_ALLOCATION_DISPATCHER_COMMAND_H
 #define D_FILE_ALLOCATION_DISPATCHER_COMMAND_H
 
-#include "SequentialDispatcherCommand.h"
+#include "Command.h"
+
+#include <memory>
+
 #include "FileAllocationMan.h"
 
 namespace aria2 {
 
+class DownloadEngine;
 class FileAllocationEntry;
 
-class FileAllocationDispatcherCommand
-    : public SequentialDispatcherCommand<FileAllocationEntry> {
+// Starts FileAllocationCommands for the queued entries, as many as
+// FileAllocationMan allows at the same time.
+class FileAllocationDispatcherCommand : public Command {
+private:
+  FileAllocationMan* fileAllocMan_;
+
+  DownloadEngine* e_;
+
+  std::unique_ptr<Command> createCommand(FileAllocationEntry* entry);
+
 public:
   FileAllocationDispatcherCommand(cuid_t cuid, FileAllocationMan* fileAllocMan,
                                   DownloadEngine* e);
 
-protected:
-  virtual std::unique_ptr<Command>
-  createCommand(FileAllocationEntry* entry) CXX11_OVERRIDE;
+  virtual bool execute() CXX11_OVERRIDE;
 };
 
 } // namespace aria2
@@ -0,0 +1,209 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "FileCopier.h"
+
+#include <cerrno>
+
+#include "File.h"
+#include "TimeA2.h"
+#include "DlAbortEx.h"
+#include "message.h"
+#include "util.h"
+#include "a2io.h"
+#include "fmt.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+namespace {
+constexpr size_t CHUNK_SIZE = 1_m;
+} // namespace
+
+FileCopier::FileCopier(std::string srcPath, std::string destPath)
+    : srcPath_(std::move(srcPath)),
+      destPath_(std::move(destPath)),
+      srcfd_(-1),
+      destfd_(-1),
+      offset_(0),
+      created_(false),
+      finished_(false),
+      copyFileRange_(true)
+{
+}
+
+FileCopier::~FileCopier()
+{
+  closeFile();
+  if (created_ && !finished_) {
+    File(destPath_).remove();
+  }
+}
+
+namespace {
+int openFileWithFlags(const std::string& filename, int flags)
+{
+  int fd;
+  while ((fd = a2open(utf8ToWChar(filename).c_str(), flags, OPEN_MODE)) ==
+             -1 &&
+         errno == EINTR)
+    ;
+  if (fd == -1) {
+    int errNum = errno;
+    throw DL_ABORT_EX3(
+        errNum,
+        fmt(EX_FILE_OPEN, filename.c_str(), util::safeStrerror(errNum).c_str()),
+        error_code::FILE_OPEN_ERROR);
+  }
+  return fd;
+}
+
+void throwFileError(const char* format, const std::string& filename,
+                    int errNum)
+{
+  throw DL_ABORT_EX3(
+      errNum, fmt(format, filename.c_str(), util::safeStrerror(errNum).c_str()),
+      error_code::FILE_IO_ERROR);
+}
+} // namespace
+
+void FileCopier::openFile()
+{
+  srcfd_ = openFileWithFlags(srcPath_, O_RDONLY | O_BINARY);
+  destfd_ =
+      openFileWithFlags(destPath_, O_CREAT | O_WRONLY | O_TRUNC | O_BINARY);
+  created_ = true;
+}
+
+void FileCopier::closeFile()
+{
+  if (srcfd_ != -1) {
+    close(srcfd_);
+    srcfd_ = -1;
+  }
+  if (destfd_ != -1) {
+    close(destfd_);
+    destfd_ = -1;
+  }
+}
+
+void FileCopier::copyChunk()
+{
+  if (finished_) {
+    return;
+  }
+  if (srcfd_ == -1) {
+    openFile();
+  }
+  ssize_t r = -1;
+#ifdef HAVE_COPY_FILE_RANGE
+  if (copyFileRange_) {
+    // The data is copied inside the kernel, or shared between the
+    // files if the file system supports it.
+    while ((r = copy_file_range(srcfd_, nullptr, destfd_, nullptr, CHUNK_SIZE,
+                                0)) == -1 &&
+           errno == EINTR)
+      ;
+    if (r == -1) {
+      int errNum = errno;
+      // Older kernels and some file systems cannot copy between
+      // different file systems.
+      if (offset_ != 0 || (errNum != EXDEV && errNum != ENOSYS &&
+                           errNum != EINVAL && errNum != EOPNOTSUPP)) {
+        throwFileError(EX_FILE_WRITE, destPath_, errNum);
+      }
+      copyFileRange_ = false;
+    }
+  }
+#endif // HAVE_COPY_FILE_RANGE
+  if (r == -1) {
+    buf_.resize(CHUNK_SIZE);
+    while ((r = read(srcfd_, buf_.data(), buf_.size())) == -1 &&
+           errno == EINTR)
+      ;
+    if (r == -1) {
+      throwFileError(EX_FILE_READ, srcPath_, errno);
+    }
+    for (ssize_t off = 0; off < r;) {
+      ssize_t w;
+      while ((w = write(destfd_, buf_.data() + off, r - off)) == -1 &&
+             errno == EINTR)
+        ;
+      if (w == -1) {
+        throwFileError(EX_FILE_WRITE, destPath_, errno);
+      }
+      off += w;
+    }
+  }
+  if (r > 0) {
+    offset_ += r;
+    return;
+  }
+  a2_struct_stat st;
+  bool stOk = a2fstat(srcfd_, &st) == 0;
+  close(srcfd_);
+  srcfd_ = -1;
+#ifndef __MINGW32__
+  if (stOk) {
+    fchmod(destfd_, st.st_mode & 07777);
+  }
+#endif // !__MINGW32__
+  // The caller removes the source after this, so the copy must be on
+  // the disk first.
+  int rv;
+#ifdef __MINGW32__
+  rv = _commit(destfd_);
+#elif defined(HAVE_FDATASYNC)
+  rv = fdatasync(destfd_);
+#else  // !HAVE_FDATASYNC
+  rv = fsync(destfd_);
+#endif // !HAVE_FDATASYNC
+  if (rv == -1) {
+    int errNum = errno;
+    close(destfd_);
+    destfd_ = -1;
+    throwFileError(EX_FILE_WRITE, destPath_, errNum);
+  }
+  rv = close(destfd_);
+  destfd_ = -1;
+  if (rv == -1) {
+    throwFileError(EX_FILE_WRITE, destPath_, errno);
+  }
+  if (stOk) {
+    File(destPath_).utime(Time(st.st_atime), Time(st.st_mtime));
+  }
+  finished_ = true;
+}
+
+} // namespace aria2
@@ -0,0 +1,89 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_FILE_COPIER_H
+#define D_FILE_COPIER_H
+
+#include "common.h"
+
+#include <string>
+#include <vector>
+
+namespace aria2 {
+
+// Copies a file to another path chunk by chunk, so that a large file
+// can be copied to another file system without blocking the event
+// loop.  The copy keeps the permission bits and the modification
+// time of the source, and is flushed to the disk when it finishes.
+// If the copy is not finished when this object is destroyed, the
+// partial destination file is removed.
+class FileCopier {
+public:
+  FileCopier(std::string srcPath, std::string destPath);
+  ~FileCopier();
+
+  // Copies the next chunk.  The files are opened by the first call.
+  // Throws DlAbortEx on error.
+  void copyChunk();
+
+  bool finished() const { return finished_; }
+
+  const std::string& getSrcPath() const { return srcPath_; }
+
+  const std::string& getDestPath() const { return destPath_; }
+
+  int64_t getCurrentLength() const { return offset_; }
+
+private:
+  void openFile();
+
+  void closeFile();
+
+  std::string srcPath_;
+  std::string destPath_;
+  int srcfd_;
+  int destfd_;
+  int64_t offset_;
+  // True after the destination file is created.
+  bool created_;
+  bool finished_;
+  // False once copy_file_range() turns out to be unusable for these
+  // files.
+  bool copyFileRange_;
+  std::vector<unsigned char> buf_;
+};
+
+} // namespace aria2
+
+#endif // D_FILE_COPIER_H
@@ -75,7 +75,8 @@ FileEntry::FileEntry(std::string path, int64_t length, int64_t offset,
       lastFasterReplace_(Timer::zero()),
       maxConnectionPerServer_(1),
       requested_(true),
-      uniqueProtocol_(false)
+      uniqueProtocol_(false),
+      padFile_(false)
 {
 }
 
@@ -84,7 +85,8 @@ FileEntry::FileEntry()
       offset_(0),
       maxConnectionPerServer_(1),
       requested_(false),
-      uniqueProtocol_(false)
+      uniqueProtocol_(false),
+      padFile_(false)
 {
 }
 
@@ -94,6 +94,9 @@ private:
 
   bool requested_;
   bool uniqueProtocol_;
+  // true if this is a BitTorrent pad file (BEP 47), which is filled
+  // with zeros and never written to the disk.
+  bool padFile_;
 
   void storePool(const std::shared_ptr<Request>& request);
 
@@ -133,6 +136,10 @@ public:
 
   void setRequested(bool flag) { requested_ = flag; }
 
+  bool isPadFile() const { return padFile_; }
+
+  void setPadFile(bool flag) { padFile_ = flag; }
+
   const std::deque<std::string>& getRemainingUris() const { return uris_; }
 
   std::deque<std::string>& getRemainingUris() { return uris_; }
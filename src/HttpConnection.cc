@@ -35,6 +35,7 @@
 #include "HttpConnection.h"
 
 #include <sstream>
+#include <algorithm>
 
 #include "util.h"
 #include "message.h"
@@ -64,7 +65,8 @@ namespace aria2 {
 HttpRequestEntry::HttpRequestEntry(std::unique_ptr<HttpRequest> httpRequest)
     : httpRequest_{std::move(httpRequest)},
       proc_{
-          make_unique<HttpHeaderProcessor>(HttpHeaderProcessor::CLIENT_PARSER)}
+          make_unique<HttpHeaderProcessor>(HttpHeaderProcessor::CLIENT_PARSER)},
+      pipelined_{false}
 {
 }
 
@@ -90,7 +92,9 @@ HttpConnection::HttpConnection(
     : cuid_(cuid),
       socket_(socket),
       socketRecvBuffer_(socketRecvBuffer),
-      socketBuffer_(socket)
+      socketBuffer_(socket),
+      rtt_(0),
+      numResponses_(0)
 {
 }
 
@@ -129,8 +133,9 @@ void HttpConnection::sendRequest(std::unique_ptr<HttpRequest> httpRequest,
       fmt(MSG_SENDING_REQUEST, cuid_, eraseConfidentialInfo(request).c_str()));
   socketBuffer_.pushStr(std::move(request));
   socketBuffer_.send();
-  outstandingHttpRequests_.push_back(
-      make_unique<HttpRequestEntry>(std::move(httpRequest)));
+  auto entry = make_unique<HttpRequestEntry>(std::move(httpRequest));
+  entry->setPipelined(!outstandingHttpRequests_.empty());
+  outstandingHttpRequests_.push_back(std::move(entry));
 }
 
 void HttpConnection::sendRequest(std::unique_ptr<HttpRequest> httpRequest)
@@ -169,6 +174,13 @@ std::unique_ptr<HttpResponse> HttpConnection::receiveResponse()
       return nullptr;
     }
 
+    const auto& entry = outstandingHttpRequests_.front();
+    if (!entry->isPipelined()) {
+      // The response to a pipelined request also waits for the
+      // previous responses, so only the others tell the RTT.
+      rtt_ = std::chrono::duration_cast<std::chrono::milliseconds>(
+          entry->getSentTime().difference());
+    }
     auto httpResponse = make_unique<HttpResponse>();
     httpResponse->setCuid(cuid_);
     httpResponse->setHttpHeader(std::move(result));
@@ -176,6 +188,7 @@ std::unique_ptr<HttpResponse> HttpConnection::receiveResponse()
         outstandingHttpRequests_.front()->popHttpRequest());
     socketRecvBuffer_->drain(proc->getLastBytesProcessed());
     outstandingHttpRequests_.pop_front();
+    ++numResponses_;
     return httpResponse;
   }
 
@@ -193,6 +206,41 @@ bool HttpConnection::isIssued(const std::shared_ptr<Segment>& segment) const
   return false;
 }
 
+bool HttpConnection::isPipelinedResponsePending() const
+{
+  return !outstandingHttpRequests_.empty() &&
+         outstandingHttpRequests_.front()->isPipelined();
+}
+
+bool HttpConnection::isPipelinedRequestIgnored() const
+{
+  return isPipelinedResponsePending() && numResponses_ == 1 &&
+         socketRecvBuffer_->bufferEmpty() &&
+         outstandingHttpRequests_.front()
+             ->getHttpHeaderProcessor()
+             ->getHeaderString()
+             .empty();
+}
+
+int HttpConnection::calculatePipeliningDepth(int64_t segmentLength,
+                                             int downloadSpeed,
+                                             int maxDepth) const
+{
+  if (maxDepth <= 2) {
+    return std::max(1, maxDepth);
+  }
+  if (rtt_.count() == 0 || segmentLength <= 0) {
+    return 2;
+  }
+  // Bytes which arrive during one round trip must be covered by the
+  // requests queued behind the one being downloaded.
+  auto bytesInFlight =
+      static_cast<int64_t>(downloadSpeed) * rtt_.count() / 1000;
+  auto depth = 1 + (bytesInFlight + segmentLength - 1) / segmentLength;
+  return std::max(static_cast<int64_t>(2),
+                  std::min(depth, static_cast<int64_t>(maxDepth)));
+}
+
 bool HttpConnection::sendBufferIsEmpty() const
 {
   return socketBuffer_.sendBufferIsEmpty();
@@ -40,9 +40,11 @@
 #include <string>
 #include <deque>
 #include <memory>
+#include <chrono>
 
 #include "SocketBuffer.h"
 #include "Command.h"
+#include "TimerA2.h"
 
 namespace aria2 {
 
@@ -58,6 +60,11 @@ class HttpRequestEntry {
 private:
   std::unique_ptr<HttpRequest> httpRequest_;
   std::unique_ptr<HttpHeaderProcessor> proc_;
+  // The time when the request was sent.
+  Timer sentTime_;
+  // true if the request was sent while other requests were still
+  // waiting for their responses.
+  bool pipelined_;
 
 public:
   HttpRequestEntry(std::unique_ptr<HttpRequest> httpRequest);
@@ -74,6 +81,12 @@ public:
   std::unique_ptr<HttpRequest> popHttpRequest();
 
   const std::unique_ptr<HttpHeaderProcessor>& getHttpHeaderProcessor() const;
+
+  const Timer& getSentTime() const { return sentTime_; }
+
+  bool isPipelined() const { return pipelined_; }
+
+  void setPipelined(bool pipelined) { pipelined_ = pipelined; }
 };
 
 typedef std::deque<std::unique_ptr<HttpRequestEntry>> HttpRequestEntries;
@@ -87,6 +100,13 @@ private:
 
   HttpRequestEntries outstandingHttpRequests_;
 
+  // Round trip time measured from the last request which was not
+  // pipelined.  0 means no sample yet.
+  std::chrono::milliseconds rtt_;
+
+  // The number of responses received on this connection.
+  int numResponses_;
+
   std::string eraseConfidentialInfo(const std::string& request);
   void sendRequest(std::unique_ptr<HttpRequest> httpRequest,
                    std::string request);
@@ -125,6 +145,29 @@ public:
 
   bool isIssued(const std::shared_ptr<Segment>& segment) const;
 
+  // Returns true if the response to be received next is for a
+  // request which was sent while other requests were outstanding.
+  bool isPipelinedResponsePending() const;
+
+  // Returns true if the response to be received next is for a
+  // pipelined request, nothing of it has been received, and the
+  // server has answered only the first request of this connection.
+  // If receiving the response fails in this state, the server
+  // ignores pipelined requests.  Other failures may be transient.
+  bool isPipelinedRequestIgnored() const;
+
+  const std::chrono::milliseconds& getRTT() const { return rtt_; }
+
+  void setRTT(std::chrono::milliseconds rtt) { rtt_ = std::move(rtt); }
+
+  // Returns the number of requests which should be kept in flight so
+  // that the connection does not sit idle for a round trip between
+  // segments of segmentLength bytes downloaded at downloadSpeed.  The
+  // result is at least 2 and at most maxDepth.  If no RTT is known
+  // yet, returns 2.  If maxDepth is less than 2, returns 1.
+  int calculatePipeliningDepth(int64_t segmentLength, int downloadSpeed,
+                               int maxDepth) const;
+
   bool sendBufferIsEmpty() const;
 
   void sendPendingData();
@@ -52,6 +52,7 @@
 #include "StreamFilter.h"
 #include "SinkStreamFilter.h"
 #include "util.h"
+#include "PeerStat.h"
 #include "SocketRecvBuffer.h"
 
 namespace aria2 {
@@ -67,6 +68,7 @@ HttpDownloadCommand::HttpDownloadCommand(
       httpResponse_(std::move(httpResponse)),
       httpConnection_(httpConnection)
 {
+  req->getPeerStat()->setRTT(httpConnection_->getRTT());
 }
 
 HttpDownloadCommand::~HttpDownloadCommand() = default;
@@ -75,6 +77,11 @@ bool HttpDownloadCommand::prepareForNextSegment()
 {
   bool downloadFinished = getRequestGroup()->downloadFinished();
   if (getRequest()->isPipeliningEnabled() && !downloadFinished) {
+    if (getRequestGroup()->shouldShedConnection(getCuid())) {
+      // Responses to the pipelined requests may still arrive, so the
+      // socket is not pooled.
+      return prepareForRetry(0);
+    }
     auto command = make_unique<HttpRequestCommand>(
         getCuid(), getRequest(), getFileEntry(), getRequestGroup(),
         httpConnection_, getDownloadEngine(), getSocket());
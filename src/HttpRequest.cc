@@ -181,11 +181,23 @@ std::string HttpRequest::createRequest()
   builtinHds.emplace_back("Accept:", acceptTypes);
   if (contentEncodingEnabled_) {
     std::string acceptableEncodings;
-#ifdef HAVE_ZLIB
     if (acceptGzip_) {
+#ifdef HAVE_ZLIB
       acceptableEncodings += "deflate, gzip";
-    }
 #endif // HAVE_ZLIB
+#ifdef HAVE_LIBBROTLI
+      if (!acceptableEncodings.empty()) {
+        acceptableEncodings += ", ";
+      }
+      acceptableEncodings += "br";
+#endif // HAVE_LIBBROTLI
+#ifdef HAVE_LIBZSTD
+      if (!acceptableEncodings.empty()) {
+        acceptableEncodings += ", ";
+      }
+      acceptableEncodings += "zstd";
+#endif // HAVE_LIBZSTD
+    }
     if (!acceptableEncodings.empty()) {
       builtinHds.emplace_back("Accept-Encoding:", acceptableEncodings);
     }
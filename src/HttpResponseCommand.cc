@@ -51,6 +51,7 @@
 #include "DefaultBtProgressInfoFile.h"
 #include "DownloadFailureException.h"
 #include "DlAbortEx.h"
+#include "RecoverableException.h"
 #include "util.h"
 #include "File.h"
 #include "Option.h"
@@ -73,6 +74,8 @@
 #include "ChunkedDecodingStreamFilter.h"
 #include "uri.h"
 #include "SocketRecvBuffer.h"
+#include "ServerStat.h"
+#include "PeerStat.h"
 #include "MetalinkHttpEntry.h"
 #include "NullProgressInfoFile.h"
 #include "Checksum.h"
@@ -80,6 +83,12 @@
 #ifdef HAVE_ZLIB
 #  include "GZipDecodingStreamFilter.h"
 #endif // HAVE_ZLIB
+#ifdef HAVE_LIBBROTLI
+#  include "BrotliDecodingStreamFilter.h"
+#endif // HAVE_LIBBROTLI
+#ifdef HAVE_LIBZSTD
+#  include "ZstdDecodingStreamFilter.h"
+#endif // HAVE_LIBZSTD
 
 namespace aria2 {
 
@@ -143,7 +152,28 @@ HttpResponseCommand::~HttpResponseCommand() = default;
 
 bool HttpResponseCommand::executeInternal()
 {
-  auto httpResponse = httpConnection_->receiveResponse();
+  // Must be checked before the response is taken off the queue.
+  bool pipelined = httpConnection_->isPipelinedResponsePending();
+  std::unique_ptr<HttpResponse> httpResponse;
+  try {
+    httpResponse = httpConnection_->receiveResponse();
+  }
+  catch (RecoverableException& e) {
+    if (pipelined) {
+      if (httpConnection_->isPipelinedRequestIgnored()) {
+        // The server closed the connection after answering only the
+        // first request.
+        disablePipelining();
+      }
+      else {
+        // e.g., the connection was reset in the middle of the
+        // response.  Retry without pipelining, but don't blame the
+        // server.
+        getRequest()->suspendPipelining();
+      }
+    }
+    throw;
+  }
   if (!httpResponse) {
     // The server has not responded to our request yet.
     // For socket->wantRead() == true, setReadCheckSocket(socket) is already
@@ -154,7 +184,18 @@ bool HttpResponseCommand::executeInternal()
   }
 
   // check HTTP status code
-  httpResponse->validateResponse();
+  try {
+    httpResponse->validateResponse();
+  }
+  catch (RecoverableException& e) {
+    // CANNOT_RESUME means that the range does not match the request:
+    // the server answered the pipelined requests in the wrong order,
+    // or answered another request.
+    if (pipelined && e.getErrorCode() == error_code::CANNOT_RESUME) {
+      disablePipelining();
+    }
+    throw;
+  }
   httpResponse->retrieveCookie();
 
   const auto& httpHeader = httpResponse->getHttpHeader();
@@ -165,8 +206,7 @@ bool HttpResponseCommand::executeInternal()
   req->supportsPersistentConnection(
       httpResponse->supportsPersistentConnection());
   if (req->isPipeliningEnabled()) {
-    req->setMaxPipelinedRequest(
-        getOption()->getAsInt(PREF_MAX_HTTP_PIPELINING));
+    updatePipeliningDepth(pipelined);
   }
   else {
     req->setMaxPipelinedRequest(1);
@@ -345,7 +385,7 @@ bool HttpResponseCommand::shouldInflateContentEncoding(
   // implementation just inflates these files nonetheless.
   const std::string& ce = httpResponse->getContentEncoding();
   return httpResponse->getHttpRequest()->acceptGZip() &&
-         (ce == "gzip" || ce == "deflate");
+         (ce == "gzip" || ce == "deflate" || ce == "br" || ce == "zstd");
 }
 
 bool HttpResponseCommand::handleDefaultEncoding(
@@ -517,16 +557,26 @@ namespace {
 
 bool decideFileAllocation(StreamFilter* filter)
 {
-#ifdef HAVE_ZLIB
   for (StreamFilter* f = filter; f; f = f->getDelegate().get()) {
     // Since the compressed file's length are returned in the response header
     // and the decompressed file size is unknown at this point, disable file
     // allocation here.
+#ifdef HAVE_ZLIB
     if (f->getName() == GZipDecodingStreamFilter::NAME) {
       return false;
     }
-  }
 #endif // HAVE_ZLIB
+#ifdef HAVE_LIBBROTLI
+    if (f->getName() == BrotliDecodingStreamFilter::NAME) {
+      return false;
+    }
+#endif // HAVE_LIBBROTLI
+#ifdef HAVE_LIBZSTD
+    if (f->getName() == ZstdDecodingStreamFilter::NAME) {
+      return false;
+    }
+#endif // HAVE_LIBZSTD
+  }
 
   return true;
 }
@@ -566,6 +616,53 @@ void HttpResponseCommand::poolConnection()
   }
 }
 
+void HttpResponseCommand::updatePipeliningDepth(bool pipelined)
+{
+  auto& req = getRequest();
+  auto ss = getDownloadEngine()->getRequestGroupMan()->getOrCreateServerStat(
+      req->getHost(), req->getProtocol());
+  if (ss->isPipeliningBroken()) {
+    req->setPipeliningHint(false);
+    req->setMaxPipelinedRequest(1);
+    return;
+  }
+  if (pipelined) {
+    ss->updatePipeliningDepth(req->getMaxPipelinedRequest());
+  }
+  int speed = 0;
+  if (req->getPeerStat()) {
+    speed = req->getPeerStat()->calculateDownloadSpeed();
+  }
+  if (speed == 0) {
+    speed = ss->getDownloadSpeed();
+  }
+  int depth = httpConnection_->calculatePipeliningDepth(
+      getDownloadContext()->getPieceLength(), speed,
+      getOption()->getAsInt(PREF_MAX_HTTP_PIPELINING));
+  // Grow at most twice the depth the server has already handled, so
+  // that a server which cannot cope with deep pipelines is caught
+  // before many requests are lost.
+  int proven =
+      std::max(req->getMaxPipelinedRequest(), ss->getPipeliningDepth());
+  depth = std::min(depth, std::max(2, proven * 2));
+  if (depth != req->getMaxPipelinedRequest()) {
+    A2_LOG_DEBUG(fmt("CUID#%" PRId64 " - HTTP pipelining depth=%d, RTT=%ldms",
+                     getCuid(), depth,
+                     static_cast<long>(httpConnection_->getRTT().count())));
+  }
+  req->setMaxPipelinedRequest(depth);
+}
+
+void HttpResponseCommand::disablePipelining()
+{
+  auto& req = getRequest();
+  getDownloadEngine()
+      ->getRequestGroupMan()
+      ->getOrCreateServerStat(req->getHost(), req->getProtocol())
+      ->setPipeliningBroken();
+  req->setPipeliningHint(false);
+}
+
 void HttpResponseCommand::onDryRunFileFound()
 {
   getPieceStorage()->markAllPiecesDone();
@@ -73,6 +73,14 @@ private:
 
   void poolConnection();
 
+  // Chooses the number of pipelined requests for the next round.
+  // pipelined is true if the response just received was for a
+  // pipelined request.
+  void updatePipeliningDepth(bool pipelined);
+
+  // Records that the server mishandled pipelined requests.
+  void disablePipelining();
+
   void onDryRunFileFound();
   // Returns true if dctx and checksum has same hash type and hash
   // value.  If they have same hash type but different hash value,
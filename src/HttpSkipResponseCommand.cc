@@ -60,6 +60,7 @@
 #include "SinkStreamFilter.h"
 #include "error_code.h"
 #include "SocketRecvBuffer.h"
+#include "RequestGroup.h"
 
 namespace aria2 {
 
@@ -203,6 +204,10 @@ bool HttpSkipResponseCommand::processResponse()
 
   auto statusCode = httpResponse_->getStatusCode();
   if (statusCode >= 400) {
+    if (statusCode == 429 || statusCode == 503) {
+      // The server asks us to back off.
+      getRequestGroup()->notifyServerBusy();
+    }
     switch (statusCode) {
     case 401:
       if (getOption()->getAsBool(PREF_HTTP_AUTH_CHALLENGE) &&
@@ -220,6 +225,7 @@ bool HttpSkipResponseCommand::processResponse()
       }
       throw DL_RETRY_EX2(MSG_RESOURCE_NOT_FOUND,
                          error_code::RESOURCE_NOT_FOUND);
+    case 429: // Too Many Requests
     case 502:
     case 503:
       // Only retry if pretry-wait > 0. Hammering 'busy' server is not
@@ -38,6 +38,8 @@
 #include "Request.h"
 #include "RequestGroup.h"
 #include "DownloadEngine.h"
+#include "RequestGroupMan.h"
+#include "ServerStat.h"
 #include "DlAbortEx.h"
 #include "fmt.h"
 #include "Option.h"
@@ -64,7 +66,16 @@ InitiateConnectionCommandFactory::createInitiateConnectionCommand(
       req->setKeepAliveHint(true);
     }
     if (requestGroup->getOption()->getAsBool(PREF_ENABLE_HTTP_PIPELINING)) {
-      req->setPipeliningHint(true);
+      auto ss = e->getRequestGroupMan()->findServerStat(req->getHost(),
+                                                        req->getProtocol());
+      // Don't pipeline again to the server which mishandled it.  After
+      // a transient failure, one connection goes without pipelining.
+      if (req->isPipeliningSuspended()) {
+        req->setPipeliningSuspended(false);
+      }
+      else if (!ss || !ss->isPipeliningBroken()) {
+        req->setPipeliningHint(true);
+      }
     }
 
     return make_unique<HttpInitiateConnectionCommand>(cuid, req, fileEntry,
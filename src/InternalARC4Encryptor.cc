@@ -44,7 +44,7 @@ void ARC4Encryptor::init(const unsigned char* key, size_t keyLength)
     c = j++;
 
   j = 0;
-  for (i = 0; i < sizeof(state_); ++i) {
+  for (i = 0; i < 256; ++i) {
     j = (j + state_[i] + key[i % keyLength]) & 0xff;
     auto tmp = state_[i];
     state_[i] = state_[j];
@@ -56,14 +56,39 @@ void ARC4Encryptor::init(const unsigned char* key, size_t keyLength)
 void ARC4Encryptor::encrypt(size_t len, unsigned char* out,
                             const unsigned char* in)
 {
-  for (auto c = 0u; c < len; ++c) {
-    i = (i + 1) & 0xff;
-    j = (j + state_[i]) & 0xff;
-    auto sj = state_[i];
-    auto si = state_[i] = state_[j];
-    state_[j] = sj;
-    out[c] = in[c] ^ state_[(si + sj) & 0xff];
+  // Work on local copies of the indices so that the compiler can keep
+  // them in registers, and let uint8_t arithmetic do the modulo 256.
+  auto s = state_;
+  uint8_t ii = i;
+  uint8_t jj = j;
+  auto next = [s, &ii, &jj]() {
+    ++ii;
+    auto si = s[ii];
+    jj += si;
+    auto sj = s[jj];
+    s[ii] = sj;
+    s[jj] = si;
+    return s[static_cast<uint8_t>(si + sj)];
+  };
+  size_t c = 0;
+  // Generating key stream is inherently serial, but unrolling lets
+  // the loads of the next round overlap with the XOR of the previous
+  // ones.
+  for (; c + 4 <= len; c += 4) {
+    auto k0 = next();
+    auto k1 = next();
+    auto k2 = next();
+    auto k3 = next();
+    out[c] = in[c] ^ k0;
+    out[c + 1] = in[c + 1] ^ k1;
+    out[c + 2] = in[c + 2] ^ k2;
+    out[c + 3] = in[c + 3] ^ k3;
   }
+  for (; c < len; ++c) {
+    out[c] = in[c] ^ next();
+  }
+  i = ii;
+  j = jj;
 }
 
 } // namespace aria2
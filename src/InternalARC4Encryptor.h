@@ -41,7 +41,10 @@ namespace aria2 {
 
 class ARC4Encryptor {
 private:
-  unsigned char state_[256];
+  // Each element holds a byte value.  Wider elements avoid partial
+  // register stalls on byte loads and stores, which makes encryption
+  // considerably faster on common CPUs.
+  uint32_t state_[256];
   unsigned i, j;
 
 public:
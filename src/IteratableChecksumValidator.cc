@@ -35,6 +35,7 @@
 #include "IteratableChecksumValidator.h"
 
 #include <array>
+#include <algorithm>
 #include <cstdlib>
 
 #include "util.h"
@@ -59,14 +60,29 @@ IteratableChecksumValidator::IteratableChecksumValidator(
 
 IteratableChecksumValidator::~IteratableChecksumValidator() = default;
 
+namespace {
+// The length of data hashed at once if the file is memory mapped.
+const size_t MAPPED_CHUNK_LENGTH = 256_k;
+} // namespace
+
 void IteratableChecksumValidator::validateChunk()
 {
   // Don't guard with !finished() to allow zero-length file to be
   // verified.
-  std::array<unsigned char, 4_k> buf;
-  size_t length = pieceStorage_->getDiskAdaptor()->readDataDropCache(
-      buf.data(), buf.size(), currentOffset_);
-  ctx_->update(buf.data(), length);
+  auto diskAdaptor = pieceStorage_->getDiskAdaptor();
+  auto length = static_cast<size_t>(
+      std::min(static_cast<int64_t>(MAPPED_CHUNK_LENGTH),
+               dctx_->getTotalLength() - currentOffset_));
+  auto data = diskAdaptor->getMappedData(length, currentOffset_);
+  if (data) {
+    ctx_->update(data, length);
+  }
+  else {
+    std::array<unsigned char, 4_k> buf;
+    length = diskAdaptor->readDataDropCache(buf.data(), buf.size(),
+                                            currentOffset_);
+    ctx_->update(buf.data(), length);
+  }
   currentOffset_ += length;
   if (finished()) {
     std::string actualDigest = ctx_->digest();
@@ -127,8 +127,13 @@ void IteratableChunkChecksumValidator::init()
 std::string IteratableChunkChecksumValidator::digest(int64_t offset,
                                                      size_t length)
 {
-  std::array<unsigned char, 4_k> buf;
   ctx_->reset();
+  auto data = pieceStorage_->getDiskAdaptor()->getMappedData(length, offset);
+  if (data) {
+    ctx_->update(data, length);
+    return ctx_->digest();
+  }
+  std::array<unsigned char, 4_k> buf;
   int64_t max = offset + length;
   while (offset < max) {
     size_t r = pieceStorage_->getDiskAdaptor()->readDataDropCache(
@@ -80,6 +80,18 @@ GnuTLSContext::~GnuTLSContext()
 
 bool GnuTLSContext::good() const { return good_; }
 
+bool GnuTLSContext::setKTLS(bool enable)
+{
+#ifdef HAVE_GNUTLS_TRANSPORT_IS_KTLS_ENABLED
+  // GnuTLS has no per-session switch.  It uses kTLS if "ktls = true"
+  // is set in the [global] section of its system-wide configuration,
+  // and we can only tell whether it did.
+  return true;
+#else  // !HAVE_GNUTLS_TRANSPORT_IS_KTLS_ENABLED
+  return false;
+#endif // !HAVE_GNUTLS_TRANSPORT_IS_KTLS_ENABLED
+}
+
 bool GnuTLSContext::addCredentialFile(const std::string& certfile,
                                       const std::string& keyfile)
 {
@@ -70,6 +70,8 @@ public:
     verifyPeer_ = verify;
   }
 
+  virtual bool setKTLS(bool enable) CXX11_OVERRIDE;
+
   gnutls_certificate_credentials_t getCertCred() const;
 
   TLSVersion getMinTLSVersion() const { return minTLSVer_; }
@@ -37,6 +37,9 @@
 #include <cassert>
 
 #include <gnutls/x509.h>
+#ifdef HAVE_GNUTLS_TRANSPORT_IS_KTLS_ENABLED
+#  include <gnutls/socket.h>
+#endif // HAVE_GNUTLS_TRANSPORT_IS_KTLS_ENABLED
 
 #include "TLSContext.h"
 #include "util.h"
@@ -178,6 +181,48 @@ int GnuTLSSession::setSNIHostname(const std::string& hostname)
   return TLS_ERR_OK;
 }
 
+int GnuTLSSession::setSessionData(const std::string& data)
+{
+  rv_ = gnutls_session_set_data(sslSession_, data.data(), data.size());
+  if (rv_ != GNUTLS_E_SUCCESS) {
+    return TLS_ERR_ERROR;
+  }
+  return TLS_ERR_OK;
+}
+
+std::string GnuTLSSession::getSessionData()
+{
+#if GNUTLS_VERSION_NUMBER >= 0x030604
+  // With TLS 1.3, the session is not resumable until the server sends
+  // a ticket.
+  if (!(gnutls_session_get_flags(sslSession_) & GNUTLS_SFLAGS_SESSION_TICKET) &&
+      gnutls_protocol_get_version(sslSession_) == GNUTLS_TLS1_3) {
+    return std::string();
+  }
+#endif // GNUTLS_VERSION_NUMBER >= 0x030604
+  gnutls_datum_t d;
+  if (gnutls_session_get_data2(sslSession_, &d) != GNUTLS_E_SUCCESS) {
+    return std::string();
+  }
+  std::string data(d.data, d.data + d.size);
+  gnutls_free(d.data);
+  return data;
+}
+
+bool GnuTLSSession::isSessionResumed()
+{
+  return gnutls_session_is_resumed(sslSession_);
+}
+
+bool GnuTLSSession::isKTLSEnabled()
+{
+#ifdef HAVE_GNUTLS_TRANSPORT_IS_KTLS_ENABLED
+  return gnutls_transport_is_ktls_enabled(sslSession_) != 0;
+#else  // !HAVE_GNUTLS_TRANSPORT_IS_KTLS_ENABLED
+  return false;
+#endif // !HAVE_GNUTLS_TRANSPORT_IS_KTLS_ENABLED
+}
+
 int GnuTLSSession::closeConnection()
 {
   rv_ = gnutls_bye(sslSession_, GNUTLS_SHUT_WR);
@@ -170,6 +170,23 @@ OpenSSLTLSContext::~OpenSSLTLSContext() { SSL_CTX_free(sslCtx_); }
 
 bool OpenSSLTLSContext::good() const { return good_; }
 
+bool OpenSSLTLSContext::setKTLS(bool enable)
+{
+#ifdef SSL_OP_ENABLE_KTLS
+  // OpenSSL falls back to userspace by itself if the kernel lacks the
+  // tls module or the negotiated cipher suite.
+  if (enable) {
+    SSL_CTX_set_options(sslCtx_, SSL_OP_ENABLE_KTLS);
+  }
+  else {
+    SSL_CTX_clear_options(sslCtx_, SSL_OP_ENABLE_KTLS);
+  }
+  return true;
+#else  // !SSL_OP_ENABLE_KTLS
+  return false;
+#endif // !SSL_OP_ENABLE_KTLS
+}
+
 bool OpenSSLTLSContext::addCredentialFile(const std::string& certfile,
                                           const std::string& keyfile)
 {
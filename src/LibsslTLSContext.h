@@ -72,6 +72,8 @@ public:
     verifyPeer_ = verify;
   }
 
+  virtual bool setKTLS(bool enable) CXX11_OVERRIDE;
+
   SSL_CTX* getSSLCtx() const { return sslCtx_; }
 
 private:
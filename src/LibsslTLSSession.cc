@@ -96,6 +96,58 @@ int OpenSSLTLSSession::setSNIHostname(const std::string& hostname)
   return TLS_ERR_OK;
 }
 
+int OpenSSLTLSSession::setSessionData(const std::string& data)
+{
+  ERR_clear_error();
+  auto p = reinterpret_cast<const unsigned char*>(data.data());
+  auto session = d2i_SSL_SESSION(nullptr, &p, data.size());
+  if (!session) {
+    return TLS_ERR_ERROR;
+  }
+  rv_ = SSL_set_session(ssl_, session);
+  // SSL_set_session() takes its own reference.
+  SSL_SESSION_free(session);
+  if (rv_ == 0) {
+    return TLS_ERR_ERROR;
+  }
+  return TLS_ERR_OK;
+}
+
+std::string OpenSSLTLSSession::getSessionData()
+{
+  auto session = SSL_get_session(ssl_);
+  if (!session) {
+    return std::string();
+  }
+#if !LIBRESSL_IN_USE && OPENSSL_VERSION_NUMBER >= 0x10101000L
+  // With TLS 1.3, the session is not resumable until the server sends
+  // a ticket.
+  if (!SSL_SESSION_is_resumable(session)) {
+    return std::string();
+  }
+#endif // !LIBRESSL_IN_USE && OPENSSL_VERSION_NUMBER >= 0x10101000L
+  auto len = i2d_SSL_SESSION(session, nullptr);
+  if (len <= 0) {
+    return std::string();
+  }
+  std::string data(len, '\0');
+  auto p = reinterpret_cast<unsigned char*>(&data[0]);
+  i2d_SSL_SESSION(session, &p);
+  return data;
+}
+
+bool OpenSSLTLSSession::isSessionResumed() { return SSL_session_reused(ssl_); }
+
+bool OpenSSLTLSSession::isKTLSEnabled()
+{
+#ifdef SSL_OP_ENABLE_KTLS
+  return BIO_get_ktls_send(SSL_get_wbio(ssl_)) ||
+         BIO_get_ktls_recv(SSL_get_rbio(ssl_));
+#else  // !SSL_OP_ENABLE_KTLS
+  return false;
+#endif // !SSL_OP_ENABLE_KTLS
+}
+
 int OpenSSLTLSSession::closeConnection()
 {
   ERR_clear_error();
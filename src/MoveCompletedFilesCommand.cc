@@ -0,0 +1,106 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "MoveCompletedFilesCommand.h"
+#include "FileCopier.h"
+#include "DownloadEngine.h"
+#include "RequestGroup.h"
+#include "RecoverableException.h"
+#include "LogFactory.h"
+#include "Logger.h"
+#include "fmt.h"
+
+namespace aria2 {
+
+MoveCompletedFilesCommand::MoveCompletedFilesCommand(
+    cuid_t cuid, RequestGroup* requestGroup, DownloadEngine* e,
+    std::vector<std::unique_ptr<FileCopier>> copiers, bool reopenStorage)
+    : RealtimeCommand{cuid, requestGroup, e},
+      copiers_{std::move(copiers)},
+      index_{0},
+      reopenStorage_{reopenStorage}
+{
+}
+
+MoveCompletedFilesCommand::~MoveCompletedFilesCommand() = default;
+
+void MoveCompletedFilesCommand::finish()
+{
+  getRequestGroup()->finishMovingCompletedFiles(copiers_, reopenStorage_);
+  // The files which were not copied are left as they are.
+  copiers_.clear();
+}
+
+bool MoveCompletedFilesCommand::executeInternal()
+{
+  if (getRequestGroup()->isHaltRequested()) {
+    A2_LOG_NOTICE(fmt("CUID#%" PRId64 " - Copying completed files canceled",
+                      getCuid()));
+    finish();
+    return true;
+  }
+  auto& copier = copiers_[index_];
+  try {
+    copier->copyChunk();
+    if (copier->finished()) {
+      ++index_;
+    }
+  }
+  catch (RecoverableException& e) {
+    A2_LOG_ERROR_EX(fmt("Failed to copy %s to %s",
+                        copier->getSrcPath().c_str(),
+                        copier->getDestPath().c_str()),
+                    e);
+    // The partial copy is removed, and the source stays.
+    copiers_.erase(std::begin(copiers_) + index_);
+  }
+  if (index_ == copiers_.size()) {
+    finish();
+    getDownloadEngine()->setNoWait(true);
+    return true;
+  }
+  getDownloadEngine()->addCommand(std::unique_ptr<Command>(this));
+  return false;
+}
+
+bool MoveCompletedFilesCommand::handleException(Exception& e)
+{
+  A2_LOG_ERROR_EX(fmt("CUID#%" PRId64 " - Moving completed files failed",
+                      getCuid()),
+                  e);
+  finish();
+  return true;
+}
+
+} // namespace aria2
@@ -0,0 +1,74 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_MOVE_COMPLETED_FILES_COMMAND_H
+#define D_MOVE_COMPLETED_FILES_COMMAND_H
+
+#include "RealtimeCommand.h"
+
+#include <vector>
+#include <memory>
+
+namespace aria2 {
+
+class FileCopier;
+
+// Copies the completed files of a download to --completed-dir on
+// another file system, one chunk each time it is executed.  When all
+// files are copied, RequestGroup::finishMovingCompletedFiles()
+// removes the sources.
+class MoveCompletedFilesCommand : public RealtimeCommand {
+private:
+  std::vector<std::unique_ptr<FileCopier>> copiers_;
+  size_t index_;
+  bool reopenStorage_;
+
+  void finish();
+
+public:
+  MoveCompletedFilesCommand(cuid_t cuid, RequestGroup* requestGroup,
+                            DownloadEngine* e,
+                            std::vector<std::unique_ptr<FileCopier>> copiers,
+                            bool reopenStorage);
+
+  virtual ~MoveCompletedFilesCommand();
+
+  virtual bool executeInternal() CXX11_OVERRIDE;
+
+  virtual bool handleException(Exception& e) CXX11_OVERRIDE;
+};
+
+} // namespace aria2
+
+#endif // D_MOVE_COMPLETED_FILES_COMMAND_H
@@ -35,6 +35,7 @@
 #include "MultiDiskAdaptor.h"
 
 #include <cassert>
+#include <cstring>
 #include <algorithm>
 #include <map>
 
@@ -49,9 +50,8 @@
 #include "fmt.h"
 #include "Logger.h"
 #include "LogFactory.h"
-#include "SimpleRandomizer.h"
-#include "WrDiskCacheEntry.h"
 #include "OpenedFileCounter.h"
+#include "PartsStore.h"
 
 namespace aria2 {
 
@@ -59,7 +59,8 @@ DiskWriterEntry::DiskWriterEntry(const std::shared_ptr<FileEntry>& fileEntry)
     : fileEntry_{fileEntry},
       open_{false},
       needsFileAllocation_{false},
-      needsDiskWriter_{false}
+      needsDiskWriter_{false},
+      usesPartsStore_{false}
 {
 }
 
@@ -114,7 +115,10 @@ bool DiskWriterEntry::operator<(const DiskWriterEntry& entry) const
   return *fileEntry_ < *entry.fileEntry_;
 }
 
-MultiDiskAdaptor::MultiDiskAdaptor() : pieceLength_{0}, readOnly_{false} {}
+MultiDiskAdaptor::MultiDiskAdaptor()
+    : pieceLength_{0}, readOnly_{false}, directIO_{false}, dataSync_{false}
+{
+}
 
 MultiDiskAdaptor::~MultiDiskAdaptor() { closeFile(); }
 
@@ -123,14 +127,17 @@ std::unique_ptr<DiskWriterEntry>
 createDiskWriterEntry(const std::shared_ptr<FileEntry>& fileEntry)
 {
   auto entry = make_unique<DiskWriterEntry>(fileEntry);
-  entry->needsFileAllocation(fileEntry->isRequested());
+  entry->needsFileAllocation(fileEntry->isRequested() &&
+                             !fileEntry->isPadFile());
   return entry;
 }
 } // namespace
 
 void MultiDiskAdaptor::resetDiskWriterEntries()
 {
-  assert(openedDiskWriterEntries_.empty());
+  assert(std::none_of(std::begin(diskWriterEntries_),
+                      std::end(diskWriterEntries_),
+                      std::mem_fn(&DiskWriterEntry::isOpen)));
   diskWriterEntries_.clear();
   if (getFileEntries().empty()) {
     return;
@@ -144,6 +151,9 @@ void MultiDiskAdaptor::resetDiskWriterEntries()
     int64_t lastOffset = 0;
     for (auto& dwent : diskWriterEntries_) {
       auto& fileEntry = dwent->getFileEntry();
+      if (fileEntry->isPadFile()) {
+        continue;
+      }
       if (fileEntry->isRequested()) {
         // zero length file does not affect lastOffset.
         if (fileEntry->getLength() > 0) {
@@ -164,6 +174,9 @@ void MultiDiskAdaptor::resetDiskWriterEntries()
     for (auto i = diskWriterEntries_.rbegin(), eoi = diskWriterEntries_.rend();
          i != eoi; ++i) {
       auto& fileEntry = (*i)->getFileEntry();
+      if (fileEntry->isPadFile()) {
+        continue;
+      }
       if (fileEntry->isRequested()) {
         lastOffset = fileEntry->getOffset() / pieceLength_ * pieceLength_;
       }
@@ -178,8 +191,24 @@ void MultiDiskAdaptor::resetDiskWriterEntries()
       }
     }
   }
+  if (!partsStorePath_.empty() && pieceLength_ > 0) {
+    for (auto& dwent : diskWriterEntries_) {
+      if (!dwent->getFileEntry()->isRequested() &&
+          (dwent->needsFileAllocation() || dwent->needsDiskWriter()) &&
+          !dwent->fileExists()) {
+        A2_LOG_DEBUG(fmt("%s uses parts store", dwent->getFilePath().c_str()));
+        dwent->needsFileAllocation(false);
+        dwent->needsDiskWriter(false);
+        dwent->usesPartsStore(true);
+      }
+    }
+  }
   DefaultDiskWriterFactory dwFactory;
   for (auto& dwent : diskWriterEntries_) {
+    // Pad files are never created.  Their data are zeros.
+    if (dwent->getFileEntry()->isPadFile()) {
+      continue;
+    }
     if (dwent->needsFileAllocation() || dwent->needsDiskWriter() ||
         dwent->fileExists()) {
       A2_LOG_DEBUG(fmt("Creating DiskWriter for filename=%s",
@@ -188,44 +217,44 @@ void MultiDiskAdaptor::resetDiskWriterEntries()
       if (readOnly_) {
         dwent->getDiskWriter()->enableReadOnly();
       }
+      if (directIO_) {
+        dwent->getDiskWriter()->enableDirectIO();
+      }
+      if (dataSync_) {
+        dwent->getDiskWriter()->enableDataSync();
+      }
       // TODO mmap is not enabled at this moment. Call enableMmap()
       // after this function call.
     }
   }
-}
-
-size_t MultiDiskAdaptor::tryCloseFile(size_t numClose)
-{
-  size_t left = numClose;
-  for (; !openedDiskWriterEntries_.empty() && left > 0; --left) {
-    // Choose one DiskWriterEntry randomly and close it.
-    size_t index = SimpleRandomizer::getInstance()->getRandomNumber(
-        openedDiskWriterEntries_.size());
-    auto i = std::begin(openedDiskWriterEntries_);
-    std::advance(i, index);
-    (*i)->closeFile();
-    (*i) = openedDiskWriterEntries_.back();
-    openedDiskWriterEntries_.pop_back();
+  if (!partsStorePath_.empty() && pieceLength_ > 0) {
+    setupPartsStore();
   }
-  return numClose - left;
 }
 
 void MultiDiskAdaptor::openIfNot(DiskWriterEntry* entry,
                                  void (DiskWriterEntry::*open)())
 {
+  auto& openedFileCounter = getOpenedFileCounter();
   if (!entry->isOpen()) {
-    // A2_LOG_NOTICE(fmt("DiskWriterEntry: Cache MISS. offset=%s",
-    //        util::itos(entry->getFileEntry()->getOffset()).c_str()));
-    auto& openedFileCounter = getOpenedFileCounter();
+    // Pad files, unselected files and files kept in the parts store
+    // have no DiskWriter, and opening them opens nothing.  Don't
+    // close another file for them.
+    if (!entry->getDiskWriter()) {
+      return;
+    }
     if (openedFileCounter) {
-      openedFileCounter->ensureMaxOpenFileLimit(1);
+      // With direct I/O, the file may be opened twice.
+      openedFileCounter->ensureMaxOpenFileLimit(directIO_ ? 2 : 1);
     }
     (entry->*open)();
-    openedDiskWriterEntries_.push_back(entry);
+    if (openedFileCounter && entry->isOpen()) {
+      openedFileCounter->opened(entry,
+                                entry->getDiskWriter()->getNumOpenFds());
+    }
   }
-  else {
-    // A2_LOG_NOTICE(fmt("DiskWriterEntry: Cache HIT. offset=%s",
-    //        util::itos(entry->getFileEntry()->getOffset()).c_str()));
+  else if (openedFileCounter) {
+    openedFileCounter->touch(entry);
   }
 }
 
@@ -262,19 +291,19 @@ void MultiDiskAdaptor::openExistingFile()
 
 void MultiDiskAdaptor::closeFile()
 {
-  for (auto& dwent : openedDiskWriterEntries_) {
-    auto& dw = dwent->getDiskWriter();
-    // required for unit test
-    if (!dw) {
-      continue;
-    }
-    dw->closeFile();
+  if (partsStore_) {
+    partsStore_->closeFile();
   }
   auto& openedFileCounter = getOpenedFileCounter();
-  if (openedFileCounter) {
-    openedFileCounter->reduceNumOfOpenedFile(openedDiskWriterEntries_.size());
+  for (auto& dwent : diskWriterEntries_) {
+    if (!dwent->isOpen()) {
+      continue;
+    }
+    if (openedFileCounter) {
+      openedFileCounter->closed(dwent.get());
+    }
+    dwent->closeFile();
   }
-  openedDiskWriterEntries_.clear();
 }
 
 namespace {
@@ -325,6 +354,84 @@ findFirstDiskWriterEntry(const DiskWriterEntries& diskWriterEntries,
 }
 } // namespace
 
+void MultiDiskAdaptor::setupPartsStore()
+{
+  // The store is moved with the files by --completed-dir.
+  if (!partsStore_ || partsStore_->getFilename() != partsStorePath_) {
+    if (partsStore_) {
+      partsStore_->closeFile();
+    }
+    partsStore_ = make_unique<PartsStore>(partsStorePath_, pieceLength_);
+  }
+  // Only the first and the last pieces of a file can be shared with
+  // other files.
+  auto sharesRequestedFile = [this](size_t index) {
+    int64_t first = static_cast<int64_t>(index) * pieceLength_;
+    int64_t last = first + pieceLength_;
+    for (auto i = findFirstDiskWriterEntry(diskWriterEntries_, first),
+              eoi = diskWriterEntries_.cend();
+         i != eoi && (*i)->getFileEntry()->getOffset() < last; ++i) {
+      auto& fe = (*i)->getFileEntry();
+      if (fe->isRequested() && !fe->isPadFile() && fe->getLength() > 0) {
+        return true;
+      }
+    }
+    return false;
+  };
+  std::vector<size_t> pieces, files;
+  for (size_t i = 0; i < diskWriterEntries_.size(); ++i) {
+    auto& dwent = diskWriterEntries_[i];
+    if (!dwent->usesPartsStore()) {
+      continue;
+    }
+    files.push_back(i);
+    auto& fe = dwent->getFileEntry();
+    if (fe->getLength() == 0) {
+      continue;
+    }
+    for (auto index : {fe->getOffset() / pieceLength_,
+                       (fe->getLastOffset() - 1) / pieceLength_}) {
+      if (sharesRequestedFile(index)) {
+        pieces.push_back(index);
+      }
+    }
+  }
+  std::sort(std::begin(pieces), std::end(pieces));
+  pieces.erase(std::unique(std::begin(pieces), std::end(pieces)),
+               std::end(pieces));
+
+  partsStore_->load();
+  // The files selected since the last time take their data out of the
+  // store.
+  std::vector<unsigned char> buf(pieceLength_);
+  for (auto i : partsStore_->getFiles()) {
+    if (i >= diskWriterEntries_.size()) {
+      continue;
+    }
+    auto dwent = diskWriterEntries_[i].get();
+    auto& fe = dwent->getFileEntry();
+    if (dwent->usesPartsStore() || !dwent->getDiskWriter() ||
+        fe->getLength() == 0) {
+      continue;
+    }
+    for (auto index : {fe->getOffset() / pieceLength_,
+                       (fe->getLastOffset() - 1) / pieceLength_}) {
+      if (!partsStore_->hasPiece(index)) {
+        continue;
+      }
+      auto first = std::max(fe->getOffset(),
+                            static_cast<int64_t>(index) * pieceLength_);
+      auto last = std::min(fe->getLastOffset(),
+                           static_cast<int64_t>(index + 1) * pieceLength_);
+      partsStore_->readData(buf.data(), last - first, first);
+      openIfNot(dwent, &DiskWriterEntry::openFile);
+      dwent->getDiskWriter()->writeData(buf.data(), last - first,
+                                        first - fe->getOffset());
+    }
+  }
+  partsStore_->reset(std::move(pieces), std::move(files));
+}
+
 namespace {
 void throwOnDiskWriterNotOpened(DiskWriterEntry* e, int64_t offset)
 {
@@ -338,17 +445,24 @@ void MultiDiskAdaptor::writeData(const unsigned char* data, size_t len,
                                  int64_t offset)
 {
   auto first = findFirstDiskWriterEntry(diskWriterEntries_, offset);
+  // The store keeps the whole piece, so that the data of a file can be
+  // moved out of it when the file gets selected.
+  if (partsStore_) {
+    partsStore_->writeData(data, len, offset);
+  }
   ssize_t rem = len;
   int64_t fileOffset = offset - (*first)->getFileEntry()->getOffset();
   for (auto i = first, eoi = diskWriterEntries_.cend(); i != eoi; ++i) {
     ssize_t writeLength = calculateLength((*i).get(), fileOffset, rem);
-    openIfNot((*i).get(), &DiskWriterEntry::openFile);
-    if (!(*i)->isOpen()) {
-      throwOnDiskWriterNotOpened((*i).get(), offset + (len - rem));
-    }
+    if (!(*i)->getFileEntry()->isPadFile() && !(*i)->usesPartsStore()) {
+      openIfNot((*i).get(), &DiskWriterEntry::openFile);
+      if (!(*i)->isOpen()) {
+        throwOnDiskWriterNotOpened((*i).get(), offset + (len - rem));
+      }
 
-    (*i)->getDiskWriter()->writeData(data + (len - rem), writeLength,
-                                     fileOffset);
+      (*i)->getDiskWriter()->writeData(data + (len - rem), writeLength,
+                                       fileOffset);
+    }
     rem -= writeLength;
     fileOffset = 0;
     if (rem == 0) {
@@ -378,6 +492,22 @@ ssize_t MultiDiskAdaptor::readData(unsigned char* data, size_t len,
   int64_t fileOffset = offset - (*first)->getFileEntry()->getOffset();
   for (auto i = first, eoi = diskWriterEntries_.cend(); i != eoi; ++i) {
     ssize_t readLength = calculateLength((*i).get(), fileOffset, rem);
+    if ((*i)->usesPartsStore() || (*i)->getFileEntry()->isPadFile()) {
+      if ((*i)->usesPartsStore()) {
+        partsStore_->readData(data + (len - rem), readLength,
+                              (*i)->getFileEntry()->getOffset() + fileOffset);
+      }
+      else {
+        memset(data + (len - rem), 0, readLength);
+      }
+      totalReadLength += readLength;
+      rem -= readLength;
+      fileOffset = 0;
+      if (rem == 0) {
+        break;
+      }
+      continue;
+    }
     openIfNot((*i).get(), &DiskWriterEntry::openFile);
     if (!(*i)->isOpen()) {
       throwOnDiskWriterNotOpened((*i).get(), offset + (len - rem));
@@ -410,27 +540,41 @@ ssize_t MultiDiskAdaptor::readData(unsigned char* data, size_t len,
   return totalReadLength;
 }
 
-void MultiDiskAdaptor::writeCache(const WrDiskCacheEntry* entry)
+const unsigned char* MultiDiskAdaptor::getMappedData(size_t len,
+                                                     int64_t offset)
 {
-  for (auto& d : entry->getDataSet()) {
-    A2_LOG_DEBUG(fmt("Cache flush goff=%" PRId64 ", len=%lu", d->goff,
-                     static_cast<unsigned long>(d->len)));
-    writeData(d->data + d->offset, d->len, d->goff);
+  auto first = findFirstDiskWriterEntry(diskWriterEntries_, offset);
+  auto& fileEntry = (*first)->getFileEntry();
+  int64_t fileOffset = offset - fileEntry->getOffset();
+  // Data across file boundary are not contiguous in memory.
+  if (fileOffset + static_cast<int64_t>(len) > fileEntry->getLength()) {
+    return nullptr;
   }
+  openIfNot((*first).get(), &DiskWriterEntry::openFile);
+  if (!(*first)->isOpen()) {
+    return nullptr;
+  }
+  return (*first)->getDiskWriter()->getMappedData(len, fileOffset);
 }
 
 bool MultiDiskAdaptor::fileExists()
 {
   return std::find_if(std::begin(getFileEntries()), std::end(getFileEntries()),
-                      std::mem_fn(&FileEntry::exists)) !=
-         std::end(getFileEntries());
+                      [](const std::shared_ptr<FileEntry>& fe) {
+                        return !fe->isPadFile() && fe->exists();
+                      }) != std::end(getFileEntries());
 }
 
 int64_t MultiDiskAdaptor::size()
 {
   int64_t size = 0;
   for (auto& fe : getFileEntries()) {
-    size += File(fe->getPath()).size();
+    if (fe->isPadFile()) {
+      size += fe->getLength();
+    }
+    else {
+      size += File(fe->getPath()).size();
+    }
   }
   return size;
 }
@@ -455,9 +599,66 @@ void MultiDiskAdaptor::enableMmap()
   }
 }
 
+void MultiDiskAdaptor::enableDirectIO()
+{
+  directIO_ = true;
+  for (auto& dwent : diskWriterEntries_) {
+    auto& dw = dwent->getDiskWriter();
+    if (dw) {
+      dw->enableDirectIO();
+    }
+  }
+}
+
+void MultiDiskAdaptor::enableDataSync()
+{
+  dataSync_ = true;
+  for (auto& dwent : diskWriterEntries_) {
+    auto& dw = dwent->getDiskWriter();
+    if (dw) {
+      dw->enableDataSync();
+    }
+  }
+}
+
+void MultiDiskAdaptor::sync()
+{
+  if (partsStore_) {
+    partsStore_->sync();
+  }
+  // Closed files were already synced if data sync is enabled, but
+  // their DiskWriter still reports the error if that sync failed.
+  for (auto& dwent : diskWriterEntries_) {
+    if (dwent->getDiskWriter()) {
+      dwent->getDiskWriter()->sync();
+    }
+  }
+}
+
+void MultiDiskAdaptor::writeback(int64_t len, int64_t offset)
+{
+  auto first = findFirstDiskWriterEntry(diskWriterEntries_, offset);
+  ssize_t rem = len;
+  int64_t fileOffset = offset - (*first)->getFileEntry()->getOffset();
+  for (auto i = first, eoi = diskWriterEntries_.cend(); i != eoi; ++i) {
+    ssize_t length = calculateLength((*i).get(), fileOffset, rem);
+    if ((*i)->isOpen()) {
+      (*i)->getDiskWriter()->writeback(length, fileOffset);
+    }
+    rem -= length;
+    fileOffset = 0;
+    if (rem == 0) {
+      break;
+    }
+  }
+}
+
 void MultiDiskAdaptor::cutTrailingGarbage()
 {
   for (auto& dwent : diskWriterEntries_) {
+    if (dwent->getFileEntry()->isPadFile()) {
+      continue;
+    }
     int64_t length = dwent->getFileEntry()->getLength();
     if (File(dwent->getFilePath()).size() > length) {
       // We need open file before calling DiskWriter::truncate(int64_t)
@@ -42,6 +42,7 @@ namespace aria2 {
 class MultiFileAllocationIterator;
 class FileEntry;
 class DiskWriter;
+class PartsStore;
 
 class DiskWriterEntry {
 private:
@@ -50,6 +51,7 @@ private:
   bool open_;
   bool needsFileAllocation_;
   bool needsDiskWriter_;
+  bool usesPartsStore_;
 
 public:
   DiskWriterEntry(const std::shared_ptr<FileEntry>& fileEntry);
@@ -88,6 +90,12 @@ public:
   bool needsDiskWriter() const { return needsDiskWriter_; }
 
   void needsDiskWriter(bool f) { needsDiskWriter_ = f; }
+
+  // True if the data of this file are kept in the parts store instead
+  // of the file.
+  bool usesPartsStore() const { return usesPartsStore_; }
+
+  void usesPartsStore(bool f) { usesPartsStore_ = f; }
 };
 
 typedef std::vector<std::unique_ptr<DiskWriterEntry>> DiskWriterEntries;
@@ -99,12 +107,21 @@ private:
   int32_t pieceLength_;
   DiskWriterEntries diskWriterEntries_;
 
-  std::vector<DiskWriterEntry*> openedDiskWriterEntries_;
-
   bool readOnly_;
 
+  bool directIO_;
+
+  bool dataSync_;
+
+  std::string partsStorePath_;
+  std::unique_ptr<PartsStore> partsStore_;
+
   void resetDiskWriterEntries();
 
+  // Opens the parts store for the entries which use it.  The data of
+  // the entries which used it before are written to their files.
+  void setupPartsStore();
+
   void openIfNot(DiskWriterEntry* entry, void (DiskWriterEntry::*f)());
 
   ssize_t readData(unsigned char* data, size_t len, int64_t offset,
@@ -133,7 +150,8 @@ public:
   virtual ssize_t readDataDropCache(unsigned char* data, size_t len,
                                     int64_t offset) CXX11_OVERRIDE;
 
-  virtual void writeCache(const WrDiskCacheEntry* entry) CXX11_OVERRIDE;
+  virtual const unsigned char* getMappedData(size_t len,
+                                             int64_t offset) CXX11_OVERRIDE;
 
   virtual bool fileExists() CXX11_OVERRIDE;
 
@@ -152,10 +170,26 @@ public:
   // opened.
   virtual void enableMmap() CXX11_OVERRIDE;
 
+  virtual void enableDirectIO() CXX11_OVERRIDE;
+
+  virtual void enableDataSync() CXX11_OVERRIDE;
+
+  // Syncs the opened files and the parts store.
+  virtual void sync() CXX11_OVERRIDE;
+
+  virtual void writeback(int64_t len, int64_t offset) CXX11_OVERRIDE;
+
   void setPieceLength(int32_t pieceLength) { pieceLength_ = pieceLength; }
 
   int32_t getPieceLength() const { return pieceLength_; }
 
+  // Sets the path of the parts store.  If it is set, the unselected
+  // files which share pieces with the selected files are not created.
+  void setPartsStorePath(std::string path)
+  {
+    partsStorePath_ = std::move(path);
+  }
+
   virtual void cutTrailingGarbage() CXX11_OVERRIDE;
 
   virtual size_t utime(const Time& actime, const Time& modtime) CXX11_OVERRIDE;
@@ -164,8 +198,6 @@ public:
   {
     return diskWriterEntries_;
   }
-
-  virtual size_t tryCloseFile(size_t numClose) CXX11_OVERRIDE;
 };
 
 } // namespace aria2
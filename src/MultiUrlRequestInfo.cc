@@ -198,6 +198,10 @@ int MultiUrlRequestInfo::prepare()
         throw DL_ABORT_EX("Loading private key and/or certificate for secure "
                           "RPC failed.");
       }
+      if (option_->getAsBool(PREF_ENABLE_KTLS) &&
+          !svTlsContext->setKTLS(true)) {
+        A2_LOG_WARN("kTLS is not supported by the SSL/TLS library.");
+      }
       SocketCore::setServerTLSContext(svTlsContext);
     }
 #endif // ENABLE_SSL
@@ -270,6 +274,9 @@ int MultiUrlRequestInfo::prepare()
       }
     }
     clTlsContext->setVerifyPeer(option_->getAsBool(PREF_CHECK_CERTIFICATE));
+    if (option_->getAsBool(PREF_ENABLE_KTLS) && !clTlsContext->setKTLS(true)) {
+      A2_LOG_WARN("kTLS is not supported by the SSL/TLS library.");
+    }
     SocketCore::setClientTLSContext(clTlsContext);
 #endif
 #ifdef HAVE_ARES_ADDR_NODE
@@ -34,80 +34,123 @@
 /* copyright --> */
 #include "OpenedFileCounter.h"
 
-#include <cassert>
-
-#include "RequestGroupMan.h"
-#include "RequestGroup.h"
-#include "PieceStorage.h"
-#include "DiskAdaptor.h"
-#include "SimpleRandomizer.h"
+#include "MultiDiskAdaptor.h"
+#include "Logger.h"
+#include "LogFactory.h"
+#include "fmt.h"
 
 namespace aria2 {
 
-OpenedFileCounter::OpenedFileCounter(RequestGroupMan* rgman,
-                                     size_t maxOpenFiles)
-    : rgman_(rgman), maxOpenFiles_(maxOpenFiles), numOpenFiles_(0)
+OpenedFileCounter::OpenedFileCounter(size_t maxOpenFiles)
+    : maxOpenFiles_(maxOpenFiles),
+      numOpenFds_(0),
+      hits_(0),
+      misses_(0),
+      evictions_(0),
+      active_(true)
 {
 }
 
-void OpenedFileCounter::ensureMaxOpenFileLimit(size_t numNewFiles)
+void OpenedFileCounter::evict(size_t maxOpenFds)
 {
-  if (!rgman_) {
-    return;
+  while (numOpenFds_ > maxOpenFds) {
+    auto entry = lru_.back();
+    lru_.pop_back();
+    auto i = index_.find(entry);
+    numOpenFds_ -= (*i).second.second;
+    index_.erase(i);
+    A2_LOG_DEBUG(fmt("Closing least recently used file %s",
+                     entry->getFilePath().c_str()));
+    entry->closeFile();
+    ++evictions_;
   }
+}
 
-  if (numOpenFiles_ + numNewFiles <= maxOpenFiles_) {
-    numOpenFiles_ += numNewFiles;
+void OpenedFileCounter::ensureMaxOpenFileLimit(size_t numNewFds)
+{
+  if (!active_) {
     return;
   }
-  assert(numNewFiles <= maxOpenFiles_);
-  size_t numClose = numOpenFiles_ + numNewFiles - maxOpenFiles_;
-  size_t left = numClose;
 
-  auto& requestGroups = rgman_->getRequestGroups();
-
-  auto mark = std::begin(requestGroups);
-  std::advance(mark, SimpleRandomizer::getInstance()->getRandomNumber(
-                         requestGroups.size()));
-
-  auto closeFun = [&left](const std::shared_ptr<RequestGroup>& group) {
-    auto& ps = group->getPieceStorage();
+  if (numNewFds >= maxOpenFiles_) {
+    evict(0);
+  }
+  else if (numOpenFds_ + numNewFds > maxOpenFiles_) {
+    evict(maxOpenFiles_ - numNewFds);
+  }
+}
 
-    if (!ps) {
-      return;
-    }
+void OpenedFileCounter::opened(DiskWriterEntry* entry, size_t numFds)
+{
+  if (!active_) {
+    return;
+  }
 
-    auto diskAdaptor = ps->getDiskAdaptor();
+  ++misses_;
+  auto i = index_.find(entry);
+  if (i != std::end(index_)) {
+    lru_.splice(std::begin(lru_), lru_, (*i).second.first);
+    numOpenFds_ = numOpenFds_ - (*i).second.second + numFds;
+    (*i).second.second = numFds;
+    return;
+  }
+  lru_.push_front(entry);
+  index_.emplace(entry, std::make_pair(std::begin(lru_), numFds));
+  numOpenFds_ += numFds;
+}
 
-    if (!diskAdaptor) {
-      return;
-    }
+void OpenedFileCounter::touch(DiskWriterEntry* entry)
+{
+  if (!active_) {
+    return;
+  }
 
-    left -= diskAdaptor->tryCloseFile(left);
-  };
+  auto i = index_.find(entry);
+  if (i == std::end(index_)) {
+    return;
+  }
+  ++hits_;
+  lru_.splice(std::begin(lru_), lru_, (*i).second.first);
+}
 
-  for (auto i = mark; i != std::end(requestGroups) && left > 0; ++i) {
-    closeFun(*i);
+void OpenedFileCounter::closed(DiskWriterEntry* entry)
+{
+  if (!active_) {
+    return;
   }
 
-  for (auto i = std::begin(requestGroups); i != mark && left > 0; ++i) {
-    closeFun(*i);
+  auto i = index_.find(entry);
+  if (i == std::end(index_)) {
+    return;
   }
+  lru_.erase((*i).second.first);
+  numOpenFds_ -= (*i).second.second;
+  index_.erase(i);
+}
 
-  assert(left == 0);
-  numOpenFiles_ += numNewFiles - numClose;
+void OpenedFileCounter::setMaxOpenFiles(size_t maxOpenFiles)
+{
+  maxOpenFiles_ = maxOpenFiles;
+  if (active_) {
+    evict(maxOpenFiles_);
+  }
 }
 
-void OpenedFileCounter::reduceNumOfOpenedFile(size_t numCloseFiles)
+void OpenedFileCounter::deactivate()
 {
-  if (!rgman_) {
+  if (!active_) {
     return;
   }
 
-  assert(numOpenFiles_ >= numCloseFiles);
-  numOpenFiles_ -= numCloseFiles;
+  if (hits_ + misses_ > 0) {
+    A2_LOG_INFO(fmt("Open file cache: %" PRIu64 " hits, %" PRIu64
+                    " misses, %" PRIu64 " evictions",
+                    hits_, misses_, evictions_));
+  }
+  lru_.clear();
+  index_.clear();
+  numOpenFds_ = 0;
+  active_ = false;
 }
 
-void OpenedFileCounter::deactivate() { rgman_ = nullptr; }
-
 } // namespace aria2
@@ -37,35 +37,79 @@
 
 #include "common.h"
 
+#include <list>
+#include <unordered_map>
+
 namespace aria2 {
 
-class RequestGroupMan;
+class DiskWriterEntry;
 
+// Process-wide cache of the files opened by MultiDiskAdaptor.  The
+// number of file descriptors used by the open files is kept under the
+// global limit by closing the least recently used files first, so
+// that files which are actively read or written stay open.  A file
+// opened for direct I/O uses 2 file descriptors.
+//
+// Currently the only download using MultiDiskAdaptor is affected by
+// the global limit.
 class OpenedFileCounter {
 public:
-  OpenedFileCounter(RequestGroupMan* rgman, size_t maxOpenFiles);
+  OpenedFileCounter(size_t maxOpenFiles);
+
+  // Closes the least recently used files so that the files which are
+  // going to be opened with |numNewFds| file descriptors fit in the
+  // limit.  If |numNewFds| is more than the limit, all files are
+  // closed.
+  void ensureMaxOpenFileLimit(size_t numNewFds);
+
+  // Registers |entry|, which was just opened with |numFds| file
+  // descriptors, as the most recently used file.
+  void opened(DiskWriterEntry* entry, size_t numFds = 1);
+
+  // Marks |entry|, which is already open, as the most recently used
+  // file.
+  void touch(DiskWriterEntry* entry);
+
+  // Forgets |entry|, which was closed by its owner.
+  void closed(DiskWriterEntry* entry);
 
-  // Keeps the number of open files under the global limit specified
-  // in the option.  The caller requests that |numNewFiles| files are
-  // going to be opened.  This function requires that |numNewFiles| is
-  // less than or equal to the limit.
-  //
-  // Currently the only download using MultiDiskAdaptor is affected by
-  // the global limit.
-  void ensureMaxOpenFileLimit(size_t numNewFiles);
+  // Sets the limit.  Files over the new limit are closed
+  // immediately.
+  void setMaxOpenFiles(size_t maxOpenFiles);
 
-  // Reduces the number of open files managed by this object.
-  void reduceNumOfOpenedFile(size_t numCloseFiles);
+  size_t getNumOpenFiles() const { return lru_.size(); }
 
-  void setMaxOpenFiles(size_t maxOpenFiles) { maxOpenFiles_ = maxOpenFiles; }
+  size_t getNumOpenFds() const { return numOpenFds_; }
 
-  // Deactivates this object.
+  // The number of accesses to a file which was already open.
+  uint64_t getHits() const { return hits_; }
+
+  // The number of accesses which had to open a file.
+  uint64_t getMisses() const { return misses_; }
+
+  // The number of files closed to stay under the limit.
+  uint64_t getEvictions() const { return evictions_; }
+
+  // Deactivates this object.  The files it tracks are left to their
+  // owners.
   void deactivate();
 
 private:
-  RequestGroupMan* rgman_;
+  void evict(size_t maxOpenFds);
+
+  // Open files, the most recently used first.
+  std::list<DiskWriterEntry*> lru_;
+  // The position of each open file in lru_, and the number of file
+  // descriptors it uses.
+  std::unordered_map<DiskWriterEntry*,
+                     std::pair<std::list<DiskWriterEntry*>::iterator, size_t>>
+      index_;
   size_t maxOpenFiles_;
-  size_t numOpenFiles_;
+  size_t numOpenFds_;
+  uint64_t hits_;
+  uint64_t misses_;
+  uint64_t evictions_;
+  bool active_;
 };
 
 } // namespace aria2
@@ -139,6 +139,18 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->setChangeOptionForReserved(true);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new LocalFilePathOptionHandler(
+        PREF_COMPLETED_DIR, TEXT_COMPLETED_DIR, NO_DEFAULT_VALUE,
+        /* acceptStdin = */ false, 0,
+        /* mustExist = */ false, PATH_TO_DIR));
+    op->addTag(TAG_ADVANCED);
+    op->addTag(TAG_FILE);
+    op->setInitialOption(true);
+    op->setChangeGlobalOption(true);
+    op->setChangeOptionForReserved(true);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new BooleanOptionHandler(PREF_CONDITIONAL_GET,
                                                TEXT_CONDITIONAL_GET, A2_V_FALSE,
@@ -185,6 +197,13 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->addTag(TAG_ADVANCED);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new UnitNumberOptionHandler(
+        PREF_DISK_READ_CACHE, TEXT_DISK_READ_CACHE, "0", 0));
+    op->addTag(TAG_ADVANCED);
+    op->addTag(TAG_BITTORRENT);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new ParameterOptionHandler(
         PREF_CONSOLE_LOG_LEVEL, TEXT_CONSOLE_LOG_LEVEL, V_NOTICE,
@@ -243,6 +262,17 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->setChangeGlobalOption(true);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new BooleanOptionHandler(PREF_DURABLE_SAVE,
+                                               TEXT_DURABLE_SAVE, A2_V_FALSE,
+                                               OptionHandler::OPT_ARG));
+    op->addTag(TAG_ADVANCED);
+    op->addTag(TAG_FILE);
+    op->setInitialOption(true);
+    op->setChangeGlobalOption(true);
+    op->setChangeOptionForReserved(true);
+    handlers.push_back(op);
+  }
 #ifdef ENABLE_ASYNC_DNS
   {
     // TODO Deprecated
@@ -263,6 +293,17 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->addTag(TAG_ADVANCED);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new BooleanOptionHandler(
+        PREF_ENABLE_DIRECT_IO, TEXT_ENABLE_DIRECT_IO, A2_V_FALSE,
+        OptionHandler::OPT_ARG));
+    op->addTag(TAG_ADVANCED);
+    op->addTag(TAG_FILE);
+    op->setInitialOption(true);
+    op->setChangeGlobalOption(true);
+    op->setChangeOptionForReserved(true);
+    handlers.push_back(op);
+  }
 #if defined(HAVE_MMAP) || defined(__MINGW32__)
   {
     OptionHandler* op(new BooleanOptionHandler(PREF_ENABLE_MMAP,
@@ -437,6 +478,15 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->setChangeGlobalOption(true);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new NumberOptionHandler(
+        PREF_MAX_CONCURRENT_FILE_ALLOCATIONS,
+        TEXT_MAX_CONCURRENT_FILE_ALLOCATIONS, "2", 1, -1));
+    op->addTag(TAG_ADVANCED);
+    op->addTag(TAG_FILE);
+    op->setChangeGlobalOption(true);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new NumberOptionHandler(PREF_MAX_CONNECTION_PER_SERVER,
                                               TEXT_MAX_CONNECTION_PER_SERVER,
@@ -518,6 +568,15 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->addTag(TAG_ADVANCED);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new BooleanOptionHandler(PREF_ENABLE_KTLS,
+                                               TEXT_ENABLE_KTLS, A2_V_FALSE,
+                                               OptionHandler::OPT_ARG));
+    op->addTag(TAG_ADVANCED);
+    op->addTag(TAG_HTTP);
+    op->addTag(TAG_RPC);
+    handlers.push_back(op);
+  }
 #endif // ENABLE_SSL
   {
     OptionHandler* op(new DefaultOptionHandler(
@@ -969,6 +1028,18 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->addTag(TAG_HTTP);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(
+        new NumberOptionHandler(PREF_AUTO_SPLIT, TEXT_AUTO_SPLIT, "0", 0, -1));
+    op->addTag(TAG_ADVANCED);
+    op->addTag(TAG_FTP);
+    op->addTag(TAG_HTTP);
+    op->setInitialOption(true);
+    op->setChangeOption(true);
+    op->setChangeGlobalOption(true);
+    op->setChangeOptionForReserved(true);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(
         new NumberOptionHandler(PREF_SPLIT, TEXT_SPLIT, "5", 1, -1, 's'));
@@ -1086,6 +1157,15 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->setChangeOptionForReserved(true);
     handlers.push_back(op);
   }
+  {
+    OptionHandler* op(new NumberOptionHandler(
+        PREF_MAX_HTTP_PIPELINING, TEXT_MAX_HTTP_PIPELINING, "4", 1, 8));
+    op->addTag(TAG_HTTP);
+    op->setInitialOption(true);
+    op->setChangeGlobalOption(true);
+    op->setChangeOptionForReserved(true);
+    handlers.push_back(op);
+  }
   {
     OptionHandler* op(new CumulativeOptionHandler(PREF_HEADER, TEXT_HEADER,
                                                   NO_DEFAULT_VALUE, "\n"));
@@ -1156,12 +1236,6 @@ std::vector<OptionHandler*> OptionHandlerFactory::createOptionHandlers()
     op->addTag(TAG_COOKIE);
     handlers.push_back(op);
   }
-  {
-    OptionHandler* op(new NumberOptionHandler(PREF_MAX_HTTP_PIPELINING,
-                                              NO_DESCRIPTION, "2", 1, 8));
-    op->hide();
-    handlers.push_back(op);
-  }
   {
     OptionHandler* op(new DefaultOptionHandler(PREF_METALINK_LOCATION,
                                                TEXT_METALINK_LOCATION));
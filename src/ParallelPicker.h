@@ -0,0 +1,112 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_PARALLEL_PICKER_H
+#define D_PARALLEL_PICKER_H
+
+#include "common.h"
+
+#include <deque>
+#include <vector>
+#include <memory>
+#include <algorithm>
+
+namespace aria2 {
+
+// Like SequentialPicker, but up to maxPicked entries can be picked at
+// the same time.  Entries are picked in the order they were pushed.
+template <typename T> class ParallelPicker {
+private:
+  std::deque<std::unique_ptr<T>> entries_;
+  std::vector<std::unique_ptr<T>> pickedEntries_;
+  size_t maxPicked_;
+
+public:
+  ParallelPicker(size_t maxPicked = 1)
+      : maxPicked_(std::max<size_t>(1, maxPicked))
+  {
+  }
+
+  bool isPicked() const { return !pickedEntries_.empty(); }
+
+  // Returns true if one more entry can be picked.
+  bool canPick() const { return pickedEntries_.size() < maxPicked_; }
+
+  const std::vector<std::unique_ptr<T>>& getPickedEntries() const
+  {
+    return pickedEntries_;
+  }
+
+  void dropPickedEntry(T* entry)
+  {
+    auto i = std::find_if(
+        std::begin(pickedEntries_), std::end(pickedEntries_),
+        [entry](const std::unique_ptr<T>& e) { return e.get() == entry; });
+    if (i != std::end(pickedEntries_)) {
+      pickedEntries_.erase(i);
+    }
+  }
+
+  bool hasNext() const { return !entries_.empty(); }
+
+  T* pickNext()
+  {
+    if (hasNext() && canPick()) {
+      pickedEntries_.push_back(std::move(entries_.front()));
+      entries_.pop_front();
+      return pickedEntries_.back().get();
+    }
+    return nullptr;
+  }
+
+  void pushEntry(std::unique_ptr<T> entry)
+  {
+    entries_.push_back(std::move(entry));
+  }
+
+  size_t countEntryInQueue() const { return entries_.size(); }
+
+  size_t getMaxPicked() const { return maxPicked_; }
+
+  // Entries already picked are not affected when |maxPicked| is
+  // lowered.
+  void setMaxPicked(size_t maxPicked)
+  {
+    maxPicked_ = std::max<size_t>(1, maxPicked);
+  }
+};
+
+} // namespace aria2
+
+#endif // D_PARALLEL_PICKER_H
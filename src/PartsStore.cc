@@ -0,0 +1,254 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "PartsStore.h"
+
+#include <cstring>
+#include <algorithm>
+
+#include "DefaultDiskWriter.h"
+#include "File.h"
+#include "DlAbortEx.h"
+#include "LogFactory.h"
+#include "fmt.h"
+#include "a2netcompat.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+PartsStore::PartsStore(std::string filename, int32_t pieceLength)
+    : filename_(std::move(filename)), pieceLength_(pieceLength), dataOffset_(0)
+{
+}
+
+PartsStore::~PartsStore() = default;
+
+namespace {
+// Reads the list at |offset| in |dw|, and advances |offset| past it.
+// |size| is the size of the file.
+bool readList(std::vector<size_t>& list, DiskWriter* dw, int64_t& offset,
+              int64_t size)
+{
+  uint32_t n;
+  if (offset + 4 > size ||
+      dw->readData(reinterpret_cast<unsigned char*>(&n), 4, offset) != 4) {
+    return false;
+  }
+  n = ntohl(n);
+  offset += 4;
+  if (static_cast<int64_t>(n) * 4 > size - offset) {
+    return false;
+  }
+  std::vector<uint32_t> buf(n);
+  if (n > 0 &&
+      dw->readData(reinterpret_cast<unsigned char*>(buf.data()), n * 4,
+                   offset) != static_cast<ssize_t>(n) * 4) {
+    return false;
+  }
+  offset += n * 4;
+  list.clear();
+  for (auto v : buf) {
+    list.push_back(ntohl(v));
+  }
+  return std::is_sorted(std::begin(list), std::end(list));
+}
+} // namespace
+
+namespace {
+void appendList(std::vector<unsigned char>& buf,
+                const std::vector<size_t>& list)
+{
+  uint32_t v = htonl(list.size());
+  auto p = reinterpret_cast<const unsigned char*>(&v);
+  buf.insert(std::end(buf), p, p + 4);
+  for (auto i : list) {
+    v = htonl(i);
+    buf.insert(std::end(buf), p, p + 4);
+  }
+}
+} // namespace
+
+bool PartsStore::load()
+{
+  closeFile();
+  pieces_.clear();
+  files_.clear();
+  dataOffset_ = 0;
+  File f(filename_);
+  if (!f.isFile()) {
+    return false;
+  }
+  auto dw = make_unique<DefaultDiskWriter>(filename_);
+  dw->openExistingFile();
+  int64_t size = dw->size();
+  int64_t offset = 0;
+  std::vector<size_t> pieces, files;
+  if (!readList(pieces, dw.get(), offset, size) ||
+      !readList(files, dw.get(), offset, size)) {
+    A2_LOG_WARN(fmt("Ignoring broken parts file %s", filename_.c_str()));
+    return false;
+  }
+  pieces_.swap(pieces);
+  files_.swap(files);
+  dataOffset_ = offset;
+  diskWriter_ = std::move(dw);
+  return true;
+}
+
+void PartsStore::reset(std::vector<size_t> pieces, std::vector<size_t> files)
+{
+  if (pieces == pieces_ && files == files_ &&
+      (pieces.empty() || dataOffset_ > 0)) {
+    return;
+  }
+  if (pieces.empty()) {
+    closeFile();
+    File(filename_).remove();
+    pieces_.clear();
+    files_.swap(files);
+    dataOffset_ = 0;
+    return;
+  }
+  A2_LOG_DEBUG(fmt("Writing parts file %s, %lu pieces", filename_.c_str(),
+                   static_cast<unsigned long>(pieces.size())));
+  std::vector<unsigned char> header;
+  appendList(header, pieces);
+  appendList(header, files);
+  // Write to the temporary file first, so that the pieces already
+  // held are not lost if aria2 is killed in the middle.
+  auto tempFilename = filename_ + ".tmp";
+  DefaultDiskWriter dw(tempFilename);
+  dw.initAndOpenFile();
+  dw.writeData(header.data(), header.size(), 0);
+  std::vector<unsigned char> buf(pieceLength_);
+  for (size_t i = 0; i < pieces.size(); ++i) {
+    auto offset = getPieceOffset(pieces[i]);
+    if (offset == -1) {
+      continue;
+    }
+    openFile();
+    auto r = diskWriter_->readData(buf.data(), buf.size(), offset);
+    if (r > 0) {
+      dw.writeData(buf.data(), r,
+                   header.size() + static_cast<int64_t>(i) * pieceLength_);
+    }
+  }
+  dw.closeFile();
+  closeFile();
+  if (!File(tempFilename).renameTo(filename_)) {
+    throw DL_ABORT_EX(fmt("Failed to rename %s to %s", tempFilename.c_str(),
+                          filename_.c_str()));
+  }
+  pieces_.swap(pieces);
+  files_.swap(files);
+  dataOffset_ = header.size();
+}
+
+bool PartsStore::hasPiece(size_t index) const
+{
+  return std::binary_search(std::begin(pieces_), std::end(pieces_), index);
+}
+
+int64_t PartsStore::getPieceOffset(size_t index) const
+{
+  auto i = std::lower_bound(std::begin(pieces_), std::end(pieces_), index);
+  if (i == std::end(pieces_) || *i != index) {
+    return -1;
+  }
+  return dataOffset_ +
+         static_cast<int64_t>(i - std::begin(pieces_)) * pieceLength_;
+}
+
+void PartsStore::writeData(const unsigned char* data, size_t len,
+                           int64_t offset)
+{
+  if (len == 0) {
+    return;
+  }
+  auto last = offset + static_cast<int64_t>(len);
+  for (auto i = std::lower_bound(std::begin(pieces_), std::end(pieces_),
+                                 offset / pieceLength_),
+            eoi = std::end(pieces_);
+       i != eoi && static_cast<int64_t>(*i) * pieceLength_ < last; ++i) {
+    int64_t pieceOffset = static_cast<int64_t>(*i) * pieceLength_;
+    auto first = std::max(offset, pieceOffset);
+    auto end = std::min(last, pieceOffset + pieceLength_);
+    openFile();
+    diskWriter_->writeData(data + (first - offset), end - first,
+                           getPieceOffset(*i) + (first - pieceOffset));
+  }
+}
+
+void PartsStore::readData(unsigned char* data, size_t len, int64_t offset)
+{
+  memset(data, 0, len);
+  auto last = offset + static_cast<int64_t>(len);
+  for (auto i = std::lower_bound(std::begin(pieces_), std::end(pieces_),
+                                 offset / pieceLength_),
+            eoi = std::end(pieces_);
+       i != eoi && static_cast<int64_t>(*i) * pieceLength_ < last; ++i) {
+    int64_t pieceOffset = static_cast<int64_t>(*i) * pieceLength_;
+    auto first = std::max(offset, pieceOffset);
+    auto end = std::min(last, pieceOffset + pieceLength_);
+    openFile();
+    // A short read leaves zeros for the data not written yet.
+    diskWriter_->readData(data + (first - offset), end - first,
+                          getPieceOffset(*i) + (first - pieceOffset));
+  }
+}
+
+void PartsStore::openFile()
+{
+  if (!diskWriter_) {
+    diskWriter_ = make_unique<DefaultDiskWriter>(filename_);
+    diskWriter_->openFile();
+  }
+}
+
+void PartsStore::sync()
+{
+  if (diskWriter_) {
+    diskWriter_->sync();
+  }
+}
+
+void PartsStore::closeFile()
+{
+  if (diskWriter_) {
+    diskWriter_->closeFile();
+    diskWriter_.reset();
+  }
+}
+
+} // namespace aria2
@@ -0,0 +1,111 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_PARTS_STORE_H
+#define D_PARTS_STORE_H
+
+#include "common.h"
+
+#include <string>
+#include <vector>
+#include <memory>
+
+namespace aria2 {
+
+class DiskWriter;
+
+// Stores the pieces shared by selected and unselected files of a
+// multi-file download, so that the unselected files need not be
+// created.  The whole piece is stored, but only the data of the
+// unselected files are read from here.
+//
+// The file starts with the list of the stored piece indexes and the
+// list of the indexes of the files kept here, each of which is a
+// 4-byte count followed by 4-byte values in network byte order.
+// The pieces follow in the order of the list, pieceLength bytes
+// apart.
+class PartsStore {
+public:
+  PartsStore(std::string filename, int32_t pieceLength);
+  ~PartsStore();
+
+  // Reads the lists of the existing store.  Returns false if there is
+  // no usable store.
+  bool load();
+
+  // Makes the store hold |pieces| for |files|.  Both must be sorted.
+  // The data of the pieces already held are kept.  If |pieces| is
+  // empty, the store is removed.
+  void reset(std::vector<size_t> pieces, std::vector<size_t> files);
+
+  const std::vector<size_t>& getPieces() const { return pieces_; }
+
+  const std::vector<size_t>& getFiles() const { return files_; }
+
+  bool hasPiece(size_t index) const;
+
+  // Writes the part of [offset, offset + len) in the download which
+  // falls in the stored pieces.  The rest is discarded.
+  void writeData(const unsigned char* data, size_t len, int64_t offset);
+
+  // Reads [offset, offset + len) in the download.  The part which is
+  // not stored or not written yet is filled with zeros.
+  void readData(unsigned char* data, size_t len, int64_t offset);
+
+  void closeFile();
+
+  // Makes the data written so far durable.
+  void sync();
+
+  const std::string& getFilename() const { return filename_; }
+
+private:
+  void openFile();
+
+  // Returns the offset of the piece |index| in the store, or -1 if it
+  // is not stored.
+  int64_t getPieceOffset(size_t index) const;
+
+  std::string filename_;
+  int32_t pieceLength_;
+  std::vector<size_t> pieces_;
+  std::vector<size_t> files_;
+  // Offset of the first piece in the store.
+  int64_t dataOffset_;
+  std::unique_ptr<DiskWriter> diskWriter_;
+};
+
+} // namespace aria2
+
+#endif // D_PARTS_STORE_H
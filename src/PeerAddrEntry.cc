@@ -33,13 +33,20 @@
  */
 /* copyright --> */
 #include "PeerAddrEntry.h"
+
+#include <cstring>
+
 #include "wallclock.h"
+#include "bittorrent_helper.h"
+#include "A2STR.h"
+#include "a2netcompat.h"
 
 namespace aria2 {
 
 PeerAddrEntry::PeerAddrEntry(const std::string& ipaddr, uint16_t port,
                              Timer updated)
-    : ipaddr_(ipaddr), port_(port), lastUpdated_(updated)
+    : compactLength_(bittorrent::packcompact(compact_.data(), ipaddr, port)),
+      lastUpdated_(updated)
 {
 }
 
@@ -50,18 +57,38 @@ PeerAddrEntry::~PeerAddrEntry() = default;
 PeerAddrEntry& PeerAddrEntry::operator=(const PeerAddrEntry& c)
 {
   if (this != &c) {
-    ipaddr_ = c.ipaddr_;
-    port_ = c.port_;
+    compact_ = c.compact_;
+    compactLength_ = c.compactLength_;
     lastUpdated_ = c.lastUpdated_;
   }
   return *this;
 }
 
+std::string PeerAddrEntry::getIPAddress() const
+{
+  if (compactLength_ == 0) {
+    return A2STR::NIL;
+  }
+  int family = compactLength_ == COMPACT_LEN_IPV4 ? AF_INET : AF_INET6;
+  return bittorrent::unpackcompact(compact_.data(), family).first;
+}
+
+uint16_t PeerAddrEntry::getPort() const
+{
+  if (compactLength_ == 0) {
+    return 0;
+  }
+  uint16_t port;
+  memcpy(&port, compact_.data() + compactLength_ - 2, sizeof(port));
+  return ntohs(port);
+}
+
 void PeerAddrEntry::notifyUpdate() { lastUpdated_ = global::wallclock(); }
 
 bool PeerAddrEntry::operator==(const PeerAddrEntry& entry) const
 {
-  return ipaddr_ == entry.ipaddr_ && port_ == entry.port_;
+  return compactLength_ == entry.compactLength_ &&
+         memcmp(compact_.data(), entry.compact_.data(), compactLength_) == 0;
 }
 
 } // namespace aria2
@@ -38,16 +38,21 @@
 #include "common.h"
 
 #include <string>
+#include <array>
 
 #include "TimerA2.h"
+#include "BtConstants.h"
 
 namespace aria2 {
 
+// Peer address is stored in compact form (6 bytes for IPv4 and 18
+// bytes for IPv6), which is the form used in get_peers reply, to keep
+// the memory footprint small.
 class PeerAddrEntry {
 private:
-  std::string ipaddr_;
+  std::array<unsigned char, COMPACT_LEN_IPV6> compact_;
 
-  uint16_t port_;
+  uint8_t compactLength_;
 
   Timer lastUpdated_;
 
@@ -59,9 +64,13 @@ public:
 
   PeerAddrEntry& operator=(const PeerAddrEntry& c);
 
-  const std::string& getIPAddress() const { return ipaddr_; }
+  std::string getIPAddress() const;
 
-  uint16_t getPort() const { return port_; }
+  uint16_t getPort() const;
+
+  const unsigned char* getCompact() const { return compact_.data(); }
+
+  size_t getCompactLength() const { return compactLength_; }
 
   const Timer& getLastUpdated() const { return lastUpdated_; }
 
@@ -39,11 +39,11 @@ namespace aria2 {
 
 PeerStat::PeerStat(cuid_t cuid, const std::string& hostname,
                    const ::std::string& protocol)
-    : cuid_(cuid), hostname_(hostname), protocol_(protocol)
+    : cuid_(cuid), hostname_(hostname), protocol_(protocol), rtt_(0)
 {
 }
 
-PeerStat::PeerStat(cuid_t cuid) : cuid_(cuid) {}
+PeerStat::PeerStat(cuid_t cuid) : cuid_(cuid), rtt_(0) {}
 
 PeerStat::~PeerStat() = default;
 
@@ -38,6 +38,7 @@
 #include "common.h"
 
 #include <string>
+#include <chrono>
 
 #include "Command.h"
 #include "NetStat.h"
@@ -104,11 +105,17 @@ public:
 
   const std::string& getProtocol() const { return protocol_; }
 
+  // Round trip time of the connection.  0 means unknown.
+  const std::chrono::milliseconds& getRTT() const { return rtt_; }
+
+  void setRTT(std::chrono::milliseconds rtt) { rtt_ = std::move(rtt); }
+
 private:
   cuid_t cuid_;
   std::string hostname_;
   std::string protocol_;
   NetStat netStat_;
+  std::chrono::milliseconds rtt_;
 };
 
 } // namespace aria2
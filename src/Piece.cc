@@ -34,6 +34,7 @@
 /* copyright --> */
 #include "Piece.h"
 
+#include <algorithm>
 #include <array>
 #include <cassert>
 
@@ -297,6 +298,31 @@ void Piece::removeUser(cuid_t cuid)
   users_.erase(std::remove(users_.begin(), users_.end(), cuid), users_.end());
 }
 
+void Piece::addBlockRequester(size_t blockIndex, cuid_t cuid)
+{
+  auto e = std::make_pair(blockIndex, cuid);
+  if (std::find(blockRequesters_.begin(), blockRequesters_.end(), e) ==
+      blockRequesters_.end()) {
+    blockRequesters_.push_back(e);
+  }
+}
+
+void Piece::removeBlockRequester(size_t blockIndex, cuid_t cuid)
+{
+  blockRequesters_.erase(std::remove(blockRequesters_.begin(),
+                                     blockRequesters_.end(),
+                                     std::make_pair(blockIndex, cuid)),
+                         blockRequesters_.end());
+}
+
+size_t Piece::countBlockRequester(size_t blockIndex) const
+{
+  return std::count_if(blockRequesters_.begin(), blockRequesters_.end(),
+                       [blockIndex](const std::pair<size_t, cuid_t>& e) {
+                         return e.first == blockIndex;
+                       });
+}
+
 void Piece::initWrCache(WrDiskCache* diskCache,
                         const std::shared_ptr<DiskAdaptor>& diskAdaptor)
 {
@@ -59,6 +59,10 @@ private:
   std::unique_ptr<WrDiskCacheEntry> wrCache_;
   std::unique_ptr<MessageDigest> mdctx_;
   std::vector<cuid_t> users_;
+  // Pairs of block index and cuid which has an outstanding request
+  // for the block.  In end game mode, one block may be requested by
+  // several connections.
+  std::vector<std::pair<size_t, cuid_t>> blockRequesters_;
   std::string hashType_;
 
   size_t index_;
@@ -174,6 +178,14 @@ public:
   bool getUsedBySegment() const { return usedBySegment_; }
   void setUsedBySegment(bool f) { usedBySegment_ = f; }
 
+  // Records that |cuid| has an outstanding request for the block
+  // |blockIndex|.
+  void addBlockRequester(size_t blockIndex, cuid_t cuid);
+  void removeBlockRequester(size_t blockIndex, cuid_t cuid);
+  // Returns the number of connections which have an outstanding
+  // request for the block |blockIndex|.
+  size_t countBlockRequester(size_t blockIndex) const;
+
   void initWrCache(WrDiskCache* diskCache,
                    const std::shared_ptr<DiskAdaptor>& diskAdaptor);
   void flushWrCache(WrDiskCache* diskCache);
@@ -52,6 +52,7 @@ class Peer;
 #endif // ENABLE_BITTORRENT
 class DiskAdaptor;
 class WrDiskCache;
+class RdDiskCache;
 
 class PieceStorage {
 public:
@@ -206,6 +207,13 @@ public:
    */
   virtual void initStorage() = 0;
 
+  /**
+   * Opens the files again at the current paths of the file entries,
+   * after they were moved.  The files are complete, and opened in
+   * read-only mode.  Files must be closed.
+   */
+  virtual void reopenStorage() = 0;
+
   virtual const unsigned char* getBitfield() = 0;
 
   virtual void setBitfield(const unsigned char* bitfield,
@@ -222,13 +230,27 @@ public:
   // TODO We can remove this.
   virtual void setEndGamePieceNum(size_t num) = 0;
 
+  // Adds |length| bytes to the amount of block data which was
+  // downloaded more than once in end game mode.
+  virtual void addEndGameDuplicateLength(int64_t length) = 0;
+
+  virtual int64_t getEndGameDuplicateLength() = 0;
+
   virtual std::shared_ptr<DiskAdaptor> getDiskAdaptor() = 0;
 
   virtual WrDiskCache* getWrDiskCache() = 0;
 
+  // Returns the cache for reading pieces to upload, or nullptr if it
+  // is disabled.
+  virtual RdDiskCache* getRdDiskCache() = 0;
+
   // Flushes write disk cache for in-flight piece and evicts them.
   virtual void flushWrDiskCacheEntry() = 0;
 
+  // Writes the data in write disk cache to the files, keeping the
+  // cache entries, and makes the files durable.
+  virtual void syncData() = 0;
+
   virtual int32_t getPieceLength(size_t index) = 0;
 
   /**
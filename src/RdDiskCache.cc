@@ -0,0 +1,152 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "RdDiskCache.h"
+
+#include <cstring>
+#include <limits>
+#include <algorithm>
+
+#include "DiskAdaptor.h"
+#include "LogFactory.h"
+#include "fmt.h"
+
+namespace aria2 {
+
+RdDiskCache::RdDiskCache(size_t limit)
+    : limit_(limit), total_(0), protectedTotal_(0), hits_(0), misses_(0)
+{
+}
+
+ssize_t RdDiskCache::readData(unsigned char* data, size_t len, a2_gid_t gid,
+                              size_t index, int32_t begin, int64_t pieceOffset,
+                              int32_t pieceLength, DiskAdaptor* diskAdaptor)
+{
+  auto key = std::make_pair(gid, index);
+  auto i = entries_.find(key);
+  if (i != std::end(entries_)) {
+    auto& ent = (*i).second;
+    if (ent.begin <= begin && begin + len <= ent.begin + ent.data.size()) {
+      ++hits_;
+      memcpy(data, ent.data.data() + (begin - ent.begin), len);
+      promote(ent);
+      return len;
+    }
+    // The requested block precedes the cached part.  Read the piece
+    // again from there.
+    erase(i);
+  }
+
+  ++misses_;
+  size_t readAhead = pieceLength - begin;
+  if (readAhead <= len || readAhead > limit_) {
+    return diskAdaptor->readData(data, len, pieceOffset + begin);
+  }
+
+  Entry ent;
+  ent.begin = begin;
+  ent.data.resize(readAhead);
+  auto nread =
+      diskAdaptor->readData(ent.data.data(), readAhead, pieceOffset + begin);
+  if (nread < static_cast<ssize_t>(len)) {
+    memcpy(data, ent.data.data(), std::max(nread, static_cast<ssize_t>(0)));
+    return nread;
+  }
+  ent.data.resize(nread);
+  ent.hot = false;
+  memcpy(data, ent.data.data(), len);
+
+  A2_LOG_DEBUG(fmt("Read ahead %ld bytes of piece index=%lu",
+                   static_cast<long>(nread),
+                   static_cast<unsigned long>(index)));
+  total_ += ent.data.size();
+  probation_.push_front(key);
+  ent.pos = std::begin(probation_);
+  entries_.emplace(key, std::move(ent));
+  ensureLimit();
+  return len;
+}
+
+void RdDiskCache::promote(Entry& ent)
+{
+  if (ent.hot) {
+    protected_.splice(std::begin(protected_), protected_, ent.pos);
+    return;
+  }
+  protected_.splice(std::begin(protected_), probation_, ent.pos);
+  ent.hot = true;
+  protectedTotal_ += ent.data.size();
+  // Demote the least recently used protected entries to keep room for
+  // new pieces.
+  while (protectedTotal_ > limit_ / 4 * 3 && protected_.size() > 1) {
+    auto& victim = (*entries_.find(protected_.back())).second;
+    probation_.splice(std::begin(probation_), protected_, victim.pos);
+    victim.hot = false;
+    protectedTotal_ -= victim.data.size();
+  }
+}
+
+void RdDiskCache::erase(std::map<Key, Entry>::iterator i)
+{
+  auto& ent = (*i).second;
+  if (ent.hot) {
+    protected_.erase(ent.pos);
+    protectedTotal_ -= ent.data.size();
+  }
+  else {
+    probation_.erase(ent.pos);
+  }
+  total_ -= ent.data.size();
+  entries_.erase(i);
+}
+
+void RdDiskCache::remove(a2_gid_t gid)
+{
+  auto first = entries_.lower_bound(std::make_pair(gid, 0));
+  auto last = entries_.upper_bound(
+      std::make_pair(gid, std::numeric_limits<size_t>::max()));
+  while (first != last) {
+    erase(first++);
+  }
+}
+
+void RdDiskCache::ensureLimit()
+{
+  while (total_ > limit_) {
+    auto& victims = probation_.empty() ? protected_ : probation_;
+    erase(entries_.find(victims.back()));
+  }
+}
+
+} // namespace aria2
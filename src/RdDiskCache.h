@@ -0,0 +1,117 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_RD_DISK_CACHE_H
+#define D_RD_DISK_CACHE_H
+
+#include "common.h"
+
+#include <map>
+#include <list>
+#include <vector>
+
+#include "GroupId.h"
+
+namespace aria2 {
+
+class DiskAdaptor;
+
+// Caches pieces read from the disk for uploading, shared by all
+// downloads.  When a block of a piece is not cached, the rest of the
+// piece is read ahead in one go, since peers usually request the
+// blocks of a piece in order.
+//
+// A piece read once is kept in the probationary segment.  If it is
+// read again, it moves to the protected segment, which takes up to
+// 3/4 of the cache.  Pieces are evicted from the probationary segment
+// first, so that a burst of pieces requested only once does not
+// flush the popular ones.
+class RdDiskCache {
+public:
+  RdDiskCache(size_t limit);
+
+  // Reads |len| bytes at |begin| in the piece |index| of the download
+  // |gid| into |data|.  The piece starts at |pieceOffset| in
+  // |diskAdaptor| and its length is |pieceLength|.  Returns the number
+  // of bytes read.
+  ssize_t readData(unsigned char* data, size_t len, a2_gid_t gid,
+                   size_t index, int32_t begin, int64_t pieceOffset,
+                   int32_t pieceLength, DiskAdaptor* diskAdaptor);
+
+  // Drops all cached pieces of the download |gid|.
+  void remove(a2_gid_t gid);
+
+  size_t getSize() const { return total_; }
+
+  uint64_t getHits() const { return hits_; }
+
+  uint64_t getMisses() const { return misses_; }
+
+private:
+  typedef std::pair<a2_gid_t, size_t> Key;
+
+  struct Entry {
+    // Offset of data in the piece.
+    int32_t begin;
+    std::vector<unsigned char> data;
+    // True if the entry is in the protected segment.
+    bool hot;
+    std::list<Key>::iterator pos;
+  };
+
+  void erase(std::map<Key, Entry>::iterator i);
+
+  // Moves the entry |ent| to the front of the protected segment.
+  void promote(Entry& ent);
+
+  // Evicts entries so that the total size is kept under the limit.
+  void ensureLimit();
+
+  std::map<Key, Entry> entries_;
+  // The most recently used first.
+  std::list<Key> probation_;
+  std::list<Key> protected_;
+  // Maximum number of bytes the storage can cache.
+  size_t limit_;
+  // Current number of bytes cached.
+  size_t total_;
+  // Number of bytes cached in the protected segment.
+  size_t protectedTotal_;
+  uint64_t hits_;
+  uint64_t misses_;
+};
+
+} // namespace aria2
+
+#endif // D_RD_DISK_CACHE_H
@@ -41,6 +41,7 @@
 
 #include "TimerA2.h"
 #include "uri.h"
+#include "Command.h"
 
 namespace aria2 {
 
@@ -67,6 +68,8 @@ private:
   bool keepAliveHint_;
   // enable pipelining if possible.
   bool pipeliningHint_;
+  // true if the next connection must not use pipelining
+  bool pipeliningSuspended_;
   // maximum number of pipelined requests
   int maxPipelinedRequest_;
   std::shared_ptr<PeerStat> peerStat_;
@@ -133,6 +136,22 @@ public:
 
   bool isPipeliningHint() const { return pipeliningHint_; }
 
+  // Disables pipelining for the current and the next connection,
+  // after a pipelined response failed for a reason which may be
+  // transient.
+  void suspendPipelining()
+  {
+    pipeliningHint_ = false;
+    pipeliningSuspended_ = true;
+  }
+
+  bool isPipeliningSuspended() const { return pipeliningSuspended_; }
+
+  void setPipeliningSuspended(bool suspended)
+  {
+    pipeliningSuspended_ = suspended;
+  }
+
   void setMaxPipelinedRequest(int num);
 
   int getMaxPipelinedRequest() const { return maxPipelinedRequest_; }
@@ -150,7 +169,8 @@ public:
 
   const std::shared_ptr<PeerStat>& getPeerStat() const { return peerStat_; }
 
-  const std::shared_ptr<PeerStat>& initPeerStat();
+  // Creates new PeerStat for the command whose CUID is cuid.
+  const std::shared_ptr<PeerStat>& initPeerStat(cuid_t cuid);
 
   void requestRemoval() { removalRequested_ = true; }
 
@@ -81,6 +81,13 @@
 #include "RequestGroupCriteria.h"
 #include "CheckIntegrityCommand.h"
 #include "ChecksumCheckIntegrityEntry.h"
+#include "ConnectionTuner.h"
+#include "RdDiskCache.h"
+#include "NetStat.h"
+#include "FileCopier.h"
+#include "MoveCompletedFilesCommand.h"
+#include "Notifier.h"
+#include "SingletonHolder.h"
 #ifdef ENABLE_BITTORRENT
 #  include "bittorrent_helper.h"
 #  include "BtRegistry.h"
@@ -152,7 +159,9 @@ RequestGroup::RequestGroup(const std::shared_ptr<GroupId>& gid,
       pauseRequested_(false),
       restartRequested_(false),
       inMemoryDownload_(false),
-      seedOnly_(false)
+      seedOnly_(false),
+      moveCompletedFilesRequested_(false),
+      completedFilesMoved_(false)
 {
   fileAllocationEnabled_ = option_->get(PREF_FILE_ALLOCATION) != V_NONE;
   if (!option_->getAsBool(PREF_DRY_RUN)) {
@@ -544,6 +553,14 @@ void RequestGroup::processCheckIntegrityEntry(
     // enableSaveControlFile() will be called after hash checking is
     // done. See CheckIntegrityCommand.
     disableSaveControlFile();
+    auto diskAdaptor = pieceStorage_->getDiskAdaptor();
+    // Complete files opened in read-only mode are hashed directly
+    // from the mapped memory.
+    if (option_->getAsBool(PREF_ENABLE_MMAP) &&
+        diskAdaptor->isReadOnlyEnabled() &&
+        actualFileSize <= option_->getAsLLInt(PREF_MAX_MMAP_LIMIT)) {
+      diskAdaptor->enableMmap();
+    }
     e->getCheckIntegrityMan()->pushEntry(std::move(entry));
     return;
   }
@@ -596,6 +613,7 @@ void RequestGroup::initPieceStorage()
 #endif // !ENABLE_BITTORRENT
     if (requestGroupMan_) {
       ps->setWrDiskCache(requestGroupMan_->getWrDiskCache());
+      ps->setRdDiskCache(requestGroupMan_->getRdDiskCache());
     }
     if (diskWriterFactory_) {
       ps->setDiskWriterFactory(diskWriterFactory_);
@@ -954,6 +972,69 @@ void RequestGroup::validateTotalLength(int64_t actualTotalLength) const
   validateTotalLength(getTotalLength(), actualTotalLength);
 }
 
+void RequestGroup::tuneConnections(DownloadEngine* e,
+                                   const std::chrono::seconds& interval)
+{
+  int maxConnections = option_->getAsInt(PREF_AUTO_SPLIT);
+  if (maxConnections == 0 || !segmentMan_ || getTotalLength() == 0 ||
+      downloadFinished() || isHaltRequested()) {
+    if (connectionTuner_) {
+      connectionTuner_.reset();
+      numConcurrentCommand_ = option_->getAsInt(PREF_SPLIT);
+    }
+    return;
+  }
+  if (!connectionTuner_) {
+    // Metalink maxconnections and internal downloads restrict the
+    // number of connections below --split.  Respect them.
+    if (numConcurrentCommand_ < option_->getAsInt(PREF_SPLIT)) {
+      return;
+    }
+    connectionTuner_ = make_unique<ConnectionTuner>();
+  }
+  int speed = downloadContext_->getNetStat().calculateNewestDownloadSpeed(
+      interval.count());
+  int next = connectionTuner_->update(numStreamCommand_, speed,
+                                      maxConnections);
+  if (next != numConcurrentCommand_) {
+    A2_LOG_INFO(fmt("GID#%s - Tuned the number of connections: %d -> %d"
+                    " (%d connections, %d bytes/sec)",
+                    gid_->toHex().c_str(), numConcurrentCommand_, next,
+                    numStreamCommand_, speed));
+    numConcurrentCommand_ = next;
+  }
+  if (numConcurrentCommand_ > numStreamCommand_) {
+    std::vector<std::unique_ptr<Command>> commands;
+    createNextCommand(commands, e);
+    e->addCommand(std::move(commands));
+  }
+}
+
+void RequestGroup::notifyServerBusy()
+{
+  if (!connectionTuner_) {
+    return;
+  }
+  // Back off now rather than at the next round, so that surplus
+  // connections are closed at their next segment boundary.  Several
+  // connections may see 503 at once; halve only once for them.
+  int next = connectionTuner_->notifyServerBusy(numStreamCommand_);
+  if (next < numConcurrentCommand_) {
+    A2_LOG_INFO(fmt("GID#%s - Server is busy.  Reduced the number of"
+                    " connections: %d -> %d",
+                    gid_->toHex().c_str(), numConcurrentCommand_, next));
+    numConcurrentCommand_ = next;
+  }
+}
+
+bool RequestGroup::shouldShedConnection(cuid_t cuid) const
+{
+  if (!connectionTuner_ || numStreamCommand_ <= numConcurrentCommand_) {
+    return false;
+  }
+  return !segmentMan_ || segmentMan_->isSlowestConnection(cuid);
+}
+
 void RequestGroup::increaseStreamCommand() { ++numStreamCommand_; }
 
 void RequestGroup::decreaseStreamCommand() { --numStreamCommand_; }
@@ -1029,6 +1110,10 @@ void RequestGroup::releaseRuntimeResource(DownloadEngine* e)
 #endif // ENABLE_BITTORRENT
   if (pieceStorage_) {
     pieceStorage_->removeAdvertisedPiece(Timer::zero());
+    auto rdDiskCache = pieceStorage_->getRdDiskCache();
+    if (rdDiskCache) {
+      rdDiskCache->remove(gid_->getNumericId());
+    }
   }
   // Don't reset segmentMan_ and pieceStorage_ here to provide
   // progress information via RPC
@@ -1037,6 +1122,10 @@ void RequestGroup::releaseRuntimeResource(DownloadEngine* e)
   // Reset seedOnly_, so that we can handle pause/unpause-ing seeding
   // torrent with --bt-detach-seed-only.
   seedOnly_ = false;
+  // The files which were not moved are moved when the download stops
+  // next time.
+  moveCompletedFilesRequested_ = false;
+  completedFilesMoved_ = false;
 }
 
 void RequestGroup::preDownloadProcessing()
@@ -1249,6 +1338,181 @@ void RequestGroup::applyLastModifiedTimeToLocalFiles()
                   static_cast<unsigned long>(n)));
 }
 
+namespace {
+// Returns the path under |dest| which has the same relative path to
+// |dest| as |path| to |dir|.
+std::string getCompletedPath(const std::string& path, const std::string& dir,
+                             const std::string& dest)
+{
+  auto prefix = util::applyDir(dir, "");
+  if (util::startsWith(path, prefix)) {
+    return util::applyDir(dest, path.substr(prefix.size()));
+  }
+  return util::applyDir(dest, File(path).getBasename());
+}
+} // namespace
+
+bool RequestGroup::moveCompletedFiles(DownloadEngine* e)
+{
+  bool seeding = moveCompletedFilesRequested_;
+  moveCompletedFilesRequested_ = false;
+  if (!pieceStorage_ || inMemoryDownload_ || completedFilesMoved_ ||
+      option_->blank(PREF_COMPLETED_DIR) || option_->getAsBool(PREF_DRY_RUN)) {
+    if (seeding) {
+      onBtDownloadComplete();
+    }
+    return false;
+  }
+  completedFilesMoved_ = true;
+  if (seeding) {
+    pieceStorage_->getDiskAdaptor()->closeFile();
+  }
+  const auto& dir = option_->get(PREF_DIR);
+  const auto& dest = option_->get(PREF_COMPLETED_DIR);
+  // The base path of a single file download is the path of the file.
+  auto basePath = downloadContext_->getBasePath();
+  std::vector<std::unique_ptr<FileCopier>> copiers;
+  for (auto& fe : downloadContext_->getFileEntries()) {
+    if (!fe->isRequested() || fe->isPadFile()) {
+      continue;
+    }
+    auto path = getCompletedPath(fe->getPath(), dir, dest);
+    if (path == fe->getPath()) {
+      continue;
+    }
+    File f(fe->getPath());
+    File newFile(path);
+    if (newFile.exists() && !option_->getAsBool(PREF_ALLOW_OVERWRITE)) {
+      A2_LOG_ERROR(fmt("Failed to move %s: %s already exists",
+                       fe->getPath().c_str(), path.c_str()));
+      continue;
+    }
+    File parent(newFile.getDirname());
+    if (!parent.isDir()) {
+      parent.mkdirs();
+    }
+    if (!f.renameTo(path)) {
+      int errNum = errno;
+      if (errNum == EXDEV) {
+        copiers.push_back(make_unique<FileCopier>(fe->getPath(), path));
+        continue;
+      }
+      A2_LOG_ERROR(fmt("Failed to move %s to %s: %s", fe->getPath().c_str(),
+                       path.c_str(), util::safeStrerror(errNum).c_str()));
+      continue;
+    }
+    A2_LOG_INFO(fmt("Moved %s to %s", fe->getPath().c_str(), path.c_str()));
+    fe->setPath(path);
+  }
+  if (copiers.empty()) {
+    relocateToCompletedDir(basePath);
+    if (seeding) {
+      pieceStorage_->reopenStorage();
+      onBtDownloadComplete();
+    }
+    return false;
+  }
+  if (seeding) {
+    // Keep seeding from the current paths during the copy.
+    pieceStorage_->reopenStorage();
+  }
+  A2_LOG_NOTICE(fmt(_("Copying %lu file(s) of GID#%s to %s"),
+                    static_cast<unsigned long>(copiers.size()),
+                    gid_->toHex().c_str(), dest.c_str()));
+  e->addCommand(make_unique<MoveCompletedFilesCommand>(
+      e->newCUID(), this, e, std::move(copiers), seeding));
+  return true;
+}
+
+void RequestGroup::requestMoveCompletedFiles()
+{
+  moveCompletedFilesRequested_ = true;
+  if (requestGroupMan_) {
+    requestGroupMan_->requestQueueCheck();
+  }
+}
+
+void RequestGroup::finishMovingCompletedFiles(
+    const std::vector<std::unique_ptr<FileCopier>>& copiers,
+    bool reopenStorage)
+{
+  if (reopenStorage) {
+    pieceStorage_->getDiskAdaptor()->closeFile();
+  }
+  auto basePath = downloadContext_->getBasePath();
+  const auto& fileEntries = downloadContext_->getFileEntries();
+  for (auto& copier : copiers) {
+    if (!copier->finished()) {
+      continue;
+    }
+    auto fe = std::find_if(std::begin(fileEntries), std::end(fileEntries),
+                           [&copier](const std::shared_ptr<FileEntry>& fe) {
+                             return fe->getPath() == copier->getSrcPath();
+                           });
+    if (fe == std::end(fileEntries)) {
+      continue;
+    }
+    // A finished copy is already on the disk, so the source can go.
+    if (!File(copier->getSrcPath()).remove()) {
+      int errNum = errno;
+      A2_LOG_ERROR(fmt("Failed to remove %s: %s",
+                       copier->getSrcPath().c_str(),
+                       util::safeStrerror(errNum).c_str()));
+      File(copier->getDestPath()).remove();
+      continue;
+    }
+    A2_LOG_INFO(fmt("Moved %s to %s", copier->getSrcPath().c_str(),
+                    copier->getDestPath().c_str()));
+    (*fe)->setPath(copier->getDestPath());
+  }
+  relocateToCompletedDir(basePath);
+  if (reopenStorage) {
+    pieceStorage_->reopenStorage();
+    onBtDownloadComplete();
+  }
+}
+
+void RequestGroup::relocateToCompletedDir(const std::string& basePath)
+{
+  const auto& dir = option_->get(PREF_DIR);
+  const auto& dest = option_->get(PREF_COMPLETED_DIR);
+  auto newBasePath = getCompletedPath(basePath, dir, dest);
+  if (newBasePath == basePath) {
+    return;
+  }
+  auto prefix = util::applyDir(dest, "");
+  for (auto& fe : downloadContext_->getFileEntries()) {
+    if (fe->isRequested() && !fe->isPadFile() &&
+        !util::startsWith(fe->getPath(), prefix)) {
+      return;
+    }
+  }
+  // The parts file holds a few pieces only, so that it is moved
+  // here even if it is copied.
+  File partsStore(basePath + ".parts");
+  if (partsStore.isFile() && !partsStore.moveTo(newBasePath + ".parts")) {
+    A2_LOG_ERROR(fmt("Failed to move %s", partsStore.getPath().c_str()));
+  }
+  downloadContext_->setBasePath(newBasePath);
+  option_->put(PREF_DIR, dest);
+  if (progressInfoFile_) {
+    File controlFile(progressInfoFile_->getFilename());
+    progressInfoFile_->updateFilename();
+    if (controlFile.isFile() &&
+        !controlFile.moveTo(progressInfoFile_->getFilename())) {
+      A2_LOG_ERROR(fmt("Failed to move %s", controlFile.getPath().c_str()));
+    }
+  }
+}
+
+void RequestGroup::onBtDownloadComplete()
+{
+  util::executeHookByOptName(this, option_.get(),
+                             PREF_ON_BT_DOWNLOAD_COMPLETE);
+  SingletonHolder<Notifier>::instance()->notifyDownloadEvent(
+      EVENT_ON_BT_DOWNLOAD_COMPLETE, this);
+}
+
 void RequestGroup::updateLastModifiedTime(const Time& time)
 {
   if (time.good() && lastModifiedTime_ < time) {
@@ -70,6 +70,8 @@ struct DownloadResult;
 class URISelector;
 class URIResult;
 class RequestGroupMan;
+class FileCopier;
+class ConnectionTuner;
 #ifdef ENABLE_BITTORRENT
 class BtRuntime;
 class PeerStorage;
@@ -113,6 +115,9 @@ private:
 
   std::unique_ptr<URISelector> uriSelector_;
 
+  // Adjusts numConcurrentCommand_ if --auto-split is used.
+  std::unique_ptr<ConnectionTuner> connectionTuner_;
+
   std::shared_ptr<MetadataInfo> metadataInfo_;
 
   RequestGroupMan* requestGroupMan_;
@@ -192,6 +197,18 @@ private:
 
   bool seedOnly_;
 
+  bool moveCompletedFilesRequested_;
+
+  // True after moveCompletedFiles() has run.
+  bool completedFilesMoved_;
+
+  // Makes the directory given by --completed-dir the new --dir of
+  // this download if all files are there.  |basePath| is the base
+  // path before the files were moved.
+  void relocateToCompletedDir(const std::string& basePath);
+
+  void onBtDownloadComplete();
+
   void validateFilename(const std::string& expectedFilename,
                         const std::string& actualFilename) const;
 
@@ -274,6 +291,23 @@ public:
 
   int getNumConcurrentCommand() const { return numConcurrentCommand_; }
 
+  // Adjusts the number of connections from the download speed of the
+  // last interval, and creates commands for added connections.  This
+  // is no-op unless --auto-split is given.
+  void tuneConnections(DownloadEngine* e,
+                       const std::chrono::seconds& interval);
+
+  // Tells that the server responded with 503 or 429, so that the
+  // number of connections is halved right away.
+  void notifyServerBusy();
+
+  // Returns true if the connection of the command cuid should be
+  // closed instead of being reused, because the number of connections
+  // exceeds what tuneConnections() or notifyServerBusy() chose.  The
+  // slowest connections are closed first.  This is checked when a
+  // command retries and when it finished a segment.
+  bool shouldShedConnection(cuid_t cuid) const;
+
   a2_gid_t getGID() const { return gid_->getNumericId(); }
 
   const std::shared_ptr<GroupId>& getGroupId() const { return gid_; }
@@ -412,6 +446,33 @@ public:
 
   void applyLastModifiedTimeToLocalFiles();
 
+  // Moves the requested files to the directory given by
+  // --completed-dir, keeping their paths relative to --dir.  Files
+  // must be closed unless requestMoveCompletedFiles() was called.  A
+  // file on another file system is copied by
+  // MoveCompletedFilesCommand, and true is returned; the move is
+  // finished by finishMovingCompletedFiles().  Files are moved once
+  // until the download is paused.
+  bool moveCompletedFiles(DownloadEngine* e);
+
+  // Called when a BitTorrent download completes.  The files are
+  // moved by RequestGroupMan while the download keeps seeding, and
+  // the hooks for the completion are executed after that.
+  void requestMoveCompletedFiles();
+
+  bool isMoveCompletedFilesRequested() const
+  {
+    return moveCompletedFilesRequested_;
+  }
+
+  // Removes the sources of the finished copies and points the file
+  // entries to the copies.  If all files are moved, the directory
+  // given by --completed-dir becomes the new --dir of this download
+  // and the control file follows it.
+  void finishMovingCompletedFiles(
+      const std::vector<std::unique_ptr<FileCopier>>& copiers,
+      bool reopenStorage);
+
   void updateLastModifiedTime(const Time& time);
 
   void increaseAndValidateFileNotFoundCount();
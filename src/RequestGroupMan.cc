@@ -78,6 +78,7 @@
 #include "Notifier.h"
 #include "PeerStat.h"
 #include "WrDiskCache.h"
+#include "RdDiskCache.h"
 #include "PieceStorage.h"
 #include "DiskAdaptor.h"
 #include "SimpleRandomizer.h"
@@ -123,7 +124,7 @@ RequestGroupMan::RequestGroupMan(
       removedLastErrorResult_(error_code::FINISHED),
       maxDownloadResult_(option->getAsInt(PREF_MAX_DOWNLOAD_RESULT)),
       openedFileCounter_(std::make_shared<OpenedFileCounter>(
-          this, option->getAsInt(PREF_BT_MAX_OPEN_FILES))),
+          option->getAsInt(PREF_BT_MAX_OPEN_FILES))),
       numStoppedTotal_(0)
 {
   setupOptimizeConcurrentDownloads();
@@ -350,6 +351,22 @@ public:
   bool operator()(const RequestGroupList::value_type& group)
   {
     if (group->getNumCommand() == 0) {
+      if (!group->isPauseRequested() && group->downloadFinished() &&
+          !group->getDownloadContext()->isChecksumVerificationNeeded()) {
+        try {
+          group->closeFile();
+          group->applyLastModifiedTimeToLocalFiles();
+          if (group->moveCompletedFiles(e_)) {
+            // The files are copied to another file system by a
+            // command.  This group is processed again after it
+            // finishes.
+            return false;
+          }
+        }
+        catch (RecoverableException& ex) {
+          A2_LOG_ERROR_EX(EX_EXCEPTION_CAUGHT, ex);
+        }
+      }
       collectStat(group);
       const std::shared_ptr<DownloadContext>& dctx =
           group->getDownloadContext();
@@ -378,7 +395,6 @@ public:
         }
         else if (group->downloadFinished() &&
                  !group->getDownloadContext()->isChecksumVerificationNeeded()) {
-          group->applyLastModifiedTimeToLocalFiles();
           group->reportDownloadFinished();
           if (group->allDownloadFinished() &&
               !group->getOption()->getAsBool(PREF_FORCE_SAVE)) {
@@ -474,6 +490,17 @@ public:
 
 void RequestGroupMan::removeStoppedGroup(DownloadEngine* e)
 {
+  // Completed BitTorrent downloads move their files while seeding.
+  for (auto& group : requestGroups_) {
+    if (group->isMoveCompletedFilesRequested()) {
+      try {
+        group->moveCompletedFiles(e);
+      }
+      catch (RecoverableException& ex) {
+        A2_LOG_ERROR_EX(EX_EXCEPTION_CAUGHT, ex);
+      }
+    }
+  }
   size_t numPrev = requestGroups_.size();
   requestGroups_.remove_if(ProcessStoppedRequestGroup(e, reservedGroups_));
   size_t numRemoved = numPrev - requestGroups_.size();
@@ -1054,6 +1081,15 @@ void RequestGroupMan::initWrDiskCache()
   }
 }
 
+void RequestGroupMan::initRdDiskCache()
+{
+  assert(!rdDiskCache_);
+  size_t limit = option_->getAsInt(PREF_DISK_READ_CACHE);
+  if (limit > 0) {
+    rdDiskCache_ = make_unique<RdDiskCache>(limit);
+  }
+}
+
 void RequestGroupMan::decreaseNumActive()
 {
   assert(numActive_ > 0);
@@ -60,6 +60,7 @@ class Option;
 class OutputFile;
 class UriListParser;
 class WrDiskCache;
+class RdDiskCache;
 class OpenedFileCounter;
 
 typedef IndexedList<a2_gid_t, std::shared_ptr<RequestGroup>> RequestGroupList;
@@ -121,6 +122,8 @@ private:
 
   std::unique_ptr<WrDiskCache> wrDiskCache_;
 
+  std::unique_ptr<RdDiskCache> rdDiskCache_;
+
   std::shared_ptr<OpenedFileCounter> openedFileCounter_;
 
   // The number of stopped downloads so far in total, including
@@ -347,6 +350,12 @@ public:
   // its value is 0, cache storage will not be initialized.
   void initWrDiskCache();
 
+  RdDiskCache* getRdDiskCache() const { return rdDiskCache_.get(); }
+
+  // Initializes RdDiskCache according to PREF_DISK_READ_CACHE option.
+  // If its value is 0, cache storage will not be initialized.
+  void initRdDiskCache();
+
   void setKeepRunning(bool flag) { keepRunning_ = flag; }
 
   bool getKeepRunning() const { return keepRunning_; }
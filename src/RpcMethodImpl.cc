@@ -69,6 +69,11 @@
 #include "MessageDigest.h"
 #include "message_digest_helper.h"
 #include "OpenedFileCounter.h"
+#include "RdDiskCache.h"
+#ifdef ENABLE_SSL
+#  include "SocketCore.h"
+#  include "TLSContext.h"
+#endif // ENABLE_SSL
 #ifdef ENABLE_BITTORRENT
 #  include "bittorrent_helper.h"
 #  include "BtRegistry.h"
@@ -145,8 +150,15 @@ const char KEY_NUM_WAITING[] = "numWaiting";
 const char KEY_NUM_STOPPED[] = "numStopped";
 const char KEY_NUM_ACTIVE[] = "numActive";
 const char KEY_NUM_STOPPED_TOTAL[] = "numStoppedTotal";
+const char KEY_READ_CACHE_HITS[] = "readCacheHits";
+const char KEY_READ_CACHE_MISSES[] = "readCacheMisses";
+const char KEY_READ_CACHE_SIZE[] = "readCacheSize";
+const char KEY_TLS_SESSION_HITS[] = "tlsSessionHits";
+const char KEY_TLS_SESSION_MISSES[] = "tlsSessionMisses";
 const char KEY_VERIFIED_LENGTH[] = "verifiedLength";
 const char KEY_VERIFY_PENDING[] = "verifyIntegrityPending";
+const char KEY_AVERAGE_DOWNLOAD_SPEED[] = "averageDownloadSpeed";
+const char KEY_DOWNLOAD_LENGTH[] = "downloadLength";
 } // namespace
 
 namespace {
@@ -1284,6 +1296,10 @@ std::unique_ptr<ValueBase> GetServersRpcMethod::process(const RpcRequest& req,
         serverEntry->put(KEY_CURRENT_URI, req->getCurrentUri());
         serverEntry->put(KEY_DOWNLOAD_SPEED,
                          util::itos(ps->calculateDownloadSpeed()));
+        serverEntry->put(KEY_AVERAGE_DOWNLOAD_SPEED,
+                         util::itos(ps->calculateAvgDownloadSpeed()));
+        serverEntry->put(KEY_DOWNLOAD_LENGTH,
+                         util::uitos(ps->getSessionDownloadLength()));
         servers->append(std::move(serverEntry));
       }
     }
@@ -1390,6 +1406,20 @@ GetGlobalStatRpcMethod::process(const RpcRequest& req, DownloadEngine* e)
   res->put(KEY_NUM_STOPPED, util::uitos(rgman->getDownloadResults().size()));
   res->put(KEY_NUM_STOPPED_TOTAL, util::uitos(rgman->getNumStoppedTotal()));
   res->put(KEY_NUM_ACTIVE, util::uitos(rgman->getRequestGroups().size()));
+  auto rdDiskCache = rgman->getRdDiskCache();
+  if (rdDiskCache) {
+    res->put(KEY_READ_CACHE_HITS, util::uitos(rdDiskCache->getHits()));
+    res->put(KEY_READ_CACHE_MISSES, util::uitos(rdDiskCache->getMisses()));
+    res->put(KEY_READ_CACHE_SIZE, util::uitos(rdDiskCache->getSize()));
+  }
+#ifdef ENABLE_SSL
+  auto& tlsContext = SocketCore::getClientTLSContext();
+  if (tlsContext) {
+    auto& cache = tlsContext->getSessionCache();
+    res->put(KEY_TLS_SESSION_HITS, util::uitos(cache.getHits()));
+    res->put(KEY_TLS_SESSION_MISSES, util::uitos(cache.getMisses()));
+  }
+#endif // ENABLE_SSL
   return std::move(res);
 }
 
@@ -1681,6 +1711,10 @@ void changeGlobalOption(const Option& option, DownloadEngine* e)
       // TODO no exception handling
     }
   }
+  if (option.defined(PREF_MAX_CONCURRENT_FILE_ALLOCATIONS)) {
+    e->getFileAllocationMan()->setMaxPicked(
+        option.getAsInt(PREF_MAX_CONCURRENT_FILE_ALLOCATIONS));
+  }
   if (option.defined(PREF_BT_MAX_OPEN_FILES)) {
     auto& openedFileCounter = e->getRequestGroupMan()->getOpenedFileCounter();
     openedFileCounter->setMaxOpenFiles(option.getAsInt(PREF_BT_MAX_OPEN_FILES));
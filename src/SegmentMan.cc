@@ -55,6 +55,7 @@
 #include "fmt.h"
 #include "WrDiskCacheEntry.h"
 #include "DownloadFailureException.h"
+#include "a2functional.h"
 
 namespace aria2 {
 
@@ -70,7 +71,9 @@ SegmentMan::SegmentMan(const std::shared_ptr<DownloadContext>& downloadContext,
     : downloadContext_(downloadContext),
       pieceStorage_(pieceStorage),
       ignoreBitfield_(downloadContext->getPieceLength(),
-                      downloadContext->getTotalLength())
+                      downloadContext->getTotalLength()),
+      fileFilterOffset_(0),
+      fileFilterLength_(0)
 {
   ignoreBitfield_.enableFilter();
 }
@@ -200,9 +203,59 @@ void SegmentMan::getInFlightSegment(
   }
 }
 
+bool SegmentMan::shouldYieldToFasterConnections(cuid_t cuid)
+{
+  if (downloadContext_->getTotalLength() == 0) {
+    return false;
+  }
+  auto ps = getPeerStat(cuid);
+  if (!ps) {
+    return false;
+  }
+  int speed = ps->calculateAvgDownloadSpeed();
+  if (speed == 0) {
+    return false;
+  }
+  int64_t totalSpeed = speed;
+  for (auto& e : peerStats_) {
+    if (e->getCuid() != cuid && e->getStatus() == NetStat::ACTIVE) {
+      totalSpeed += e->calculateAvgDownloadSpeed();
+    }
+  }
+  if (totalSpeed == speed) {
+    return false;
+  }
+  int64_t remaining;
+  if (pieceStorage_->isSelectiveDownloadingMode()) {
+    remaining = pieceStorage_->getFilteredTotalLength() -
+                pieceStorage_->getFilteredCompletedLength();
+  }
+  else {
+    remaining =
+        pieceStorage_->getTotalLength() - pieceStorage_->getCompletedLength();
+  }
+  for (auto& e : usedSegmentEntries_) {
+    remaining -= e->segment->getLength() - e->segment->getWrittenLength();
+  }
+  // Compare the time this connection needs to download one segment
+  // with the time all connections need to download the rest.  A new
+  // segment costs a round trip before its first byte arrives, so a
+  // high latency connection yields earlier.  Use double to avoid
+  // overflow.
+  return static_cast<double>(downloadContext_->getPieceLength()) / speed +
+             ps->getRTT().count() / 1000.0 >
+         static_cast<double>(remaining) / totalSpeed;
+}
+
 std::shared_ptr<Segment> SegmentMan::getSegment(cuid_t cuid,
                                                 size_t minSplitSize)
 {
+  if (shouldYieldToFasterConnections(cuid)) {
+    A2_LOG_DEBUG(fmt("CUID#%" PRId64 " leaves remaining segments to"
+                     " faster connections",
+                     cuid));
+    return nullptr;
+  }
   std::shared_ptr<Piece> piece = pieceStorage_->getMissingPiece(
       minSplitSize, ignoreBitfield_.getFilterBitfield(),
       ignoreBitfield_.getBitfieldLength(), cuid);
@@ -214,9 +267,15 @@ void SegmentMan::getSegment(std::vector<std::shared_ptr<Segment>>& segments,
                             const std::shared_ptr<FileEntry>& fileEntry,
                             size_t maxSegments)
 {
-  BitfieldMan filter(ignoreBitfield_);
-  filter.enableFilter();
-  filter.addNotFilter(fileEntry->getOffset(), fileEntry->getLength());
+  if (!fileFilter_ || fileFilterOffset_ != fileEntry->getOffset() ||
+      fileFilterLength_ != fileEntry->getLength()) {
+    fileFilter_ = make_unique<BitfieldMan>(ignoreBitfield_);
+    fileFilter_->enableFilter();
+    fileFilter_->addNotFilter(fileEntry->getOffset(), fileEntry->getLength());
+    fileFilterOffset_ = fileEntry->getOffset();
+    fileFilterLength_ = fileEntry->getLength();
+  }
+  const auto& filter = *fileFilter_;
   std::vector<std::shared_ptr<Segment>> pending;
   while (segments.size() < maxSegments) {
     std::shared_ptr<Segment> segment = checkoutSegment(
@@ -282,6 +341,71 @@ std::shared_ptr<Segment> SegmentMan::getCleanSegmentIfOwnerIsIdle(cuid_t cuid,
   return nullptr;
 }
 
+namespace {
+// The thief must be at least this many times faster than the owner
+// of the segment.  Restarting a connection is not free, and we don't
+// want 2 connections of similar speed to steal segments from each
+// other.
+constexpr int STEAL_SPEED_FACTOR = 2;
+// The segment must have at least this many blocks left to be worth
+// stealing.
+constexpr int64_t STEAL_MIN_BLOCKS = 4;
+} // namespace
+
+std::shared_ptr<Segment> SegmentMan::stealSegment(cuid_t cuid)
+{
+  auto thiefStat = getPeerStat(cuid);
+  if (!thiefStat) {
+    return nullptr;
+  }
+  int thiefSpeed = thiefStat->calculateAvgDownloadSpeed();
+  if (thiefSpeed == 0) {
+    return nullptr;
+  }
+  std::shared_ptr<SegmentEntry> victim;
+  int victimSpeed = 0;
+  for (auto& e : usedSegmentEntries_) {
+    const auto& segment = e->segment;
+    // GrowSegment has unknown length.
+    if (e->cuid == cuid || segment->getLength() == 0 ||
+        segment->getLength() - segment->getWrittenLength() <
+            STEAL_MIN_BLOCKS * segment->getPiece()->getBlockLength()) {
+      continue;
+    }
+    // If the owner has several segments (pipelining), the remaining
+    // ones would shift under its feet.  Leave it alone.
+    if (std::count_if(usedSegmentEntries_.begin(), usedSegmentEntries_.end(),
+                      [&e](const std::shared_ptr<SegmentEntry>& x) {
+                        return x->cuid == e->cuid;
+                      }) != 1) {
+      continue;
+    }
+    auto ps = getPeerStat(e->cuid);
+    int speed = ps && ps->getStatus() == NetStat::ACTIVE
+                    ? ps->calculateAvgDownloadSpeed()
+                    : 0;
+    if (speed * STEAL_SPEED_FACTOR >= thiefSpeed) {
+      continue;
+    }
+    if (!victim || speed < victimSpeed ||
+        (speed == victimSpeed &&
+         segment->getWrittenLength() < victim->segment->getWrittenLength())) {
+      victim = e;
+      victimSpeed = speed;
+    }
+  }
+  if (!victim) {
+    return nullptr;
+  }
+  A2_LOG_INFO(fmt("CUID#%" PRId64 " steals segment#%lu from CUID#%" PRId64
+                  ", speed=%d, owner speed=%d",
+                  cuid, static_cast<unsigned long>(victim->segment->getIndex()),
+                  victim->cuid, thiefSpeed, victimSpeed));
+  size_t index = victim->segment->getIndex();
+  cancelSegment(victim->cuid);
+  return getSegmentWithIndex(cuid, index);
+}
+
 void SegmentMan::cancelSegmentInternal(cuid_t cuid,
                                        const std::shared_ptr<Segment>& segment)
 {
@@ -409,14 +533,32 @@ void SegmentMan::registerPeerStat(const std::shared_ptr<PeerStat>& peerStat)
 
 std::shared_ptr<PeerStat> SegmentMan::getPeerStat(cuid_t cuid) const
 {
-  for (auto& e : peerStats_) {
-    if (e->getCuid() == cuid) {
-      return e;
+  // A connection registers a new PeerStat each time it starts
+  // downloading.  Return the latest one.
+  for (auto i = peerStats_.rbegin(), eoi = peerStats_.rend(); i != eoi; ++i) {
+    if ((*i)->getCuid() == cuid) {
+      return *i;
     }
   }
   return nullptr;
 }
 
+bool SegmentMan::isSlowestConnection(cuid_t cuid) const
+{
+  int speed = 0;
+  auto ps = getPeerStat(cuid);
+  if (ps && ps->getStatus() == NetStat::ACTIVE) {
+    speed = ps->calculateDownloadSpeed();
+  }
+  for (auto& p : peerStats_) {
+    if (p->getCuid() != cuid && p->getStatus() == NetStat::ACTIVE &&
+        p->calculateDownloadSpeed() < speed) {
+      return false;
+    }
+  }
+  return true;
+}
+
 namespace {
 class PeerStatHostProtoEqual {
 private:
@@ -473,12 +615,14 @@ void SegmentMan::ignoreSegmentFor(const std::shared_ptr<FileEntry>& fileEntry)
                    fileEntry->getPath().c_str(), fileEntry->getOffset(),
                    fileEntry->getLength()));
   ignoreBitfield_.addFilter(fileEntry->getOffset(), fileEntry->getLength());
+  fileFilter_.reset();
 }
 
 void SegmentMan::recognizeSegmentFor(
     const std::shared_ptr<FileEntry>& fileEntry)
 {
   ignoreBitfield_.removeFilter(fileEntry->getOffset(), fileEntry->getLength());
+  fileFilter_.reset();
 }
 
 bool SegmentMan::allSegmentsIgnored() const
@@ -93,12 +93,27 @@ private:
 
   BitfieldMan ignoreBitfield_;
 
+  // ignoreBitfield_ plus the not-filter for the file range
+  // [fileFilterOffset_, fileFilterOffset_ + fileFilterLength_).
+  // Cached because building it for every getSegment() call is costly
+  // for large downloads.  Keyed by the range rather than by FileEntry
+  // address, which may be reused.  Reset when ignoreBitfield_ changes.
+  std::unique_ptr<BitfieldMan> fileFilter_;
+  int64_t fileFilterOffset_;
+  int64_t fileFilterLength_;
+
   std::shared_ptr<Segment> checkoutSegment(cuid_t cuid,
                                            const std::shared_ptr<Piece>& piece);
 
   void cancelSegmentInternal(cuid_t cuid,
                              const std::shared_ptr<Segment>& segment);
 
+  // Returns true if the command whose CUID is cuid should not take a
+  // new segment because the other, faster connections are expected
+  // to finish the remaining segments before it finishes one,
+  // including the round trip to request it.
+  bool shouldYieldToFasterConnections(cuid_t cuid);
+
 public:
   SegmentMan(const std::shared_ptr<DownloadContext>& downloadContext,
              const std::shared_ptr<PieceStorage>& pieceStorage);
@@ -130,6 +145,11 @@ public:
   void getInFlightSegment(std::vector<std::shared_ptr<Segment>>& segments,
                           cuid_t cuid);
 
+  // Returns a free segment for the command whose CUID is cuid.
+  // Segments are handed out in proportion to the download speed of
+  // each connection: near the end of the download, a connection
+  // which would take longer to finish a segment than the other
+  // connections need for all remaining segments gets nothing.
   std::shared_ptr<Segment> getSegment(cuid_t cuid, size_t minSplitSize);
 
   // Checkouts segments in the range of fileEntry and push back to
@@ -150,10 +170,21 @@ public:
   // Returns a currently used segment whose index is index and written
   // length is 0.  The current owner(in idle state) of segment cancels
   // the segment and cuid command acquires the ownership of the
-  // segment.  If no such segment exists, returns null.
+  // segment.  The owner is idle if it has no PeerStat registered or
+  // its PeerStat is not downloading; an owner which is still
+  // downloading keeps the segment.  If no such segment exists,
+  // returns null.
   std::shared_ptr<Segment> getCleanSegmentIfOwnerIsIdle(cuid_t cuid,
                                                         size_t index);
 
+  // Takes over the in-flight segment of the slowest connection if
+  // the command whose CUID is cuid is much faster than its owner.
+  // This is intended to be called when no free segment is left, so
+  // that a slow connection does not delay the completion of the
+  // download.  The owner notices that its segment is canceled and
+  // restarts.  If no segment is worth stealing, returns null.
+  std::shared_ptr<Segment> stealSegment(cuid_t cuid);
+
   /**
    * Updates download status.
    */
@@ -195,9 +226,8 @@ public:
    */
   int64_t getDownloadLength() const;
 
-  // If there is inactive PeerStat in peerStats_, it is replaced with
-  // given peerStat. If no such PeerStat exist, the given peerStat is
-  // inserted.
+  // Appends peerStat to peerStats_.  If a PeerStat with the same
+  // CUID is already registered, getPeerStat() returns the new one.
   void registerPeerStat(const std::shared_ptr<PeerStat>& peerStat);
 
   const std::vector<std::shared_ptr<PeerStat>>& getPeerStats() const
@@ -207,6 +237,11 @@ public:
 
   std::shared_ptr<PeerStat> getPeerStat(cuid_t cuid) const;
 
+  // Returns true if no other active connection is slower than the
+  // one of cuid.  A connection which is not downloading counts as
+  // speed 0.
+  bool isSlowestConnection(cuid_t cuid) const;
+
   // If there is slower PeerStat than given peerStat for the same
   // hostname and protocol in fastestPeerStats_, the former is
   // replaced with latter. If there are no PeerStat with same hostname
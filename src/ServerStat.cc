@@ -50,6 +50,10 @@ namespace {
 const char* STATUS_STRING[] = {"OK", "ERROR"};
 } // namespace
 
+namespace {
+const char* PIPELINING_STRING[] = {"UNKNOWN", "OK", "BROKEN"};
+} // namespace
+
 ServerStat::ServerStat(const std::string& hostname, const std::string& protocol)
     : hostname_(hostname),
       protocol_(protocol),
@@ -57,7 +61,9 @@ ServerStat::ServerStat(const std::string& hostname, const std::string& protocol)
       singleConnectionAvgSpeed_(0),
       multiConnectionAvgSpeed_(0),
       counter_(0),
-      status_(OK)
+      status_(OK),
+      pipelining_(PIPELINING_UNKNOWN),
+      pipeliningDepth_(0)
 {
 }
 
@@ -168,6 +174,43 @@ void ServerStat::setOK() { setStatusInternal(OK); }
 
 void ServerStat::setError() { setStatusInternal(A2_ERROR); }
 
+void ServerStat::setPipelining(PIPELINING pipelining)
+{
+  pipelining_ = pipelining;
+}
+
+void ServerStat::setPipelining(const std::string& pipelining)
+{
+  for (int i = 0; i < MAX_PIPELINING; ++i) {
+    if (strcmp(pipelining.c_str(), PIPELINING_STRING[i]) == 0) {
+      pipelining_ = static_cast<PIPELINING>(i);
+      break;
+    }
+  }
+}
+
+void ServerStat::setPipeliningDepth(int depth) { pipeliningDepth_ = depth; }
+
+void ServerStat::updatePipeliningDepth(int depth)
+{
+  if (pipelining_ == PIPELINING_BROKEN) {
+    return;
+  }
+  pipelining_ = PIPELINING_OK;
+  pipeliningDepth_ = depth;
+  lastUpdated_.reset();
+}
+
+void ServerStat::setPipeliningBroken()
+{
+  A2_LOG_INFO(fmt("ServerStat: %s (%s) does not handle HTTP pipelining."
+                  " Disabled pipelining for this server.",
+                  hostname_.c_str(), protocol_.c_str()));
+  pipelining_ = PIPELINING_BROKEN;
+  pipeliningDepth_ = 1;
+  lastUpdated_.reset();
+}
+
 bool ServerStat::operator<(const ServerStat& serverStat) const
 {
   return hostname_ < serverStat.hostname_ ||
@@ -182,12 +225,19 @@ bool ServerStat::operator==(const ServerStat& serverStat) const
 
 std::string ServerStat::toString() const
 {
-  return fmt("host=%s, protocol=%s, dl_speed=%d, sc_avg_speed=%d,"
-             " mc_avg_speed=%d, last_updated=%ld, counter=%d, status=%s",
-             getHostname().c_str(), getProtocol().c_str(), getDownloadSpeed(),
-             getSingleConnectionAvgSpeed(), getMultiConnectionAvgSpeed(),
-             getLastUpdated().getTimeFromEpoch(), getCounter(),
-             STATUS_STRING[getStatus()]);
+  auto s = fmt("host=%s, protocol=%s, dl_speed=%d, sc_avg_speed=%d,"
+               " mc_avg_speed=%d, last_updated=%ld, counter=%d, status=%s",
+               getHostname().c_str(), getProtocol().c_str(), getDownloadSpeed(),
+               getSingleConnectionAvgSpeed(), getMultiConnectionAvgSpeed(),
+               getLastUpdated().getTimeFromEpoch(), getCounter(),
+               STATUS_STRING[getStatus()]);
+  // Only written when known, so that the file stays readable by older
+  // versions and unchanged for servers never pipelined.
+  if (pipelining_ != PIPELINING_UNKNOWN) {
+    s += fmt(", pipelining=%s, pipelining_depth=%d",
+             PIPELINING_STRING[pipelining_], pipeliningDepth_);
+  }
+  return s;
 }
 
 } // namespace aria2
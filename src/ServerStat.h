@@ -52,6 +52,14 @@ class ServerStat {
 public:
   enum STATUS { OK = 0, A2_ERROR, MAX_STATUS };
 
+  // Whether the server is known to handle HTTP pipelining correctly.
+  enum PIPELINING {
+    PIPELINING_UNKNOWN = 0,
+    PIPELINING_OK,
+    PIPELINING_BROKEN,
+    MAX_PIPELINING
+  };
+
   ServerStat(const std::string& hostname, const std::string& protocol);
 
   ~ServerStat();
@@ -108,6 +116,34 @@ public:
   // set status ERROR and update lastUpdated_
   void setError();
 
+  PIPELINING getPipelining() const { return pipelining_; }
+
+  // This method doesn't update _lastUpdate.
+  void setPipelining(PIPELINING pipelining);
+
+  // pipelining should be one of the followings: "UNKNOWN", "OK",
+  // "BROKEN".  Giving other string will not change the pipelining
+  // status of this object.  This method doesn't update _lastUpdate.
+  void setPipelining(const std::string& pipelining);
+
+  bool isPipeliningBroken() const { return pipelining_ == PIPELINING_BROKEN; }
+
+  // The number of pipelined requests which worked for this server
+  // last time.  0 means unknown.
+  int getPipeliningDepth() const { return pipeliningDepth_; }
+
+  // This method doesn't update _lastUpdate.
+  void setPipeliningDepth(int depth);
+
+  // Records that depth pipelined requests were answered correctly
+  // and update lastUpdated_.  This is no-op if pipelining is already
+  // known to be broken.
+  void updatePipeliningDepth(int depth);
+
+  // Records that the server mishandled pipelined requests and update
+  // lastUpdated_.  Pipelining is not used for this server afterwards.
+  void setPipeliningBroken();
+
   bool operator<(const ServerStat& serverStat) const;
 
   bool operator==(const ServerStat& serverStat) const;
@@ -129,6 +165,10 @@ private:
 
   STATUS status_;
 
+  PIPELINING pipelining_;
+
+  int pipeliningDepth_;
+
   Time lastUpdated_;
 
   void setStatusInternal(STATUS status);
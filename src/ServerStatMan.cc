@@ -124,6 +124,8 @@ enum Field {
   S_HOST,
   S_LAST_UPDATED,
   S_MC_AVG_SPEED,
+  S_PIPELINING,
+  S_PIPELINING_DEPTH,
   S_PROTOCOL,
   S_SC_AVG_SPEED,
   S_STATUS,
@@ -131,8 +133,10 @@ enum Field {
 };
 
 const char* FIELD_NAMES[] = {
-    "counter",      "dl_speed", "host",         "last_updated",
-    "mc_avg_speed", "protocol", "sc_avg_speed", "status",
+    "counter",          "dl_speed",     "host",
+    "last_updated",     "mc_avg_speed", "pipelining",
+    "pipelining_depth", "protocol",     "sc_avg_speed",
+    "status",
 };
 } // namespace
 
@@ -225,6 +229,16 @@ bool ServerStatMan::load(const std::string& filename)
     }
     sstat->setLastUpdated(Time(intval));
     sstat->setStatus(m[S_STATUS]);
+    // Old serverstat file doesn't contains PIPELINING
+    if (!m[S_PIPELINING].empty()) {
+      sstat->setPipelining(m[S_PIPELINING]);
+      if (!m[S_PIPELINING_DEPTH].empty()) {
+        if (!util::parseIntNoThrow(intval, m[S_PIPELINING_DEPTH])) {
+          continue;
+        }
+        sstat->setPipeliningDepth(intval);
+      }
+    }
     add(sstat);
   }
   A2_LOG_NOTICE(fmt(MSG_SERVER_STAT_LOADED, filename.c_str()));
@@ -48,6 +48,7 @@
 #include <cassert>
 #include <sstream>
 #include <array>
+#include <algorithm>
 
 #include "message.h"
 #include "DlRetryEx.h"
@@ -168,6 +169,9 @@ void SocketCore::init()
 {
   blocking_ = true;
   secure_ = A2_TLS_NONE;
+#ifdef ENABLE_SSL
+  tlsSessionCachePort_ = 0;
+#endif // ENABLE_SSL
 
   wantRead_ = false;
   wantWrite_ = false;
@@ -635,8 +639,14 @@ void SocketCore::closeConnection()
 {
 #ifdef ENABLE_SSL
   if (tlsSession_) {
+    if (secure_ == A2_TLS_CONNECTED) {
+      // With TLS 1.3, a session ticket may have arrived after
+      // handshake.
+      saveTLSSession();
+    }
     tlsSession_->closeConnection();
     tlsSession_.reset();
+    tlsSessionCacheHost_.clear();
   }
 #endif // ENABLE_SSL
 
@@ -903,15 +913,16 @@ void SocketCore::readData(void* data, size_t& len)
 
 bool SocketCore::tlsAccept()
 {
-  return tlsHandshake(svTlsContext_.get(), A2STR::NIL);
+  return tlsHandshake(svTlsContext_.get(), A2STR::NIL, 0);
 }
 
-bool SocketCore::tlsConnect(const std::string& hostname)
+bool SocketCore::tlsConnect(const std::string& hostname, uint16_t port)
 {
-  return tlsHandshake(clTlsContext_.get(), hostname);
+  return tlsHandshake(clTlsContext_.get(), hostname, port);
 }
 
-bool SocketCore::tlsHandshake(TLSContext* tlsctx, const std::string& hostname)
+bool SocketCore::tlsHandshake(TLSContext* tlsctx, const std::string& hostname,
+                              uint16_t port)
 {
   wantRead_ = false;
   wantWrite_ = false;
@@ -941,6 +952,17 @@ bool SocketCore::tlsHandshake(TLSContext* tlsctx, const std::string& hostname)
                               tlsSession_->getLastErrorString().c_str()));
       }
     }
+    if (tlsctx->getSide() == TLS_CLIENT && !hostname.empty()) {
+      auto& cache = tlsctx->getSessionCache();
+      tlsSessionCacheHost_ = hostname;
+      tlsSessionCachePort_ = port;
+      auto data = cache.get(tlsSessionCacheHost_, tlsSessionCachePort_);
+      if (!data.empty() && tlsSession_->setSessionData(data) != TLS_ERR_OK) {
+        A2_LOG_DEBUG(fmt("Discarding unusable TLS session for %s",
+                         hostname.c_str()));
+        cache.remove(tlsSessionCacheHost_, tlsSessionCachePort_);
+      }
+    }
     // Done with the setup, now let handshaking begin immediately.
     secure_ = A2_TLS_HANDSHAKING;
     A2_LOG_DEBUG("TLS Handshaking");
@@ -990,8 +1012,17 @@ bool SocketCore::tlsHandshake(TLSContext* tlsctx, const std::string& hostname)
 
       auto peerInfo = ss.str();
 
-      A2_LOG_DEBUG(fmt("Securely connected to %s with %s", peerInfo.c_str(),
-                       tlsVersion.c_str()));
+      bool resumed = false;
+      if (!tlsSessionCacheHost_.empty()) {
+        resumed = tlsSession_->isSessionResumed();
+        tlsctx->getSessionCache().countHandshake(resumed);
+        saveTLSSession();
+      }
+
+      A2_LOG_DEBUG(fmt("Securely connected to %s with %s%s%s",
+                       peerInfo.c_str(), tlsVersion.c_str(),
+                       resumed ? " (session resumed)" : "",
+                       tlsSession_->isKTLSEnabled() ? " (kTLS)" : ""));
 
       // 2. We're connected now!
       secure_ = A2_TLS_CONNECTED;
@@ -1032,6 +1063,18 @@ bool SocketCore::tlsHandshake(TLSContext* tlsctx, const std::string& hostname)
   throw DL_ABORT_EX(fmt(EX_SSL_INIT_FAILURE, "Invalid state (this is a bug!)"));
 }
 
+void SocketCore::saveTLSSession()
+{
+  if (tlsSessionCacheHost_.empty() || !clTlsContext_) {
+    return;
+  }
+  auto data = tlsSession_->getSessionData();
+  if (!data.empty()) {
+    clTlsContext_->getSessionCache().put(tlsSessionCacheHost_,
+                                         tlsSessionCachePort_, std::move(data));
+  }
+}
+
 #endif // ENABLE_SSL
 
 #ifdef HAVE_LIBSSH2
@@ -1252,6 +1295,147 @@ ssize_t SocketCore::readDataFrom(void* data, size_t len, Endpoint& sender)
   return r;
 }
 
+size_t SocketCore::readDataFromBatch(Datagram* dgrams, size_t num)
+{
+  wantRead_ = false;
+  wantWrite_ = false;
+#ifdef HAVE_RECVMMSG
+  std::array<mmsghdr, A2_DATAGRAM_BATCH_MAX> msgs;
+  std::array<iovec, A2_DATAGRAM_BATCH_MAX> iovs;
+  num = std::min(num, msgs.size());
+  for (size_t i = 0; i < num; ++i) {
+    iovs[i].iov_base = dgrams[i].data;
+    iovs[i].iov_len = dgrams[i].capacity;
+    memset(&msgs[i], 0, sizeof(msgs[i]));
+    msgs[i].msg_hdr.msg_name = &dgrams[i].addr.su;
+    msgs[i].msg_hdr.msg_namelen = sizeof(dgrams[i].addr.su);
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  int r;
+  while ((r = recvmmsg(sockfd_, msgs.data(), num, 0, nullptr)) == -1 &&
+         A2_EINTR == SOCKET_ERRNO)
+    ;
+  int errNum = SOCKET_ERRNO;
+  if (r == -1) {
+    if (!A2_WOULDBLOCK(errNum)) {
+      throw DL_RETRY_EX(fmt(EX_SOCKET_RECV, errorMsg(errNum).c_str()));
+    }
+    wantRead_ = true;
+    return 0;
+  }
+  for (int i = 0; i < r; ++i) {
+    dgrams[i].length = msgs[i].msg_len;
+    dgrams[i].addr.suLength = msgs[i].msg_hdr.msg_namelen;
+  }
+  return r;
+#else  // !HAVE_RECVMMSG
+  size_t i = 0;
+  for (; i < num; ++i) {
+    auto& dg = dgrams[i];
+    socklen_t sockaddrlen = sizeof(dg.addr.su);
+    ssize_t r;
+    while ((r = recvfrom(sockfd_, reinterpret_cast<char*>(dg.data),
+                         dg.capacity, 0, &dg.addr.su.sa, &sockaddrlen)) ==
+               -1 &&
+           A2_EINTR == SOCKET_ERRNO)
+      ;
+    int errNum = SOCKET_ERRNO;
+    if (r == -1) {
+      if (!A2_WOULDBLOCK(errNum)) {
+        if (i == 0) {
+          throw DL_RETRY_EX(fmt(EX_SOCKET_RECV, errorMsg(errNum).c_str()));
+        }
+        break;
+      }
+      if (i == 0) {
+        wantRead_ = true;
+      }
+      break;
+    }
+    dg.length = r;
+    dg.addr.suLength = sockaddrlen;
+  }
+  return i;
+#endif // !HAVE_RECVMMSG
+}
+
+size_t SocketCore::writeDataToBatch(const Datagram* dgrams, size_t num)
+{
+  wantRead_ = false;
+  wantWrite_ = false;
+#ifdef HAVE_SENDMMSG
+  std::array<mmsghdr, A2_DATAGRAM_BATCH_MAX> msgs;
+  std::array<iovec, A2_DATAGRAM_BATCH_MAX> iovs;
+  num = std::min(num, msgs.size());
+  for (size_t i = 0; i < num; ++i) {
+    iovs[i].iov_base = dgrams[i].data;
+    iovs[i].iov_len = dgrams[i].length;
+    memset(&msgs[i], 0, sizeof(msgs[i]));
+    msgs[i].msg_hdr.msg_name = const_cast<sockaddr*>(&dgrams[i].addr.su.sa);
+    msgs[i].msg_hdr.msg_namelen = dgrams[i].addr.suLength;
+    msgs[i].msg_hdr.msg_iov = &iovs[i];
+    msgs[i].msg_hdr.msg_iovlen = 1;
+  }
+  int r;
+  while ((r = sendmmsg(sockfd_, msgs.data(), num, 0)) == -1 &&
+         A2_EINTR == SOCKET_ERRNO)
+    ;
+  int errNum = SOCKET_ERRNO;
+  if (r == -1) {
+    if (!A2_WOULDBLOCK(errNum)) {
+      throw DL_ABORT_EX(fmt(EX_SOCKET_SEND, errorMsg(errNum).c_str()));
+    }
+    wantWrite_ = true;
+    return 0;
+  }
+  if (static_cast<size_t>(r) < num) {
+    wantWrite_ = true;
+  }
+  return r;
+#else  // !HAVE_SENDMMSG
+  size_t i = 0;
+  for (; i < num; ++i) {
+    auto& dg = dgrams[i];
+    ssize_t r;
+    // Cast for Windows sendto()
+    while ((r = sendto(sockfd_, reinterpret_cast<const char*>(dg.data),
+                       dg.length, 0, &dg.addr.su.sa, dg.addr.suLength)) ==
+               -1 &&
+           A2_EINTR == SOCKET_ERRNO)
+      ;
+    int errNum = SOCKET_ERRNO;
+    if (r == -1) {
+      if (A2_WOULDBLOCK(errNum)) {
+        wantWrite_ = true;
+      }
+      else if (i == 0) {
+        throw DL_ABORT_EX(fmt(EX_SOCKET_SEND, errorMsg(errNum).c_str()));
+      }
+      break;
+    }
+  }
+  return i;
+#endif // !HAVE_SENDMMSG
+}
+
+SockAddr SocketCore::resolveDatagramAddr(const std::string& host,
+                                         uint16_t port) const
+{
+  struct addrinfo* res;
+  int s = callGetaddrinfo(&res, host.c_str(), util::uitos(port).c_str(),
+                          protocolFamily_, sockType_, 0, 0);
+  if (s) {
+    throw DL_ABORT_EX(fmt(EX_SOCKET_SEND, gai_strerror(s)));
+  }
+  std::unique_ptr<addrinfo, decltype(&freeaddrinfo)> resDeleter(res,
+                                                                freeaddrinfo);
+  SockAddr addr;
+  memcpy(&addr.su, res->ai_addr, res->ai_addrlen);
+  addr.suLength = res->ai_addrlen;
+  return addr;
+}
+
 std::string SocketCore::getSocketError() const
 {
   int error;
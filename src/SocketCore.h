@@ -93,13 +93,22 @@ private:
 
   std::shared_ptr<TLSSession> tlsSession_;
 
+  // The origin server used as a key of the TLS session cache of
+  // clTlsContext_.  Empty host means that the session is not cached.
+  std::string tlsSessionCacheHost_;
+  uint16_t tlsSessionCachePort_;
+
+  // Stores the current TLS session to the session cache.
+  void saveTLSSession();
+
   /**
    * Makes this socket secure. The connection must be established
    * before calling this method.
    *
    * If you are going to verify peer's certificate, hostname must be supplied.
    */
-  bool tlsHandshake(TLSContext* tlsctx, const std::string& hostname);
+  bool tlsHandshake(TLSContext* tlsctx, const std::string& hostname,
+                    uint16_t port);
 #endif // ENABLE_SSL
 
 #ifdef HAVE_LIBSSH2
@@ -285,6 +294,24 @@ public:
   // sender.addr will be numerihost assigned.
   ssize_t readDataFrom(void* data, size_t len, Endpoint& sender);
 
+  // Reads at most num datagrams into dgrams in one system call, using
+  // recvmmsg(2) if available.  Returns the number of datagrams read.
+  // If no datagram is available, returns 0 and wantRead_ is set.  A
+  // datagram longer than its capacity is truncated silently, just
+  // like readDataFrom().
+  size_t readDataFromBatch(Datagram* dgrams, size_t num);
+
+  // Sends at most num datagrams in dgrams in one system call, using
+  // sendmmsg(2) if available.  Returns the number of datagrams sent.
+  // If the socket buffer is full, stops sending, sets wantWrite_ and
+  // returns the number of datagrams sent so far.  Throws DlAbortEx if
+  // the first datagram cannot be sent for other reasons.
+  size_t writeDataToBatch(const Datagram* dgrams, size_t num);
+
+  // Resolves host and port to the address suitable for
+  // writeDataToBatch().  Throws DlAbortEx if it fails.
+  SockAddr resolveDatagramAddr(const std::string& host, uint16_t port) const;
+
 #ifdef ENABLE_SSL
   // Performs TLS server side handshake. If handshake is completed,
   // returns true. If handshake has not been done yet, returns false.
@@ -294,8 +321,10 @@ public:
   // returns true. If handshake has not been done yet, returns false.
   //
   // If you are going to verify peer's certificate, hostname must be
-  // supplied.
-  bool tlsConnect(const std::string& hostname);
+  // supplied.  hostname and port identify the origin server, and
+  // they are used as a key of the TLS session cache.  They are not
+  // necessarily the peer of this socket, which may be a proxy.
+  bool tlsConnect(const std::string& hostname, uint16_t port);
 #endif // ENABLE_SSL
 
 #ifdef HAVE_LIBSSH2
@@ -347,6 +376,10 @@ public:
   setClientTLSContext(const std::shared_ptr<TLSContext>& tlsContext);
   static void
   setServerTLSContext(const std::shared_ptr<TLSContext>& tlsContext);
+  static const std::shared_ptr<TLSContext>& getClientTLSContext()
+  {
+    return clTlsContext_;
+  }
 #endif // ENABLE_SSL
 
   static void setProtocolFamily(int protocolFamily)
@@ -39,6 +39,8 @@
 
 #include "common.h"
 
+#include "TLSSessionCache.h"
+
 namespace aria2 {
 
 enum TLSSessionSide { TLS_CLIENT, TLS_SERVER };
@@ -69,6 +71,18 @@ public:
   virtual TLSSessionSide getSide() const = 0;
   virtual bool getVerifyPeer() const = 0;
   virtual void setVerifyPeer(bool) = 0;
+
+  // Lets the kernel encrypt and decrypt records of sessions made with
+  // this context after handshake (kTLS), if the running kernel
+  // supports it.  Otherwise, the records are processed in userspace
+  // as usual.  Returns false if the backend cannot use kTLS at all.
+  virtual bool setKTLS(bool enable) { return false; }
+
+  // Sessions of client side connections made with this context.
+  TLSSessionCache& getSessionCache() { return sessionCache_; }
+
+private:
+  TLSSessionCache sessionCache_;
 };
 
 } // namespace aria2
@@ -36,6 +36,9 @@
 #define TLS_SESSION_H
 
 #include "common.h"
+
+#include <string>
+
 #include "a2netcompat.h"
 #include "TLSContext.h"
 
@@ -68,6 +71,26 @@ public:
   // succeeds, or TLS_ERR_ERROR.
   virtual int setSNIHostname(const std::string& hostname) = 0;
 
+  // Sets serialized session |data| previously obtained by
+  // getSessionData() to resume that session. This must be called
+  // before handshake. This function returns TLS_ERR_OK if it
+  // succeeds, or TLS_ERR_ERROR. Backends without session resumption
+  // support ignore |data|.
+  virtual int setSessionData(const std::string& data) { return TLS_ERR_OK; }
+
+  // Returns the current session serialized, or empty string if it is
+  // not available. With TLS 1.3, a resumable session is available
+  // only after the server sent a session ticket.
+  virtual std::string getSessionData() { return std::string(); }
+
+  // Returns true if the session was resumed by the last handshake.
+  virtual bool isSessionResumed() { return false; }
+
+  // Returns true if the kernel took over the record layer of this
+  // session in at least one direction.  Only meaningful after
+  // handshake.
+  virtual bool isKTLSEnabled() { return false; }
+
   // Closes the SSL/TLS session. Don't close underlying transport
   // socket. This function returns TLS_ERR_OK if it succeeds, or
   // TLS_ERR_ERROR.
@@ -0,0 +1,104 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#include "TLSSessionCache.h"
+
+#include "fmt.h"
+
+namespace aria2 {
+
+namespace {
+std::string makeKey(const std::string& host, uint16_t port)
+{
+  return fmt("%s:%u", host.c_str(), port);
+}
+} // namespace
+
+TLSSessionCache::TLSSessionCache(size_t maxSize)
+    : maxSize_(maxSize), hits_(0), misses_(0)
+{
+}
+
+void TLSSessionCache::put(const std::string& host, uint16_t port,
+                          std::string data)
+{
+  auto key = makeKey(host, port);
+  auto i = index_.find(key);
+  if (i != index_.end()) {
+    (*i).second->second = std::move(data);
+    entries_.splice(entries_.begin(), entries_, (*i).second);
+    return;
+  }
+  if (maxSize_ == 0) {
+    return;
+  }
+  if (entries_.size() >= maxSize_) {
+    index_.erase(entries_.back().first);
+    entries_.pop_back();
+  }
+  entries_.emplace_front(key, std::move(data));
+  index_.emplace(std::move(key), entries_.begin());
+}
+
+std::string TLSSessionCache::get(const std::string& host, uint16_t port)
+{
+  auto i = index_.find(makeKey(host, port));
+  if (i == index_.end()) {
+    return std::string();
+  }
+  entries_.splice(entries_.begin(), entries_, (*i).second);
+  return (*i).second->second;
+}
+
+void TLSSessionCache::remove(const std::string& host, uint16_t port)
+{
+  auto i = index_.find(makeKey(host, port));
+  if (i == index_.end()) {
+    return;
+  }
+  entries_.erase((*i).second);
+  index_.erase(i);
+}
+
+void TLSSessionCache::countHandshake(bool resumed)
+{
+  if (resumed) {
+    ++hits_;
+  }
+  else {
+    ++misses_;
+  }
+}
+
+} // namespace aria2
@@ -0,0 +1,88 @@
+/* <!-- copyright */
+/*
+ * aria2 - The high speed download utility
+ *
+ * Copyright (C) 2026 Tatsuhiro Tsujikawa
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA
+ *
+ * In addition, as a special exception, the copyright holders give
+ * permission to link the code of portions of this program with the
+ * OpenSSL library under certain conditions as described in each
+ * individual source file, and distribute linked combinations
+ * including the two.
+ * You must obey the GNU General Public License in all respects
+ * for all of the code used other than OpenSSL.  If you modify
+ * file(s) with this exception, you may extend this exception to your
+ * version of the file(s), but you are not obligated to do so.  If you
+ * do not wish to do so, delete this exception statement from your
+ * version.  If you delete this exception statement from all source
+ * files in the program, then also delete it here.
+ */
+/* copyright --> */
+#ifndef D_TLS_SESSION_CACHE_H
+#define D_TLS_SESSION_CACHE_H
+
+#include "common.h"
+
+#include <string>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+namespace aria2 {
+
+// Client side TLS session cache.  It maps "host:port" to the
+// serialized session (session ID or ticket) obtained from the last
+// connection to that endpoint, so that the next connection can resume
+// the session and skip the full handshake.  The number of entries is
+// bounded; the least recently used entry is evicted first.
+class TLSSessionCache {
+public:
+  TLSSessionCache(size_t maxSize = 256);
+
+  // Stores |data| for |host| and |port|, replacing the existing one.
+  void put(const std::string& host, uint16_t port, std::string data);
+
+  // Returns the session data for |host| and |port|, or empty string
+  // if there is none.
+  std::string get(const std::string& host, uint16_t port);
+
+  void remove(const std::string& host, uint16_t port);
+
+  // Records the result of a handshake: |resumed| is true if the
+  // session was resumed.
+  void countHandshake(bool resumed);
+
+  size_t size() const { return entries_.size(); }
+
+  uint64_t getHits() const { return hits_; }
+
+  uint64_t getMisses() const { return misses_; }
+
+private:
+  typedef std::list<std::pair<std::string, std::string>> Entries;
+
+  size_t maxSize_;
+  // Most recently used entry comes first.
+  Entries entries_;
+  std::unordered_map<std::string, Entries::iterator> index_;
+  uint64_t hits_;
+  uint64_t misses_;
+};
+
+} // namespace aria2
+
+#endif // D_TLS_SESSION_CACHE_H
@@ -34,11 +34,16 @@
 /* copyright --> */
 #include "UDPTrackerClient.h"
 
+#include <cinttypes>
+
 #include "UDPTrackerRequest.h"
 #include "bittorrent_helper.h"
 #include "util.h"
 #include "LogFactory.h"
 #include "SimpleRandomizer.h"
+#include "BufferedFile.h"
+#include "File.h"
+#include "TimeA2.h"
 #include "fmt.h"
 
 namespace aria2 {
@@ -56,6 +61,29 @@ void failRequest(InputIterator first, InputIterator last, int error)
 }
 } // namespace
 
+namespace {
+void failRequest(const UDPTrackerClient::InflightMap& reqs, int error)
+{
+  for (auto& e : reqs) {
+    e.second->state = UDPT_STA_COMPLETE;
+    e.second->error = error;
+  }
+}
+} // namespace
+
+namespace {
+// BEP15 says that a connection ID can be used for 1 minute.
+constexpr auto CONNECTION_ID_TIMEOUT = 1_min;
+} // namespace
+
+namespace {
+// A request which is not answered within RESEND_TIMEOUT is sent
+// again.  If the second one is not answered within REQUEST_TIMEOUT,
+// the request fails.
+constexpr auto RESEND_TIMEOUT = 5_s;
+constexpr auto REQUEST_TIMEOUT = 10_s;
+} // namespace
+
 namespace {
 uint32_t generateTransactionId()
 {
@@ -104,7 +132,7 @@ UDPTrackerClient::~UDPTrackerClient()
 {
   // Make all contained requests fail
   int error = UDPT_ERR_SHUTDOWN;
-  failRequest(inflightRequests_.begin(), inflightRequests_.end(), error);
+  failRequest(inflightRequests_, error);
   failRequest(pendingRequests_.begin(), pendingRequests_.end(), error);
   failRequest(connectRequests_.begin(), connectRequests_.end(), error);
 }
@@ -333,7 +361,7 @@ void UDPTrackerClient::requestSent(const Timer& now)
     break;
   }
   }
-  inflightRequests_.push_back(req);
+  addInflightRequest(req);
   pendingRequests_.pop_front();
 }
 
@@ -381,7 +409,7 @@ struct TimeoutCheck {
   {
     auto t = req->dispatched.difference(now);
     if (req->failCount == 0) {
-      if (t >= 5_s) {
+      if (t >= RESEND_TIMEOUT) {
         switch (req->action) {
         case UDPT_ACT_CONNECT:
           A2_LOG_INFO(fmt("UDPT resend CONNECT to %s:%u transaction_id=%08x",
@@ -409,7 +437,7 @@ struct TimeoutCheck {
       }
     }
     else {
-      if (t >= 10_s) {
+      if (t >= REQUEST_TIMEOUT) {
         switch (req->action) {
         case UDPT_ACT_CONNECT:
           A2_LOG_INFO(fmt("UDPT timeout CONNECT to %s:%u transaction_id=%08x",
@@ -454,25 +482,57 @@ struct TimeoutCheck {
 void UDPTrackerClient::handleTimeout(const Timer& now)
 {
   std::vector<std::shared_ptr<UDPTrackerRequest>> dest;
-  inflightRequests_.erase(std::remove_if(inflightRequests_.begin(),
-                                         inflightRequests_.end(),
-                                         TimeoutCheck(dest, this, now)),
-                          inflightRequests_.end());
+  TimeoutCheck check(dest, this, now);
+  // inflightRequests_ is sorted by deadline, so we can stop at the
+  // first request which is not expired yet.
+  for (auto i = inflightRequests_.begin();
+       i != inflightRequests_.end() && check((*i).second);) {
+    i = eraseInflightRequest(i);
+  }
   pendingRequests_.insert(pendingRequests_.begin(), dest.begin(), dest.end());
 }
 
+void UDPTrackerClient::addInflightRequest(
+    const std::shared_ptr<UDPTrackerRequest>& req)
+{
+  auto deadline = req->dispatched;
+  if (req->failCount == 0) {
+    deadline.advance(RESEND_TIMEOUT);
+  }
+  else {
+    deadline.advance(REQUEST_TIMEOUT);
+  }
+  auto i = inflightRequests_.emplace(std::move(deadline), req);
+  inflightIndex_.emplace(req->transactionId, i);
+}
+
+UDPTrackerClient::InflightMap::iterator
+UDPTrackerClient::eraseInflightRequest(InflightMap::iterator i)
+{
+  auto range = inflightIndex_.equal_range((*i).second->transactionId);
+  for (auto j = range.first; j != range.second; ++j) {
+    if ((*j).second == i) {
+      inflightIndex_.erase(j);
+      break;
+    }
+  }
+  return inflightRequests_.erase(i);
+}
+
 std::shared_ptr<UDPTrackerRequest>
 UDPTrackerClient::findInflightRequest(const std::string& remoteAddr,
                                       uint16_t remotePort,
                                       uint32_t transactionId, bool remove)
 {
   std::shared_ptr<UDPTrackerRequest> res;
-  for (auto i = inflightRequests_.begin(), eoi = inflightRequests_.end();
-       i != eoi; ++i) {
-    if ((*i)->remoteAddr == remoteAddr && (*i)->remotePort == remotePort &&
-        (*i)->transactionId == transactionId) {
-      res = *i;
+  auto range = inflightIndex_.equal_range(transactionId);
+  for (auto j = range.first; j != range.second; ++j) {
+    auto i = (*j).second;
+    if ((*i).second->remoteAddr == remoteAddr &&
+        (*i).second->remotePort == remotePort) {
+      res = (*i).second;
       if (remove) {
+        inflightIndex_.erase(j);
         inflightRequests_.erase(i);
       }
       break;
@@ -490,7 +550,7 @@ UDPTrackerClient::getConnectionId(const std::string& remoteAddr,
     return nullptr;
   }
   if ((*i).second.state == UDPT_CST_CONNECTED &&
-      (*i).second.lastUpdated.difference(now) > 1_min) {
+      (*i).second.lastUpdated.difference(now) > CONNECTION_ID_TIMEOUT) {
     connectionIdCache_.erase(i);
     return nullptr;
   }
@@ -543,7 +603,7 @@ void UDPTrackerClient::failConnect(const std::string& remoteAddr,
 void UDPTrackerClient::failAll()
 {
   int error = UDPT_ERR_SHUTDOWN;
-  failRequest(inflightRequests_.begin(), inflightRequests_.end(), error);
+  failRequest(inflightRequests_, error);
   failRequest(pendingRequests_.begin(), pendingRequests_.end(), error);
   failRequest(connectRequests_.begin(), connectRequests_.end(), error);
 }
@@ -552,6 +612,105 @@ void UDPTrackerClient::increaseWatchers() { ++numWatchers_; }
 
 void UDPTrackerClient::decreaseWatchers() { --numWatchers_; }
 
+bool UDPTrackerClient::saveConnectionIds(const std::string& filename,
+                                         const Timer& now) const
+{
+  std::string tempfile = filename;
+  tempfile += "__temp";
+  {
+    BufferedFile fp(tempfile.c_str(), BufferedFile::WRITE);
+    if (!fp) {
+      A2_LOG_ERROR(fmt("Failed to save UDP tracker connection IDs to %s.",
+                       filename.c_str()));
+      return false;
+    }
+    // Connection IDs are saved with the wall clock time at which they
+    // were obtained, since Timer does not survive restart.
+    auto epoch = Time().getTimeFromEpoch();
+    for (auto& e : connectionIdCache_) {
+      const auto& c = e.second;
+      auto age = c.lastUpdated.difference(now);
+      if (c.state != UDPT_CST_CONNECTED || age > CONNECTION_ID_TIMEOUT) {
+        continue;
+      }
+      auto updated =
+          static_cast<int64_t>(epoch) -
+          std::chrono::duration_cast<std::chrono::seconds>(age).count();
+      auto l = fmt("%s %u %" PRId64 " %" PRId64 "\n", e.first.first.c_str(),
+                   e.first.second, c.connectionId, updated);
+      if (fp.write(l.data(), l.size()) != l.size()) {
+        A2_LOG_ERROR(fmt("Failed to save UDP tracker connection IDs to %s.",
+                         filename.c_str()));
+        return false;
+      }
+    }
+    if (fp.close() == EOF) {
+      A2_LOG_ERROR(fmt("Failed to save UDP tracker connection IDs to %s.",
+                       filename.c_str()));
+      return false;
+    }
+  }
+  if (!File(tempfile).renameTo(filename)) {
+    A2_LOG_ERROR(fmt("Failed to save UDP tracker connection IDs to %s.",
+                     filename.c_str()));
+    return false;
+  }
+  A2_LOG_INFO(fmt("UDP tracker connection IDs were saved to %s.",
+                  filename.c_str()));
+  return true;
+}
+
+bool UDPTrackerClient::loadConnectionIds(const std::string& filename,
+                                         const Timer& now)
+{
+  BufferedFile fp(filename.c_str(), BufferedFile::READ);
+  if (!fp) {
+    A2_LOG_ERROR(fmt("Failed to load UDP tracker connection IDs from %s.",
+                     filename.c_str()));
+    return false;
+  }
+  auto epoch = static_cast<int64_t>(Time().getTimeFromEpoch());
+  size_t numLoaded = 0;
+  while (1) {
+    std::string line = fp.getLine();
+    if (line.empty()) {
+      if (fp.eof()) {
+        break;
+      }
+      else if (!fp) {
+        A2_LOG_ERROR(fmt("Failed to load UDP tracker connection IDs from %s.",
+                         filename.c_str()));
+        return false;
+      }
+      else {
+        continue;
+      }
+    }
+    std::vector<std::string> items;
+    util::split(line.begin(), line.end(), std::back_inserter(items), ' ');
+    uint32_t port;
+    int64_t connectionId, updated;
+    if (items.size() != 4 || !util::parseUIntNoThrow(port, items[1]) ||
+        port == 0 || port > UINT16_MAX ||
+        !util::parseLLIntNoThrow(connectionId, items[2]) ||
+        !util::parseLLIntNoThrow(updated, items[3])) {
+      continue;
+    }
+    auto age = std::chrono::seconds(epoch - updated);
+    if (age < 0_s || age > CONNECTION_ID_TIMEOUT) {
+      continue;
+    }
+    auto lastUpdated = now;
+    lastUpdated.sub(age);
+    connectionIdCache_[std::make_pair(items[0], static_cast<uint16_t>(port))] =
+        UDPTrackerConnection(UDPT_CST_CONNECTED, connectionId, lastUpdated);
+    ++numLoaded;
+  }
+  A2_LOG_INFO(fmt("Loaded %lu UDP tracker connection IDs from %s.",
+                  static_cast<unsigned long>(numLoaded), filename.c_str()));
+  return true;
+}
+
 ssize_t createUDPTrackerConnect(unsigned char* data, size_t length,
                                 std::string& remoteAddr, uint16_t& remotePort,
                                 const std::shared_ptr<UDPTrackerRequest>& req)
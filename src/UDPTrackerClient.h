@@ -40,6 +40,7 @@
 #include <string>
 #include <deque>
 #include <map>
+#include <unordered_map>
 #include <memory>
 
 #include "TimerA2.h"
@@ -71,6 +72,11 @@ struct UDPTrackerConnection {
 
 class UDPTrackerClient {
 public:
+  // Inflight requests, keyed by the time at which they are resent or
+  // time out.
+  typedef std::multimap<Timer, std::shared_ptr<UDPTrackerRequest>>
+      InflightMap;
+
   UDPTrackerClient();
   ~UDPTrackerClient();
 
@@ -109,11 +115,7 @@ public:
   {
     return connectRequests_;
   }
-  const std::deque<std::shared_ptr<UDPTrackerRequest>>&
-  getInflightRequests() const
-  {
-    return inflightRequests_;
-  }
+  const InflightMap& getInflightRequests() const { return inflightRequests_; }
 
   bool noRequest() const
   {
@@ -129,12 +131,25 @@ public:
   void increaseWatchers();
   void decreaseWatchers();
 
+  // Saves connection IDs which are still valid at |now| to
+  // |filename|.  Returns true if it succeeds.
+  bool saveConnectionIds(const std::string& filename, const Timer& now) const;
+
+  // Loads connection IDs saved by saveConnectionIds() from |filename|,
+  // so that announces after restart do not need CONNECT round trip.
+  // Expired entries are ignored.  Returns true if it succeeds.
+  bool loadConnectionIds(const std::string& filename, const Timer& now);
+
   // Actually private function, but made public, to be used by unnamed
   // function.
   void failConnect(const std::string& remoteAddr, uint16_t remotePort,
                    int error);
 
 private:
+  void addInflightRequest(const std::shared_ptr<UDPTrackerRequest>& req);
+
+  InflightMap::iterator eraseInflightRequest(InflightMap::iterator i);
+
   std::shared_ptr<UDPTrackerRequest>
   findInflightRequest(const std::string& remoteAddr, uint16_t remotePort,
                       uint32_t transactionId, bool remove);
@@ -144,7 +159,9 @@ private:
 
   std::map<std::pair<std::string, uint16_t>, UDPTrackerConnection>
       connectionIdCache_;
-  std::deque<std::shared_ptr<UDPTrackerRequest>> inflightRequests_;
+  InflightMap inflightRequests_;
+  // Index of inflightRequests_ by transaction ID.
+  std::unordered_multimap<uint32_t, InflightMap::iterator> inflightIndex_;
   std::deque<std::shared_ptr<UDPTrackerRequest>> pendingRequests_;
   std::deque<std::shared_ptr<UDPTrackerRequest>> connectRequests_;
   int numWatchers_;
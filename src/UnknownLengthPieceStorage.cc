@@ -71,6 +71,15 @@ void UnknownLengthPieceStorage::initStorage()
   diskAdaptor_ = std::move(directDiskAdaptor);
 }
 
+void UnknownLengthPieceStorage::reopenStorage()
+{
+  // DiskWriter keeps the path it was created with.
+  diskAdaptor_->setDiskWriter(
+      diskWriterFactory_->newDiskWriter(diskAdaptor_->getFilePath()));
+  diskAdaptor_->enableReadOnly();
+  diskAdaptor_->openFile();
+}
+
 #ifdef ENABLE_BITTORRENT
 
 bool UnknownLengthPieceStorage::hasMissingPiece(
@@ -195,6 +195,8 @@ public:
    */
   virtual void initStorage() CXX11_OVERRIDE;
 
+  virtual void reopenStorage() CXX11_OVERRIDE;
+
   virtual const unsigned char* getBitfield() CXX11_OVERRIDE;
 
   virtual void setBitfield(const unsigned char* bitfield,
@@ -212,12 +214,21 @@ public:
 
   virtual void setEndGamePieceNum(size_t num) CXX11_OVERRIDE {}
 
+  virtual void addEndGameDuplicateLength(int64_t length) CXX11_OVERRIDE {}
+
+  virtual int64_t getEndGameDuplicateLength() CXX11_OVERRIDE { return 0; }
+
   virtual std::shared_ptr<DiskAdaptor> getDiskAdaptor() CXX11_OVERRIDE;
 
   virtual WrDiskCache* getWrDiskCache() CXX11_OVERRIDE { return nullptr; }
 
+  virtual RdDiskCache* getRdDiskCache() CXX11_OVERRIDE { return nullptr; }
+
   virtual void flushWrDiskCacheEntry() CXX11_OVERRIDE {}
 
+  // Control file is not saved for the download of unknown length.
+  virtual void syncData() CXX11_OVERRIDE {}
+
   virtual int32_t getPieceLength(size_t index) CXX11_OVERRIDE;
 
   virtual void advertisePiece(cuid_t cuid, size_t index,
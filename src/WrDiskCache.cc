@@ -35,14 +35,21 @@
 #include "WrDiskCache.h"
 
 #include <cassert>
+#include <algorithm>
 
 #include "WrDiskCacheEntry.h"
 #include "LogFactory.h"
 #include "fmt.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
-WrDiskCache::WrDiskCache(size_t limit) : limit_(limit), total_(0), clock_(0) {}
+const size_t WrDiskCache::FLUSH_BATCH;
+
+WrDiskCache::WrDiskCache(size_t limit)
+    : limit_(limit), total_(0), clock_(0), flushing_(false)
+{
+}
 
 WrDiskCache::~WrDiskCache()
 {
@@ -56,6 +63,7 @@ bool WrDiskCache::add(WrDiskCacheEntry* ent)
 {
   ent->setSizeKey(ent->getSize());
   ent->setLastUpdate(++clock_);
+  ent->setLastUpdateTime(global::wallclock());
   std::pair<EntrySet::iterator, bool> rv = set_.insert(ent);
   if (rv.second) {
     total_ += ent->getSize();
@@ -98,6 +106,9 @@ bool WrDiskCache::update(WrDiskCacheEntry* ent, ssize_t delta)
 
   ent->setSizeKey(ent->getSize());
   ent->setLastUpdate(++clock_);
+  if (delta > 0) {
+    ent->setLastUpdateTime(global::wallclock());
+  }
   set_.insert(ent);
 
   if (delta < 0) {
@@ -111,18 +122,81 @@ bool WrDiskCache::update(WrDiskCacheEntry* ent, ssize_t delta)
 void WrDiskCache::ensureLimit()
 {
   while (total_ > limit_) {
-    auto i = set_.begin();
-    WrDiskCacheEntry* ent = *i;
+    WrDiskCacheEntry* ent = *set_.begin();
     A2_LOG_DEBUG(fmt("Force flush cache entry size=%lu, clock=%" PRId64,
                      static_cast<unsigned long>(ent->getSizeKey()),
                      ent->getLastUpdate()));
-    total_ -= ent->getSize();
-    ent->writeToDisk();
-    set_.erase(i);
+    flush(ent);
+  }
+}
+
+void WrDiskCache::flushBackground()
+{
+  if (!flushing_) {
+    if (total_ <= getHighWatermark()) {
+      return;
+    }
+    flushing_ = true;
+  }
+  std::vector<WrDiskCacheEntry*> ents;
+  size_t total = total_;
+  size_t batch = 0;
+  // set_ is sorted by size in descending order.
+  for (auto ent : set_) {
+    if (total <= getLowWatermark() || batch >= FLUSH_BATCH ||
+        ent->getSize() == 0) {
+      break;
+    }
+    ents.push_back(ent);
+    total -= ent->getSize();
+    batch += ent->getSize();
+  }
+  flush(ents);
+  if (total_ <= getLowWatermark()) {
+    flushing_ = false;
+  }
+}
 
-    ent->setSizeKey(ent->getSize());
-    ent->setLastUpdate(++clock_);
-    set_.insert(ent);
+void WrDiskCache::flushIdle(const std::chrono::seconds& age)
+{
+  std::vector<WrDiskCacheEntry*> ents;
+  for (auto ent : set_) {
+    if (ent->getSize() == 0) {
+      break;
+    }
+    if (ent->getLastUpdateTime().difference(global::wallclock()) >= age) {
+      ents.push_back(ent);
+    }
+  }
+  flush(ents);
+}
+
+void WrDiskCache::flush(WrDiskCacheEntry* ent)
+{
+  set_.erase(ent);
+  total_ -= ent->getSize();
+  ent->writeToDisk();
+
+  ent->setSizeKey(ent->getSize());
+  ent->setLastUpdate(++clock_);
+  set_.insert(ent);
+}
+
+void WrDiskCache::flush(std::vector<WrDiskCacheEntry*>& ents)
+{
+  std::sort(std::begin(ents), std::end(ents),
+            [](const WrDiskCacheEntry* lhs, const WrDiskCacheEntry* rhs) {
+              if (lhs->getDiskAdaptor() != rhs->getDiskAdaptor()) {
+                return lhs->getDiskAdaptor() < rhs->getDiskAdaptor();
+              }
+              return lhs->getFirstOffset() < rhs->getFirstOffset();
+            });
+  for (auto ent : ents) {
+    A2_LOG_DEBUG(fmt("Background flush cache entry goff=%" PRId64
+                     ", size=%lu",
+                     ent->getFirstOffset(),
+                     static_cast<unsigned long>(ent->getSize())));
+    flush(ent);
   }
 }
 
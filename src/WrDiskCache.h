@@ -38,6 +38,8 @@
 #include "common.h"
 
 #include <set>
+#include <vector>
+#include <chrono>
 
 #include "a2functional.h"
 
@@ -62,9 +64,29 @@ public:
   // Evicts entries from storage so that total size of cache is kept
   // under the limit.
   void ensureLimit();
+  // Writes entries to the disk ahead of the limit: once the cache
+  // grows above the high watermark, the largest entries are written
+  // in the order of their offsets until the cache shrinks to the low
+  // watermark.  At most FLUSH_BATCH bytes are written per call, so
+  // that the caller is not stalled for long.
+  void flushBackground();
+  // Writes entries to which no data was cached for |age|, in the
+  // order of their offsets.  This is meant for pieces which are
+  // filled slowly.
+  void flushIdle(const std::chrono::seconds& age);
   size_t getSize() const { return total_; }
+  size_t getHighWatermark() const { return limit_ / 4 * 3; }
+  size_t getLowWatermark() const { return limit_ / 2; }
+
+  static const size_t FLUSH_BATCH = 4_m;
 
 private:
+  // Writes the data of |ent| to the disk.  |ent| stays in the storage
+  // with size 0.
+  void flush(WrDiskCacheEntry* ent);
+  // Writes |ents| in the order of their offsets.
+  void flush(std::vector<WrDiskCacheEntry*>& ents);
+
   typedef std::set<WrDiskCacheEntry*, DerefLess<WrDiskCacheEntry*>> EntrySet;
   // Maximum number of bytes the storage can cache.
   size_t limit_;
@@ -72,6 +94,8 @@ private:
   size_t total_;
   EntrySet set_;
   int64_t clock_;
+  // True while flushBackground() works toward the low watermark.
+  bool flushing_;
 };
 
 } // namespace aria2
@@ -89,6 +89,14 @@ void WrDiskCacheEntry::writeToDisk()
 
 void WrDiskCacheEntry::clear() { deleteDataCells(); }
 
+int64_t WrDiskCacheEntry::getFirstOffset() const
+{
+  if (set_.empty()) {
+    return -1;
+  }
+  return (*set_.begin())->goff;
+}
+
 bool WrDiskCacheEntry::cacheData(DataCell* dataCell)
 {
   A2_LOG_DEBUG(fmt("WrDiskCacheEntry cache goff=%" PRId64 ", len=%lu",
@@ -42,6 +42,7 @@
 
 #include "a2functional.h"
 #include "error_code.h"
+#include "TimerA2.h"
 
 namespace aria2 {
 
@@ -85,6 +86,16 @@ public:
   size_t getSizeKey() const { return sizeKey_; }
   void setLastUpdate(int64_t clock) { lastUpdate_ = clock; }
   int64_t getLastUpdate() const { return lastUpdate_; }
+  // The time when data was cached last.
+  void setLastUpdateTime(const Timer& t) { lastUpdateTime_ = t; }
+  const Timer& getLastUpdateTime() const { return lastUpdateTime_; }
+  // Returns the offset of the first cached data, or -1 if nothing is
+  // cached.
+  int64_t getFirstOffset() const;
+  const std::shared_ptr<DiskAdaptor>& getDiskAdaptor() const
+  {
+    return diskAdaptor_;
+  }
   bool operator<(const WrDiskCacheEntry& rhs) const
   {
     return sizeKey_ > rhs.sizeKey_ ||
@@ -103,6 +114,7 @@ private:
 
   size_t sizeKey_;
   int64_t lastUpdate_;
+  Timer lastUpdateTime_;
 
   size_t size_;
 
@@ -133,6 +133,22 @@ struct Endpoint {
   uint16_t port;
 };
 
+// A datagram used by SocketCore::readDataFromBatch() and
+// SocketCore::writeDataToBatch().  For reading, data must point to
+// the buffer of capacity bytes, and length and addr are filled with
+// the received datagram.  For writing, data, length and addr
+// describe the datagram to send.
+struct Datagram {
+  unsigned char* data;
+  size_t capacity;
+  size_t length;
+  SockAddr addr;
+};
+
+// The maximum number of datagrams read or written by one call of
+// SocketCore::readDataFromBatch() and SocketCore::writeDataToBatch().
+#define A2_DATAGRAM_BATCH_MAX 32
+
 #define A2_DEFAULT_IOV_MAX 128
 
 #if defined(IOV_MAX) && IOV_MAX < A2_DEFAULT_IOV_MAX
@@ -35,6 +35,7 @@
 #include "bencode2.h"
 
 #include <sstream>
+#include <cstring>
 
 #include "fmt.h"
 #include "DlAbortEx.h"
@@ -75,6 +76,103 @@ std::unique_ptr<ValueBase> decode(const unsigned char* data, size_t len,
   return res;
 }
 
+namespace {
+// Parses bencoded string at data[i] and stores the offset of its
+// content in first and its length in slen.  Returns the offset just
+// past the string, or 0 if it is malformed.
+size_t parseString(const unsigned char* data, size_t len, size_t i,
+                   size_t& first, size_t& slen)
+{
+  slen = 0;
+  for (; i < len && '0' <= data[i] && data[i] <= '9'; ++i) {
+    if (slen > len) {
+      return 0;
+    }
+    slen = slen * 10 + (data[i] - '0');
+  }
+  if (i == len || data[i] != ':' || len - i - 1 < slen) {
+    return 0;
+  }
+  first = i + 1;
+  return first + slen;
+}
+
+// Skips bencoded value at data[i] and returns the offset just past
+// it, or 0 if it is malformed.
+size_t skipValue(const unsigned char* data, size_t len, size_t i)
+{
+  size_t depth = 0;
+  do {
+    if (i == len) {
+      return 0;
+    }
+    switch (data[i]) {
+    case 'i': {
+      auto p = reinterpret_cast<const unsigned char*>(
+          memchr(data + i, 'e', len - i));
+      if (!p) {
+        return 0;
+      }
+      i = p - data + 1;
+      break;
+    }
+    case 'l':
+    case 'd':
+      ++depth;
+      ++i;
+      break;
+    case 'e':
+      if (depth == 0) {
+        return 0;
+      }
+      --depth;
+      ++i;
+      break;
+    default: {
+      size_t first, slen;
+      i = parseString(data, len, i, first, slen);
+      if (i == 0) {
+        return 0;
+      }
+      break;
+    }
+    }
+  } while (depth > 0);
+  return i;
+}
+} // namespace
+
+bool peekDictString(const unsigned char* data, size_t len,
+                    const std::string& key, std::string& value)
+{
+  if (len == 0 || data[0] != 'd') {
+    return false;
+  }
+  size_t i = 1;
+  while (i < len && data[i] != 'e') {
+    size_t first, slen;
+    i = parseString(data, len, i, first, slen);
+    if (i == 0 || i == len) {
+      return false;
+    }
+    if (slen == key.size() && memcmp(data + first, key.data(), slen) == 0) {
+      if (data[i] < '0' || '9' < data[i]) {
+        return false;
+      }
+      if (parseString(data, len, i, first, slen) == 0) {
+        return false;
+      }
+      value.assign(data + first, data + first + slen);
+      return true;
+    }
+    i = skipValue(data, len, i);
+    if (i == 0) {
+      return false;
+    }
+  }
+  return false;
+}
+
 std::string encode(const ValueBase* vlb)
 {
   class BencodeValueBaseVisitor : public ValueBaseVisitor {
@@ -57,6 +57,16 @@ std::unique_ptr<ValueBase> decode(const unsigned char* data, size_t len,
 
 std::unique_ptr<ValueBase> decodeFromFile(const std::string& filename);
 
+// Scans the top-level dictionary in the data whose length is len,
+// and if it has key whose value is a string, assigns the value to
+// value and returns true.  Unlike decode(), this function does not
+// build ValueBase objects, and is used to look at a few keys of a
+// message (e.g., "t" and "y" of a DHT message) cheaply.  Returns
+// false if key is not found, its value is not a string, or data is
+// malformed before key is found.
+bool peekDictString(const unsigned char* data, size_t len,
+                    const std::string& key, std::string& value);
+
 std::string encode(const ValueBase* vlb);
 
 } // namespace bencode2
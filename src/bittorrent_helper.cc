@@ -74,6 +74,7 @@ const char C_FILES[] = "files";
 const char C_LENGTH[] = "length";
 const char C_PATH[] = "path";
 const char C_PATH_UTF8[] = "path.utf-8";
+const char C_ATTR[] = "attr";
 const char C_INFO[] = "info";
 const char C_PIECES[] = "pieces";
 const char C_PIECE_LENGTH[] = "piece length";
@@ -292,6 +293,11 @@ void extractFileEntries(const std::shared_ptr<DownloadContext>& ctx,
       fileEntry->setOriginalName(utf8Path);
       fileEntry->setSuffixPath(suffixPath);
       fileEntry->setMaxConnectionPerServer(maxConn);
+      // BEP 47: "p" in attr marks a pad file.
+      const String* attrData = downcast<String>(fileDict->get(C_ATTR));
+      if (attrData && attrData->s().find('p') != std::string::npos) {
+        fileEntry->setPadFile(true);
+      }
       fileEntries.push_back(fileEntry);
       offset += fileEntry->getLength();
     }
@@ -178,6 +178,7 @@ PrefPtr PREF_DIR = makePref("dir");
 PrefPtr PREF_OUT = makePref("out");
 // values: 1*digit
 PrefPtr PREF_SPLIT = makePref("split");
+PrefPtr PREF_AUTO_SPLIT = makePref("auto-split");
 // value: true | false
 PrefPtr PREF_DAEMON = makePref("daemon");
 // value: a string
@@ -197,6 +198,9 @@ PrefPtr PREF_STARTUP_IDLE_TIME = makePref("startup-idle-time");
 PrefPtr PREF_FILE_ALLOCATION = makePref("file-allocation");
 // value: 1*digit
 PrefPtr PREF_NO_FILE_ALLOCATION_LIMIT = makePref("no-file-allocation-limit");
+// value: 1*digit
+PrefPtr PREF_MAX_CONCURRENT_FILE_ALLOCATIONS =
+    makePref("max-concurrent-file-allocations");
 // value: true | false
 PrefPtr PREF_ALLOW_OVERWRITE = makePref("allow-overwrite");
 // value: true | false
@@ -347,11 +351,18 @@ PrefPtr PREF_STOP_WITH_PROCESS = makePref("stop-with-process");
 // value: true | false
 PrefPtr PREF_ENABLE_MMAP = makePref("enable-mmap");
 // value: true | false
+PrefPtr PREF_ENABLE_DIRECT_IO = makePref("enable-direct-io");
+// value: true | false
 PrefPtr PREF_FORCE_SAVE = makePref("force-save");
 // value: true | false
+PrefPtr PREF_DURABLE_SAVE = makePref("durable-save");
+// value: string that your file system recognizes as a directory.
+PrefPtr PREF_COMPLETED_DIR = makePref("completed-dir");
+// value: true | false
 PrefPtr PREF_SAVE_NOT_FOUND = makePref("save-not-found");
 // value: 1*digit
 PrefPtr PREF_DISK_CACHE = makePref("disk-cache");
+PrefPtr PREF_DISK_READ_CACHE = makePref("disk-read-cache");
 // value: string
 PrefPtr PREF_GID = makePref("gid");
 // values: 1*digit
@@ -367,6 +378,7 @@ PrefPtr PREF_PAUSE_METADATA = makePref("pause-metadata");
 PrefPtr PREF_RLIMIT_NOFILE = makePref("rlimit-nofile");
 // values: SSLv3 | TLSv1 | TLSv1.1 | TLSv1.2
 PrefPtr PREF_MIN_TLS_VERSION = makePref("min-tls-version");
+PrefPtr PREF_ENABLE_KTLS = makePref("enable-ktls");
 // value: 1*digit
 PrefPtr PREF_SOCKET_RECV_BUFFER_SIZE = makePref("socket-recv-buffer-size");
 // value: 1*digit
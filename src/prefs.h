@@ -135,6 +135,8 @@ extern PrefPtr PREF_DIR;
 extern PrefPtr PREF_OUT;
 // values: 1*digit
 extern PrefPtr PREF_SPLIT;
+// values: 1*digit
+extern PrefPtr PREF_AUTO_SPLIT;
 // value: true | false
 extern PrefPtr PREF_DAEMON;
 // value: a string
@@ -151,6 +153,8 @@ extern PrefPtr PREF_STARTUP_IDLE_TIME;
 extern PrefPtr PREF_FILE_ALLOCATION;
 // value: 1*digit
 extern PrefPtr PREF_NO_FILE_ALLOCATION_LIMIT;
+// value: 1*digit
+extern PrefPtr PREF_MAX_CONCURRENT_FILE_ALLOCATIONS;
 // value: true | false
 extern PrefPtr PREF_ALLOW_OVERWRITE;
 // value: true | false
@@ -300,11 +304,19 @@ extern PrefPtr PREF_STOP_WITH_PROCESS;
 // value: true | false
 extern PrefPtr PREF_ENABLE_MMAP;
 // value: true | false
+extern PrefPtr PREF_ENABLE_DIRECT_IO;
+// value: true | false
 extern PrefPtr PREF_FORCE_SAVE;
 // value: true | false
+extern PrefPtr PREF_DURABLE_SAVE;
+// value: string that your file system recognizes as a directory.
+extern PrefPtr PREF_COMPLETED_DIR;
+// value: true | false
 extern PrefPtr PREF_SAVE_NOT_FOUND;
 // value: 1*digit
 extern PrefPtr PREF_DISK_CACHE;
+// values: 1*digit
+extern PrefPtr PREF_DISK_READ_CACHE;
 // value: string
 extern PrefPtr PREF_GID;
 // values: 1*digit
@@ -321,6 +333,8 @@ extern PrefPtr PREF_PAUSE_METADATA;
 extern PrefPtr PREF_RLIMIT_NOFILE;
 // values: SSLv3 | TLSv1 | TLSv1.1 | TLSv1.2
 extern PrefPtr PREF_MIN_TLS_VERSION;
+// value: true | false
+extern PrefPtr PREF_ENABLE_KTLS;
 // value: 1*digit
 extern PrefPtr PREF_SOCKET_RECV_BUFFER_SIZE;
 // value: 1*digit
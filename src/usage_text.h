@@ -60,6 +60,14 @@
     "                              same host is restricted by the \n"        \
     "                              --max-connection-per-server option. See also the\n" \
     "                              --min-split-size option.")
+#define TEXT_AUTO_SPLIT                                                 \
+  _(" --auto-split=N               Adjust the number of connections of a download\n" \
+    "                              between 1 and N while downloading, starting\n" \
+    "                              from --split. A connection is added as long as\n" \
+    "                              it increases the download speed and the number\n" \
+    "                              of connections is halved when the server\n" \
+    "                              responds with 503 or 429. Specify 0 to disable\n" \
+    "                              this feature.")
 #define TEXT_RETRY_WAIT                                                 \
   _(" --retry-wait=SEC             Set the seconds to wait between retries. \n" \
     "                              With SEC > 0, aria2 will retry download when the\n" \
@@ -153,10 +161,31 @@
   _(" --no-file-allocation-limit=SIZE No file allocation is made for files whose\n" \
     "                              size is smaller than SIZE.\n"        \
     "                              You can append K or M(1K = 1024, 1M = 1024K).")
+#define TEXT_MAX_CONCURRENT_FILE_ALLOCATIONS                            \
+  _(" --max-concurrent-file-allocations=N Set the maximum number of downloads\n" \
+    "                              whose files are allocated at the same time.\n" \
+    "                              A download waiting for the allocation of a\n" \
+    "                              large download can start as soon as a slot is\n" \
+    "                              free.")
 #define TEXT_ENABLE_DIRECT_IO                                          \
-  _(" --enable-direct-io[=true|false] Enable directI/O, which lowers cpu usage while\n" \
-    "                              allocating files.\n"                 \
-    "                              Turn off if you encounter any error")
+  _(" --enable-direct-io[=true|false] Read and write files with direct I/O, which\n" \
+    "                              bypasses the page cache. This keeps large\n" \
+    "                              downloads from evicting the cached data of other\n" \
+    "                              programs. This option disables --enable-mmap.\n" \
+    "                              If the file system does not support direct I/O,\n" \
+    "                              files are accessed as usual.")
+#define TEXT_COMPLETED_DIR                                             \
+  _(" --completed-dir=DIR          Move downloaded files to DIR when the download\n" \
+    "                              completes. The files keep their paths relative\n" \
+    "                              to --dir. They are renamed if DIR is on the same\n" \
+    "                              file system, and copied otherwise. BitTorrent\n" \
+    "                              downloads are seeded from DIR.")
+#define TEXT_DURABLE_SAVE                                              \
+  _(" --durable-save[=true|false] Sync downloaded data to the storage device before\n" \
+    "                              the control file is saved, so that the control\n" \
+    "                              file never records pieces which may be lost on\n" \
+    "                              power failure. Writeback of each completed piece\n" \
+    "                              is started as soon as it is written.")
 #define TEXT_ALLOW_OVERWRITE                                            \
   _(" --allow-overwrite[=true|false] Restart download from scratch if the\n" \
     "                              corresponding control file doesn't exist.  See\n" \
@@ -192,6 +221,13 @@
   _(" --enable-http-keep-alive[=true|false] Enable HTTP/1.1 persistent connection.")
 #define TEXT_ENABLE_HTTP_PIPELINING                                     \
   _(" --enable-http-pipelining[=true|false] Enable HTTP/1.1 pipelining.")
+#define TEXT_MAX_HTTP_PIPELINING                                        \
+  _(" --max-http-pipelining=NUM    Set the maximum number of pipelined requests in\n" \
+    "                              flight on one connection. If NUM is more than 2,\n" \
+    "                              the number is chosen up to NUM from the round\n" \
+    "                              trip time and the download speed. This option\n" \
+    "                              has effect only when --enable-http-pipelining is\n" \
+    "                              true.")
 #define TEXT_CHECK_INTEGRITY                                            \
   _(" -V, --check-integrity[=true|false] Check file integrity by validating piece\n" \
     "                              hashes or a hash of entire file. This option has\n" \
@@ -999,6 +1035,15 @@
     "                              cached in memory, we don't need to read them\n" \
     "                              from the disk.\n"                    \
     "                              SIZE can include K or M(1K = 1024, 1M = 1024K).")
+#define TEXT_DISK_READ_CACHE                                            \
+  _(" --disk-read-cache=SIZE       Cache pieces read from the disk to upload them\n" \
+    "                              to peers. When a block of a piece is requested,\n" \
+    "                              the rest of the piece is read ahead, so that the\n" \
+    "                              following requests are served from memory. The\n" \
+    "                              cache storage is shared by all downloads and\n" \
+    "                              grows to at most SIZE bytes. If SIZE is 0, the\n" \
+    "                              cache is disabled.\n" \
+    "                              SIZE can include K or M(1K = 1024, 1M = 1024K).")
 #define TEXT_GID                                \
   _(" --gid=GID                    Set GID manually. aria2 identifies each\n" \
     "                              download by the ID called GID. The GID must be\n" \
@@ -1066,6 +1111,14 @@
     "                              recognized as active download in RPC method.")
 #define TEXT_MIN_TLS_VERSION                                            \
   _(" --min-tls-version=VERSION    Specify minimum SSL/TLS version to enable.")
+#define TEXT_ENABLE_KTLS                                                \
+  _(" --enable-ktls[=true|false]   Let the kernel encrypt and decrypt SSL/TLS\n" \
+    "                              records after handshake (kTLS). This requires\n" \
+    "                              OpenSSL 3 built with kTLS support and the tls\n" \
+    "                              kernel module. If they are not available, aria2\n" \
+    "                              processes the records as usual. GnuTLS uses\n" \
+    "                              kTLS only if its system-wide configuration\n" \
+    "                              enables it, regardless of this option.")
 #define TEXT_BT_FORCE_ENCRYPTION                                        \
   _(" --bt-force-encryption[=true|false]\n"                             \
     "                              Requires BitTorrent message payload encryption\n" \
@@ -1,6 +1,7 @@
 #include "ARC4Encryptor.h"
 
 #include <cstring>
+#include <algorithm>
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "Exception.h"
@@ -12,6 +13,8 @@ class ARC4Test : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(ARC4Test);
   CPPUNIT_TEST(testEncrypt);
+  CPPUNIT_TEST(testEncrypt_knownAnswer);
+  CPPUNIT_TEST(testEncrypt_chunked);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -20,6 +23,8 @@ public:
   void tearDown() {}
 
   void testEncrypt();
+  void testEncrypt_knownAnswer();
+  void testEncrypt_chunked();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ARC4Test);
@@ -50,4 +55,42 @@ void ARC4Test::testEncrypt()
   CPPUNIT_ASSERT(memcmp(key, decrypted, LEN) == 0);
 }
 
+void ARC4Test::testEncrypt_knownAnswer()
+{
+  ARC4Encryptor enc;
+  std::string key = "Key";
+  std::string plain = "Plaintext";
+  unsigned char encrypted[9];
+  enc.init(reinterpret_cast<const unsigned char*>(key.data()), key.size());
+  enc.encrypt(plain.size(), encrypted,
+              reinterpret_cast<const unsigned char*>(plain.data()));
+  CPPUNIT_ASSERT_EQUAL(std::string("bbf316e8d940af0ad3"),
+                       util::toHex(encrypted, sizeof(encrypted)));
+}
+
+void ARC4Test::testEncrypt_chunked()
+{
+  const size_t LEN = 1000;
+  unsigned char key[20];
+  util::generateRandomData(key, sizeof(key));
+  unsigned char data[LEN];
+  util::generateRandomData(data, sizeof(data));
+
+  ARC4Encryptor enc;
+  enc.init(key, sizeof(key));
+  unsigned char expected[LEN];
+  enc.encrypt(LEN, expected, data);
+
+  // Encrypting in odd sized chunks must produce the same key stream.
+  ARC4Encryptor enc2;
+  enc2.init(key, sizeof(key));
+  unsigned char encrypted[LEN];
+  memcpy(encrypted, data, LEN);
+  for (size_t off = 0, n = 1; off < LEN; off += n, n = n % 7 + 1) {
+    n = std::min(n, LEN - off);
+    enc2.encrypt(n, encrypted + off, encrypted + off);
+  }
+  CPPUNIT_ASSERT(memcmp(expected, encrypted, LEN) == 0);
+}
+
 } // namespace aria2
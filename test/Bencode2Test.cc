@@ -10,11 +10,13 @@ class Bencode2Test : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(Bencode2Test);
   CPPUNIT_TEST(testEncode);
+  CPPUNIT_TEST(testPeekDictString);
   CPPUNIT_TEST_SUITE_END();
 
 private:
 public:
   void testEncode();
+  void testPeekDictString();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(Bencode2Test);
@@ -42,4 +44,38 @@ void Bencode2Test::testEncode()
   }
 }
 
+void Bencode2Test::testPeekDictString()
+{
+  std::string msg = "d1:ad2:id20:aaaaaaaaaaaaaaaaaaaae"
+                    "1:lli1ei-2ee"
+                    "1:q4:ping"
+                    "1:t2:aa"
+                    "1:y1:q"
+                    "e";
+  auto data = reinterpret_cast<const unsigned char*>(msg.data());
+  std::string value;
+  CPPUNIT_ASSERT(bencode2::peekDictString(data, msg.size(), "y", value));
+  CPPUNIT_ASSERT_EQUAL(std::string("q"), value);
+  CPPUNIT_ASSERT(bencode2::peekDictString(data, msg.size(), "t", value));
+  CPPUNIT_ASSERT_EQUAL(std::string("aa"), value);
+  // Value is not a string
+  CPPUNIT_ASSERT(!bencode2::peekDictString(data, msg.size(), "a", value));
+  CPPUNIT_ASSERT(!bencode2::peekDictString(data, msg.size(), "l", value));
+  // Key in nested dictionary is not looked up
+  CPPUNIT_ASSERT(!bencode2::peekDictString(data, msg.size(), "id", value));
+  // Not found
+  CPPUNIT_ASSERT(!bencode2::peekDictString(data, msg.size(), "r", value));
+  // Not a dictionary
+  std::string list = "l1:te";
+  CPPUNIT_ASSERT(!bencode2::peekDictString(
+      reinterpret_cast<const unsigned char*>(list.data()), list.size(), "t",
+      value));
+  // Truncated
+  CPPUNIT_ASSERT(!bencode2::peekDictString(data, 20, "t", value));
+  std::string trunc = "d1:t5:aa";
+  CPPUNIT_ASSERT(!bencode2::peekDictString(
+      reinterpret_cast<const unsigned char*>(trunc.data()), trunc.size(), "t",
+      value));
+}
+
 } // namespace aria2
@@ -54,6 +54,7 @@ class BittorrentHelperTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testLoadFromMemory_singleFileDirTraversal);
   CPPUNIT_TEST(testLoadFromMemory_multiFileNonUtf8Path);
   CPPUNIT_TEST(testLoadFromMemory_singleFileNonUtf8Path);
+  CPPUNIT_TEST(testLoadFromMemory_padFile);
   CPPUNIT_TEST(testGetNodes);
   CPPUNIT_TEST(testGetBasePath);
   CPPUNIT_TEST(testSetFileFilter_single);
@@ -113,6 +114,7 @@ public:
   void testLoadFromMemory_singleFileDirTraversal();
   void testLoadFromMemory_multiFileNonUtf8Path();
   void testLoadFromMemory_singleFileNonUtf8Path();
+  void testLoadFromMemory_padFile();
   void testGetNodes();
   void testGetBasePath();
   void testSetFileFilter_single();
@@ -488,6 +490,39 @@ void BittorrentHelperTest::testLoadFromMemory_singleFileNonUtf8Path()
   CPPUNIT_ASSERT_EQUAL(std::string("%90%A2%8AE"), fe->getSuffixPath());
 }
 
+void BittorrentHelperTest::testLoadFromMemory_padFile()
+{
+  auto files = List::g();
+  for (auto& name : {"foo", ".pad", "bar"}) {
+    auto path = List::g();
+    path->append(name);
+    auto file = Dict::g();
+    file->put("length", Integer::g(512));
+    file->put("path", std::move(path));
+    if (name[0] == '.') {
+      file->put("attr", "p");
+    }
+    else if (name[0] == 'b') {
+      file->put("attr", "x");
+    }
+    files->append(std::move(file));
+  }
+  auto info = Dict::g();
+  info->put("files", std::move(files));
+  info->put("piece length", Integer::g(1_k));
+  info->put("pieces", "0123456789012345678901234567890123456789");
+  info->put("name", "test");
+  Dict dict;
+  dict.put("info", std::move(info));
+  auto dctx = std::make_shared<DownloadContext>();
+  loadFromMemory(bencode2::encode(&dict), dctx, option_, "default");
+
+  auto& fileEntries = dctx->getFileEntries();
+  CPPUNIT_ASSERT(!fileEntries[0]->isPadFile());
+  CPPUNIT_ASSERT(fileEntries[1]->isPadFile());
+  CPPUNIT_ASSERT(!fileEntries[2]->isPadFile());
+}
+
 void BittorrentHelperTest::testLoadFromMemory()
 {
   std::string memory = "d8:announce36:http://aria.rednoah.com/"
@@ -0,0 +1,86 @@
+#include "ConnectionTuner.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace aria2 {
+
+class ConnectionTunerTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(ConnectionTunerTest);
+  CPPUNIT_TEST(testUpdate_grow);
+  CPPUNIT_TEST(testUpdate_revert);
+  CPPUNIT_TEST(testUpdate_noGain);
+  CPPUNIT_TEST(testUpdate_serverBusy);
+  CPPUNIT_TEST(testUpdate_clamp);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testUpdate_grow();
+  void testUpdate_revert();
+  void testUpdate_noGain();
+  void testUpdate_serverBusy();
+  void testUpdate_clamp();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ConnectionTunerTest);
+
+void ConnectionTunerTest::testUpdate_grow()
+{
+  ConnectionTuner tuner;
+  // First round always probes one more connection.
+  CPPUNIT_ASSERT_EQUAL(3, tuner.update(2, 100, 16));
+  CPPUNIT_ASSERT_EQUAL(4, tuner.update(3, 150, 16));
+  CPPUNIT_ASSERT_EQUAL(5, tuner.update(4, 200, 16));
+}
+
+void ConnectionTunerTest::testUpdate_revert()
+{
+  ConnectionTuner tuner;
+  CPPUNIT_ASSERT_EQUAL(3, tuner.update(2, 100, 16));
+  CPPUNIT_ASSERT_EQUAL(4, tuner.update(3, 150, 16));
+  // The 4th connection made the download slower.
+  CPPUNIT_ASSERT_EQUAL(3, tuner.update(4, 140, 16));
+  for (int i = 0; i < ConnectionTuner::HOLD_ROUNDS; ++i) {
+    CPPUNIT_ASSERT_EQUAL(3, tuner.update(3, 150, 16));
+  }
+  // Probe again after holding.
+  CPPUNIT_ASSERT_EQUAL(4, tuner.update(3, 150, 16));
+}
+
+void ConnectionTunerTest::testUpdate_noGain()
+{
+  ConnectionTuner tuner;
+  CPPUNIT_ASSERT_EQUAL(3, tuner.update(2, 100, 16));
+  // Speed increased, but less than 10%.  Keep 3 connections.
+  CPPUNIT_ASSERT_EQUAL(3, tuner.update(3, 105, 16));
+  for (int i = 0; i < ConnectionTuner::HOLD_ROUNDS; ++i) {
+    CPPUNIT_ASSERT_EQUAL(3, tuner.update(3, 105, 16));
+  }
+  CPPUNIT_ASSERT_EQUAL(4, tuner.update(3, 105, 16));
+}
+
+void ConnectionTunerTest::testUpdate_serverBusy()
+{
+  ConnectionTuner tuner;
+  CPPUNIT_ASSERT_EQUAL(5, tuner.update(4, 100, 16));
+  // Takes effect immediately, not at the next update().
+  CPPUNIT_ASSERT_EQUAL(2, tuner.notifyServerBusy(5));
+  for (int i = 0; i < ConnectionTuner::HOLD_ROUNDS; ++i) {
+    CPPUNIT_ASSERT_EQUAL(2, tuner.update(2, 100, 16));
+  }
+  CPPUNIT_ASSERT_EQUAL(3, tuner.update(2, 100, 16));
+}
+
+void ConnectionTunerTest::testUpdate_clamp()
+{
+  ConnectionTuner tuner;
+  CPPUNIT_ASSERT_EQUAL(4, tuner.update(4, 100, 4));
+  // maxConnections was lowered by changeOption.
+  CPPUNIT_ASSERT_EQUAL(2, tuner.update(4, 100, 2));
+
+  ConnectionTuner tuner2;
+  CPPUNIT_ASSERT_EQUAL(1, tuner2.notifyServerBusy(1));
+  CPPUNIT_ASSERT_EQUAL(1, tuner2.update(1, 100, 16));
+}
+
+} // namespace aria2
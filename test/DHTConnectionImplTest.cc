@@ -6,6 +6,7 @@
 #include "Exception.h"
 #include "SocketCore.h"
 #include "A2STR.h"
+#include "util.h"
 
 namespace aria2 {
 
@@ -13,6 +14,7 @@ class DHTConnectionImplTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(DHTConnectionImplTest);
   CPPUNIT_TEST(testWriteAndReadData);
+  CPPUNIT_TEST(testWriteAndReadData_batch);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -21,6 +23,7 @@ public:
   void tearDown() {}
 
   void testWriteAndReadData();
+  void testWriteAndReadData_batch();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DHTConnectionImplTest);
@@ -40,6 +43,7 @@ void DHTConnectionImplTest::testWriteAndReadData()
     // hostname should be "localhost", not 127.0.0.1. Test failed on Mac OSX10.5
     con1.sendMessage(reinterpret_cast<const unsigned char*>(message1.c_str()),
                      message1.size(), "localhost", con2port);
+    CPPUNIT_ASSERT_EQUAL((size_t)0, con1.flushMessages());
 
     unsigned char readbuffer[100];
     std::string remoteHost;
@@ -59,4 +63,46 @@ void DHTConnectionImplTest::testWriteAndReadData()
   }
 }
 
+void DHTConnectionImplTest::testWriteAndReadData_batch()
+{
+  try {
+    DHTConnectionImpl con1(AF_INET);
+    uint16_t con1port = 0;
+    CPPUNIT_ASSERT(con1.bind(con1port, A2STR::NIL));
+
+    DHTConnectionImpl con2(AF_INET);
+    uint16_t con2port = 0;
+    CPPUNIT_ASSERT(con2.bind(con2port, A2STR::NIL));
+
+    std::vector<std::string> messages;
+    for (int i = 0; i < 40; ++i) {
+      messages.push_back("message" + util::itos(i));
+      CPPUNIT_ASSERT_EQUAL(
+          (ssize_t)messages.back().size(),
+          con1.sendMessage(
+              reinterpret_cast<const unsigned char*>(messages.back().c_str()),
+              messages.back().size(), "localhost", con2port));
+    }
+    // Nothing is sent until flushMessages() is called.
+    CPPUNIT_ASSERT(!con2.getSocket()->isReadable(0));
+    CPPUNIT_ASSERT_EQUAL((size_t)0, con1.flushMessages());
+
+    unsigned char readbuffer[100];
+    std::string remoteHost;
+    uint16_t remotePort;
+    for (const auto& m : messages) {
+      ssize_t rlength;
+      while ((rlength = con2.receiveMessage(readbuffer, sizeof(readbuffer),
+                                            remoteHost, remotePort)) == 0)
+        ;
+      CPPUNIT_ASSERT_EQUAL(m,
+                           std::string(&readbuffer[0], &readbuffer[rlength]));
+      CPPUNIT_ASSERT_EQUAL(con1port, remotePort);
+    }
+  }
+  catch (Exception& e) {
+    CPPUNIT_FAIL(e.stackTrace());
+  }
+}
+
 } // namespace aria2
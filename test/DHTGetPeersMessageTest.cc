@@ -18,6 +18,7 @@
 #include "RequestGroup.h"
 #include "BtRegistry.h"
 #include "TorrentAttribute.h"
+#include "bittorrent_helper.h"
 
 namespace aria2 {
 
@@ -48,13 +49,13 @@ public:
     virtual std::unique_ptr<DHTGetPeersReplyMessage> createGetPeersReplyMessage(
         const std::shared_ptr<DHTNode>& remoteNode,
         std::vector<std::shared_ptr<DHTNode>> closestKNodes,
-        std::vector<std::shared_ptr<Peer>> peers, const std::string& token,
+        std::vector<std::string> compactPeers, const std::string& token,
         const std::string& transactionID) CXX11_OVERRIDE
     {
       auto m = make_unique<DHTGetPeersReplyMessage>(
           AF_INET, localNode_, remoteNode, token, transactionID);
       m->setClosestKNodes(closestKNodes);
-      m->setValues(peers);
+      m->setCompactValues(compactPeers);
       return m;
     }
   };
@@ -156,21 +157,25 @@ void DHTGetPeersMessageTest::testDoReceivedAction()
                                                     remoteNode_->getPort()),
                          m->getToken());
     CPPUNIT_ASSERT_EQUAL((size_t)0, m->getClosestKNodes().size());
-    CPPUNIT_ASSERT_EQUAL((size_t)3, m->getValues().size());
+    auto& values = m->getCompactValues();
+    CPPUNIT_ASSERT_EQUAL((size_t)3, values.size());
     {
-      auto peer = m->getValues()[0];
-      CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.100"), peer->getIPAddress());
-      CPPUNIT_ASSERT_EQUAL((uint16_t)6888, peer->getPort());
+      auto peer = bittorrent::unpackcompact(
+          reinterpret_cast<const unsigned char*>(values[0].data()), AF_INET);
+      CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.100"), peer.first);
+      CPPUNIT_ASSERT_EQUAL((uint16_t)6888, peer.second);
     }
     {
-      auto peer = m->getValues()[1];
-      CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.101"), peer->getIPAddress());
-      CPPUNIT_ASSERT_EQUAL((uint16_t)6889, peer->getPort());
+      auto peer = bittorrent::unpackcompact(
+          reinterpret_cast<const unsigned char*>(values[1].data()), AF_INET);
+      CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.101"), peer.first);
+      CPPUNIT_ASSERT_EQUAL((uint16_t)6889, peer.second);
     }
     {
-      auto peer = m->getValues()[2];
-      CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.1"), peer->getIPAddress());
-      CPPUNIT_ASSERT_EQUAL((uint16_t)6890, peer->getPort());
+      auto peer = bittorrent::unpackcompact(
+          reinterpret_cast<const unsigned char*>(values[2].data()), AF_INET);
+      CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.1"), peer.first);
+      CPPUNIT_ASSERT_EQUAL((uint16_t)6890, peer.second);
     }
   }
   msg.setBtRegistry(nullptr);
@@ -200,7 +205,7 @@ void DHTGetPeersMessageTest::testDoReceivedAction()
                          m->getToken());
     CPPUNIT_ASSERT_EQUAL((size_t)1, m->getClosestKNodes().size());
     CPPUNIT_ASSERT(*returnNode1 == *m->getClosestKNodes()[0]);
-    CPPUNIT_ASSERT_EQUAL((size_t)0, m->getValues().size());
+    CPPUNIT_ASSERT_EQUAL((size_t)0, m->getCompactValues().size());
   }
 }
 
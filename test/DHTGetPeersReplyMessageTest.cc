@@ -73,6 +73,7 @@ void DHTGetPeersReplyMessageTest::testGetBencodedMessage()
     rDict->put("nodes", compactNodeInfo);
 
     std::vector<std::shared_ptr<Peer>> peers;
+    std::vector<std::string> compactPeers;
     auto valuesList = List::g();
     for (size_t i = 0; i < 4; ++i) {
       auto peer =
@@ -82,9 +83,16 @@ void DHTGetPeersReplyMessageTest::testGetBencodedMessage()
                            bittorrent::packcompact(buffer, peer->getIPAddress(),
                                                    peer->getPort()));
       valuesList->append(String::g(buffer, COMPACT_LEN_IPV4));
-      peers.push_back(peer);
+      // Peers in compact form are sent after the others.
+      if (i < 2) {
+        peers.push_back(peer);
+      }
+      else {
+        compactPeers.emplace_back(&buffer[0], &buffer[COMPACT_LEN_IPV4]);
+      }
     }
     msg.setValues(peers);
+    msg.setCompactValues(compactPeers);
     rDict->put("values", std::move(valuesList));
     dict.put("r", std::move(rDict));
 
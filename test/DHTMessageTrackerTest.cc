@@ -10,6 +10,7 @@
 #include "DHTMessageTrackerEntry.h"
 #include "DHTRoutingTable.h"
 #include "MockDHTMessageFactory.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
@@ -95,6 +96,51 @@ void DHTMessageTrackerTest::testMessageArrived()
   }
 }
 
-void DHTMessageTrackerTest::testHandleTimeout() {}
+void DHTMessageTrackerTest::testHandleTimeout()
+{
+  auto localNode = std::make_shared<DHTNode>();
+  auto routingTable = make_unique<DHTRoutingTable>(localNode);
+  auto factory = make_unique<MockDHTMessageFactory>();
+  factory->setLocalNode(localNode);
+
+  auto r1 = std::make_shared<DHTNode>();
+  r1->setIPAddress("192.168.0.1");
+  r1->setPort(6881);
+  auto r2 = std::make_shared<DHTNode>();
+  r2->setIPAddress("192.168.0.2");
+  r2->setPort(6882);
+
+  auto m1 = make_unique<MockDHTMessage>(localNode, r1);
+  auto m2 = make_unique<MockDHTMessage>(localNode, r2);
+  // Same transaction ID, different remote node.
+  auto m3 = make_unique<MockDHTMessage>(localNode, r1, "mock",
+                                        m2->getTransactionID());
+
+  DHTMessageTracker tracker;
+  tracker.setRoutingTable(routingTable.get());
+  tracker.setMessageFactory(factory.get());
+  tracker.addMessage(m1.get(), 20_s);
+  tracker.addMessage(m2.get(), 10_s);
+  tracker.addMessage(m3.get(), 0_s);
+
+  CPPUNIT_ASSERT(tracker.isTracked(m2->getTransactionID(), r2->getIPAddress(),
+                                   r2->getPort()));
+  CPPUNIT_ASSERT(tracker.isTracked(m3->getTransactionID(), r1->getIPAddress(),
+                                   r1->getPort()));
+  CPPUNIT_ASSERT(!tracker.isTracked(m2->getTransactionID(), "192.168.0.3",
+                                    r2->getPort()));
+
+  tracker.handleTimeout();
+  CPPUNIT_ASSERT_EQUAL((size_t)2, tracker.countEntry());
+  CPPUNIT_ASSERT(!tracker.getEntryFor(m3.get()));
+  CPPUNIT_ASSERT(tracker.getEntryFor(m2.get()));
+
+  global::wallclock().advance(10_s);
+  tracker.handleTimeout();
+  CPPUNIT_ASSERT_EQUAL((size_t)1, tracker.countEntry());
+  CPPUNIT_ASSERT(!tracker.getEntryFor(m2.get()));
+  CPPUNIT_ASSERT(tracker.getEntryFor(m1.get()));
+  global::wallclock().sub(10_s);
+}
 
 } // namespace aria2
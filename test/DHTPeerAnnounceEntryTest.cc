@@ -17,6 +17,7 @@ class DHTPeerAnnounceEntryTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testRemoveStalePeerAddrEntry);
   CPPUNIT_TEST(testEmpty);
   CPPUNIT_TEST(testAddPeerAddrEntry);
+  CPPUNIT_TEST(testAddPeerAddrEntry_ipv6);
   CPPUNIT_TEST(testGetPeers);
   CPPUNIT_TEST_SUITE_END();
 
@@ -24,6 +25,7 @@ public:
   void testRemoveStalePeerAddrEntry();
   void testEmpty();
   void testAddPeerAddrEntry();
+  void testAddPeerAddrEntry_ipv6();
   void testGetPeers();
 };
 
@@ -84,6 +86,25 @@ void DHTPeerAnnounceEntryTest::testAddPeerAddrEntry()
   CPPUNIT_ASSERT(!entry.getPeerAddrEntries()[0].getLastUpdated().isZero());
 }
 
+void DHTPeerAnnounceEntryTest::testAddPeerAddrEntry_ipv6()
+{
+  unsigned char infohash[DHT_ID_LENGTH];
+  memset(infohash, 0xff, DHT_ID_LENGTH);
+
+  DHTPeerAnnounceEntry entry(infohash);
+  entry.addPeerAddrEntry(PeerAddrEntry("192.168.0.1", 6881));
+  entry.addPeerAddrEntry(PeerAddrEntry("2001:db8::1", 6882));
+
+  auto& entries = entry.getPeerAddrEntries();
+  CPPUNIT_ASSERT_EQUAL((size_t)2, entries.size());
+  CPPUNIT_ASSERT_EQUAL((size_t)6, entries[0].getCompactLength());
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.1"), entries[0].getIPAddress());
+  CPPUNIT_ASSERT_EQUAL((uint16_t)6881, entries[0].getPort());
+  CPPUNIT_ASSERT_EQUAL((size_t)18, entries[1].getCompactLength());
+  CPPUNIT_ASSERT_EQUAL(std::string("2001:db8::1"), entries[1].getIPAddress());
+  CPPUNIT_ASSERT_EQUAL((uint16_t)6882, entries[1].getPort());
+}
+
 void DHTPeerAnnounceEntryTest::testGetPeers()
 {
   unsigned char infohash[DHT_ID_LENGTH];
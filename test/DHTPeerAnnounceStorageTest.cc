@@ -11,6 +11,7 @@
 #include "Peer.h"
 #include "FileEntry.h"
 #include "bittorrent_helper.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
@@ -18,10 +19,14 @@ class DHTPeerAnnounceStorageTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(DHTPeerAnnounceStorageTest);
   CPPUNIT_TEST(testAddAnnounce);
+  CPPUNIT_TEST(testHandleTimeout);
+  CPPUNIT_TEST(testAddAnnounce_maxPeers);
   CPPUNIT_TEST_SUITE_END();
 
 public:
   void testAddAnnounce();
+  void testHandleTimeout();
+  void testAddAnnounce_maxPeers();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DHTPeerAnnounceStorageTest);
@@ -47,4 +52,55 @@ void DHTPeerAnnounceStorageTest::testAddAnnounce()
   CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.4"), peers[1]->getIPAddress());
 }
 
+void DHTPeerAnnounceStorageTest::testHandleTimeout()
+{
+  unsigned char infohash1[DHT_ID_LENGTH];
+  memset(infohash1, 0xff, DHT_ID_LENGTH);
+  unsigned char infohash2[DHT_ID_LENGTH];
+  memset(infohash2, 0xf0, DHT_ID_LENGTH);
+  DHTPeerAnnounceStorage storage;
+
+  auto origin = global::wallclock();
+  storage.addPeerAnnounce(infohash1, "192.168.0.1", 6881);
+  storage.addPeerAnnounce(infohash2, "192.168.0.2", 6882);
+  global::wallclock().advance(20_min);
+  storage.addPeerAnnounce(infohash2, "192.168.0.3", 6883);
+  // Refresh 192.168.0.2
+  storage.addPeerAnnounce(infohash2, "192.168.0.2", 6882);
+
+  storage.handleTimeout();
+  CPPUNIT_ASSERT(storage.contains(infohash1));
+  CPPUNIT_ASSERT(storage.contains(infohash2));
+
+  global::wallclock().advance(10_min);
+  storage.handleTimeout();
+  CPPUNIT_ASSERT(!storage.contains(infohash1));
+  CPPUNIT_ASSERT(storage.contains(infohash2));
+  {
+    std::vector<std::shared_ptr<Peer>> peers;
+    storage.getPeers(peers, infohash2);
+    CPPUNIT_ASSERT_EQUAL((size_t)2, peers.size());
+  }
+
+  global::wallclock().advance(20_min);
+  storage.handleTimeout();
+  CPPUNIT_ASSERT(!storage.contains(infohash2));
+
+  global::wallclock() = origin;
+}
+
+void DHTPeerAnnounceStorageTest::testAddAnnounce_maxPeers()
+{
+  unsigned char infohash[DHT_ID_LENGTH];
+  memset(infohash, 0xff, DHT_ID_LENGTH);
+  DHTPeerAnnounceStorage storage;
+
+  for (size_t i = 0; i < DHT_PEER_ANNOUNCE_MAX_PEERS + 10; ++i) {
+    storage.addPeerAnnounce(infohash, "192.168.0.1", 1024 + i);
+  }
+  std::vector<std::shared_ptr<Peer>> peers;
+  storage.getPeers(peers, infohash);
+  CPPUNIT_ASSERT_EQUAL(DHT_PEER_ANNOUNCE_MAX_PEERS, peers.size());
+}
+
 } // namespace aria2
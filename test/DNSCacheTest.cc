@@ -2,6 +2,8 @@
 
 #include <cppunit/extensions/HelperMacros.h>
 
+#include "wallclock.h"
+
 namespace aria2 {
 
 class DNSCacheTest : public CppUnit::TestFixture {
@@ -11,6 +13,9 @@ class DNSCacheTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testMarkBad);
   CPPUNIT_TEST(testPutBadAddr);
   CPPUNIT_TEST(testRemove);
+  CPPUNIT_TEST(testExpire);
+  CPPUNIT_TEST(testPutNegative);
+  CPPUNIT_TEST(testEvictExpired);
   CPPUNIT_TEST_SUITE_END();
 
   DNSCache cache_;
@@ -29,6 +34,9 @@ public:
   void testMarkBad();
   void testPutBadAddr();
   void testRemove();
+  void testExpire();
+  void testPutNegative();
+  void testEvictExpired();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DNSCacheTest);
@@ -61,4 +69,65 @@ void DNSCacheTest::testRemove()
   CPPUNIT_ASSERT_EQUAL(std::string(""), cache_.find("www", 80));
 }
 
+void DNSCacheTest::testExpire()
+{
+  cache_.put("short", "192.168.0.2", 80, std::chrono::seconds(30));
+  // TTL shorter than 10 seconds is rounded up
+  cache_.put("tiny", "192.168.0.3", 80, std::chrono::seconds(0));
+  auto origin = global::wallclock();
+  global::wallclock().advance(std::chrono::seconds(5));
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.3"), cache_.find("tiny", 80));
+  global::wallclock().advance(std::chrono::seconds(25));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), cache_.find("short", 80));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), cache_.find("tiny", 80));
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.1"), cache_.find("www", 80));
+  // Expired entry is replaced, including bad marks.
+  cache_.markBad("www", "192.168.0.1", 80);
+  global::wallclock().advance(DNSCache::DEFAULT_TTL);
+  CPPUNIT_ASSERT_EQUAL(std::string(""), cache_.find("www", 80));
+  cache_.put("www", "192.168.0.1", 80);
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.1"), cache_.find("www", 80));
+  std::vector<std::string> addrs;
+  cache_.findAll(std::back_inserter(addrs), "www", 80);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, addrs.size());
+  global::wallclock() = origin;
+}
+
+void DNSCacheTest::testPutNegative()
+{
+  cache_.putNegative("nx", 80);
+  CPPUNIT_ASSERT(cache_.isNegative("nx", 80));
+  CPPUNIT_ASSERT(!cache_.isNegative("nx", 443));
+  CPPUNIT_ASSERT(!cache_.isNegative("www", 80));
+  CPPUNIT_ASSERT_EQUAL(std::string(""), cache_.find("nx", 80));
+  auto origin = global::wallclock();
+  global::wallclock().advance(DNSCache::NEGATIVE_TTL);
+  CPPUNIT_ASSERT(!cache_.isNegative("nx", 80));
+  global::wallclock() = origin;
+  // Positive result replaces negative one
+  cache_.put("nx", "192.168.0.4", 80);
+  CPPUNIT_ASSERT(!cache_.isNegative("nx", 80));
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.4"), cache_.find("nx", 80));
+}
+
+void DNSCacheTest::testEvictExpired()
+{
+  cache_.put("short", "192.168.0.2", 80, std::chrono::seconds(30));
+  cache_.putNegative("nx", 80);
+  CPPUNIT_ASSERT_EQUAL((size_t)5, cache_.size());
+  auto origin = global::wallclock();
+  global::wallclock().advance(DNSCache::NEGATIVE_TTL);
+  // Expired entries are kept until something is put.
+  CPPUNIT_ASSERT_EQUAL((size_t)5, cache_.size());
+  cache_.put("new", "192.168.0.5", 80);
+  CPPUNIT_ASSERT_EQUAL((size_t)4, cache_.size());
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.1"), cache_.find("www", 80));
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.5"), cache_.find("new", 80));
+  global::wallclock().advance(DNSCache::DEFAULT_TTL);
+  cache_.putNegative("nx", 80);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, cache_.size());
+  CPPUNIT_ASSERT(cache_.isNegative("nx", 80));
+  global::wallclock() = origin;
+}
+
 } // namespace aria2
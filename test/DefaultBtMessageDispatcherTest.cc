@@ -263,6 +263,7 @@ void DefaultBtMessageDispatcherTest::
                        btMessageDispatcher->getMessageQueue().size());
   CPPUNIT_ASSERT_EQUAL((size_t)0,
                        btMessageDispatcher->getRequestSlots().size());
+  CPPUNIT_ASSERT_EQUAL((size_t)0, piece->countBlockRequester(0));
 }
 
 void DefaultBtMessageDispatcherTest::testCountOutstandingRequest()
@@ -313,6 +314,7 @@ void DefaultBtMessageDispatcherTest::testRemoveOutstandingRequest()
                                                        length);
   CPPUNIT_ASSERT(s2);
   CPPUNIT_ASSERT(piece->isBlockUsed(blockIndex));
+  CPPUNIT_ASSERT_EQUAL((size_t)1, piece->countBlockRequester(blockIndex));
 
   btMessageDispatcher->removeOutstandingRequest(s2);
 
@@ -320,6 +322,7 @@ void DefaultBtMessageDispatcherTest::testRemoveOutstandingRequest()
                                                        length);
   CPPUNIT_ASSERT(!s3);
   CPPUNIT_ASSERT(!piece->isBlockUsed(blockIndex));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, piece->countBlockRequester(blockIndex));
 }
 
 } // namespace aria2
@@ -13,6 +13,7 @@
 #include "Piece.h"
 #include "FileEntry.h"
 #include "array_fun.h"
+#include "File.h"
 #ifdef ENABLE_BITTORRENT
 #  include "MockPeerStorage.h"
 #  include "BtRuntime.h"
@@ -38,6 +39,7 @@ class DefaultBtProgressInfoFileTest : public CppUnit::TestFixture {
 #endif // !WORDS_BIGENDIAN
   CPPUNIT_TEST(testLoad_nonBt_pieceLengthShorter);
   CPPUNIT_TEST(testUpdateFilename);
+  CPPUNIT_TEST(testRemoveFile_durableSave);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -100,6 +102,7 @@ public:
 #endif // !WORDS_BIGENDIAN
   void testLoad_nonBt_pieceLengthShorter();
   void testUpdateFilename();
+  void testRemoveFile_durableSave();
 };
 
 #undef BLOCK_LENGTH
@@ -577,4 +580,25 @@ void DefaultBtProgressInfoFileTest::testUpdateFilename()
                        infoFile.getFilename());
 }
 
+void DefaultBtProgressInfoFileTest::testRemoveFile_durableSave()
+{
+  initializeMembers(1_k, 80_k);
+  option_->put(PREF_DURABLE_SAVE, A2_V_TRUE);
+
+  std::shared_ptr<DownloadContext> dctx(
+      new DownloadContext(1_k, 80_k, A2_TEST_OUT_DIR "/remove-durable"));
+  DefaultBtProgressInfoFile infoFile(dctx, pieceStorage_, option_.get());
+  File(infoFile.getFilename()).remove();
+  { std::ofstream(infoFile.getFilename().c_str()); }
+
+  // The control file is kept if data could not be synced.
+  pieceStorage_->setSyncDataFailure(true);
+  infoFile.removeFile();
+  CPPUNIT_ASSERT(infoFile.exists());
+
+  pieceStorage_->setSyncDataFailure(false);
+  infoFile.removeFile();
+  CPPUNIT_ASSERT(!infoFile.exists());
+}
+
 } // namespace aria2
@@ -23,6 +23,7 @@ class DefaultBtRequestFactoryTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testRemoveCompletedPiece);
   CPPUNIT_TEST(testCreateRequestMessages);
   CPPUNIT_TEST(testCreateRequestMessages_onEndGame);
+  CPPUNIT_TEST(testCreateRequestMessages_onEndGame_fewestRequesters);
   CPPUNIT_TEST(testRemoveTargetPiece);
   CPPUNIT_TEST(testGetTargetPieceIndexes);
   CPPUNIT_TEST_SUITE_END();
@@ -39,6 +40,7 @@ public:
   void testRemoveCompletedPiece();
   void testCreateRequestMessages();
   void testCreateRequestMessages_onEndGame();
+  void testCreateRequestMessages_onEndGame_fewestRequesters();
   void testRemoveTargetPiece();
   void testGetTargetPieceIndexes();
 
@@ -183,6 +185,42 @@ void DefaultBtRequestFactoryTest::testCreateRequestMessages_onEndGame()
   CPPUNIT_ASSERT_EQUAL((size_t)1, msg->getBlockIndex());
 }
 
+void DefaultBtRequestFactoryTest::
+    testCreateRequestMessages_onEndGame_fewestRequesters()
+{
+  constexpr int PIECE_LENGTH = 64_k;
+  auto piece1 = std::make_shared<Piece>(0, PIECE_LENGTH);
+  auto piece2 = std::make_shared<Piece>(1, PIECE_LENGTH);
+  requestFactory_->addTargetPiece(piece1);
+  requestFactory_->addTargetPiece(piece2);
+  // Other peers are working on all blocks but piece2's block 3 and
+  // piece1's block 2.
+  for (size_t i = 0; i < 4; ++i) {
+    piece1->addBlockRequester(i, 100);
+    piece2->addBlockRequester(i, 100);
+    piece2->addBlockRequester(i, 200);
+  }
+  piece1->removeBlockRequester(2, 100);
+  piece2->removeBlockRequester(3, 100);
+  piece2->removeBlockRequester(3, 200);
+
+  auto msgs = requestFactory_->createRequestMessages(2, true);
+  std::sort(std::begin(msgs), std::end(msgs), BtRequestMessageSorter());
+
+  CPPUNIT_ASSERT_EQUAL((size_t)2, msgs.size());
+  CPPUNIT_ASSERT_EQUAL((size_t)0, msgs[0]->getIndex());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, msgs[0]->getBlockIndex());
+  CPPUNIT_ASSERT_EQUAL((size_t)1, msgs[1]->getIndex());
+  CPPUNIT_ASSERT_EQUAL((size_t)3, msgs[1]->getBlockIndex());
+
+  // Blocks requested by one other peer come next.
+  msgs = requestFactory_->createRequestMessages(6, true);
+  CPPUNIT_ASSERT_EQUAL((size_t)6, msgs.size());
+  for (size_t i = 2; i < 5; ++i) {
+    CPPUNIT_ASSERT_EQUAL((size_t)0, msgs[i]->getIndex());
+  }
+}
+
 void DefaultBtRequestFactoryTest::testRemoveTargetPiece()
 {
   auto piece1 = std::make_shared<Piece>(0, 16_k);
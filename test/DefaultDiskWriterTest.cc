@@ -2,6 +2,8 @@
 #include <cppunit/extensions/HelperMacros.h>
 
 #include "a2functional.h"
+#include "File.h"
+#include "Exception.h"
 
 namespace aria2 {
 
@@ -9,6 +11,10 @@ class DefaultDiskWriterTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(DefaultDiskWriterTest);
   CPPUNIT_TEST(testSize);
+  CPPUNIT_TEST(testDirectIO);
+  CPPUNIT_TEST(testGetMappedData);
+  CPPUNIT_TEST(testSync);
+  CPPUNIT_TEST(testSync_closeFailure);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -16,6 +22,10 @@ public:
   void setUp() {}
 
   void testSize();
+  void testDirectIO();
+  void testGetMappedData();
+  void testSync();
+  void testSync_closeFailure();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(DefaultDiskWriterTest);
@@ -28,4 +38,127 @@ void DefaultDiskWriterTest::testSize()
   CPPUNIT_ASSERT_EQUAL((int64_t)4_k, dw.size());
 }
 
+void DefaultDiskWriterTest::testDirectIO()
+{
+  std::string path =
+      A2_TEST_OUT_DIR "/aria2_DefaultDiskWriterTest_testDirectIO";
+  File(path).remove();
+  DefaultDiskWriter dw(path);
+  dw.enableDirectIO();
+  dw.openFile();
+  std::string expected;
+  auto write = [&](const std::string& data, size_t offset) {
+    dw.writeData(reinterpret_cast<const unsigned char*>(data.c_str()),
+                 data.size(), offset);
+    if (expected.size() < offset + data.size()) {
+      expected.resize(offset + data.size());
+    }
+    expected.replace(offset, data.size(), data);
+  };
+  // Partial blocks past the end of file
+  write("abc", 0);
+  write(std::string(5000, 'x'), 100);
+  CPPUNIT_ASSERT_EQUAL((int64_t)5100, dw.size());
+  // Unaligned head block is read and written back.
+  write(std::string(10000, 'y'), 4090);
+  write(std::string(1_m + 10, 'z'), 7);
+  write("0123456789", 4_k);
+  CPPUNIT_ASSERT_EQUAL((int64_t)expected.size(), dw.size());
+
+  std::string buf(expected.size(), '\0');
+  CPPUNIT_ASSERT_EQUAL(
+      (ssize_t)expected.size(),
+      dw.readData(reinterpret_cast<unsigned char*>(&buf[0]), buf.size(), 0));
+  CPPUNIT_ASSERT(expected == buf);
+  CPPUNIT_ASSERT_EQUAL(
+      (ssize_t)20,
+      dw.readData(reinterpret_cast<unsigned char*>(&buf[0]), 20, 4090));
+  CPPUNIT_ASSERT_EQUAL(expected.substr(4090, 20), buf.substr(0, 20));
+  // Reading past the end of file
+  CPPUNIT_ASSERT_EQUAL((ssize_t)3,
+                       dw.readData(reinterpret_cast<unsigned char*>(&buf[0]),
+                                   20, expected.size() - 3));
+  dw.closeFile();
+}
+
+void DefaultDiskWriterTest::testGetMappedData()
+{
+  std::string path =
+      A2_TEST_OUT_DIR "/aria2_DefaultDiskWriterTest_testGetMappedData";
+  File(path).remove();
+  {
+    DefaultDiskWriter dw(path);
+    dw.openFile();
+    dw.writeData(reinterpret_cast<const unsigned char*>("0123456789"), 10, 0);
+    dw.closeFile();
+  }
+  DefaultDiskWriter dw(path);
+  // Not mapped unless mmap is enabled
+  dw.enableReadOnly();
+  dw.openExistingFile();
+  CPPUNIT_ASSERT(!dw.getMappedData(4, 3));
+  dw.closeFile();
+
+  dw.enableMmap();
+  dw.openExistingFile();
+#if defined(HAVE_MMAP) || defined(__MINGW32__)
+  auto data = dw.getMappedData(4, 3);
+  CPPUNIT_ASSERT(data);
+  CPPUNIT_ASSERT_EQUAL(std::string("3456"), std::string(data, data + 4));
+  CPPUNIT_ASSERT(!dw.getMappedData(4, 7));
+#endif // HAVE_MMAP || __MINGW32__
+  unsigned char buf[4];
+  CPPUNIT_ASSERT_EQUAL((ssize_t)3, dw.readData(buf, sizeof(buf), 7));
+  CPPUNIT_ASSERT_EQUAL(std::string("789"), std::string(buf, buf + 3));
+  dw.closeFile();
+}
+
+void DefaultDiskWriterTest::testSync()
+{
+  std::string path = A2_TEST_OUT_DIR "/aria2_DefaultDiskWriterTest_testSync";
+  File(path).remove();
+  DefaultDiskWriter dw(path);
+  // Nothing to sync before the file is opened.
+  dw.sync();
+  dw.enableDataSync();
+  dw.openFile();
+  dw.writeData(reinterpret_cast<const unsigned char*>("0123456789"), 10, 0);
+  dw.writeback(10, 0);
+  dw.sync();
+  dw.writeData(reinterpret_cast<const unsigned char*>("abc"), 3, 10);
+  // Synced on close.
+  dw.closeFile();
+  CPPUNIT_ASSERT_EQUAL((int64_t)13, File(path).size());
+
+  dw.enableMmap();
+  dw.openExistingFile();
+  dw.writeData(reinterpret_cast<const unsigned char*>("x"), 1, 0);
+  dw.sync();
+  unsigned char buf[3];
+  CPPUNIT_ASSERT_EQUAL((ssize_t)3, dw.readData(buf, sizeof(buf), 0));
+  CPPUNIT_ASSERT_EQUAL(std::string("x12"), std::string(buf, buf + 3));
+  dw.closeFile();
+}
+
+void DefaultDiskWriterTest::testSync_closeFailure()
+{
+#ifdef __linux__
+  // fdatasync() fails with EINVAL on /dev/null.
+  DefaultDiskWriter dw("/dev/null");
+  dw.enableDataSync();
+  dw.openExistingFile();
+  dw.writeData(reinterpret_cast<const unsigned char*>("0123456789"), 10, 0);
+  // The failure is only logged here.
+  dw.closeFile();
+  try {
+    dw.sync();
+    CPPUNIT_FAIL("exception must be thrown.");
+  }
+  catch (Exception& e) {
+  }
+  // The error is reported once.
+  dw.sync();
+#endif // __linux__
+}
+
 } // namespace aria2
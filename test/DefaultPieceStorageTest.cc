@@ -38,6 +38,7 @@ class DefaultPieceStorageTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testMarkPiecesDone);
   CPPUNIT_TEST(testGetCompletedLength);
   CPPUNIT_TEST(testGetFilteredCompletedLength);
+  CPPUNIT_TEST(testPadFile);
   CPPUNIT_TEST(testGetNextUsedIndex);
   CPPUNIT_TEST(testAdvertisePiece);
   CPPUNIT_TEST_SUITE_END();
@@ -77,6 +78,7 @@ public:
   void testMarkPiecesDone();
   void testGetCompletedLength();
   void testGetFilteredCompletedLength();
+  void testPadFile();
   void testGetNextUsedIndex();
   void testAdvertisePiece();
 };
@@ -391,6 +393,30 @@ void DefaultPieceStorageTest::testGetFilteredCompletedLength()
                        ps.getFilteredCompletedLength());
 }
 
+void DefaultPieceStorageTest::testPadFile()
+{
+  auto dctx = std::make_shared<DownloadContext>();
+  dctx->setPieceLength(4);
+  auto files = std::vector<std::shared_ptr<FileEntry>>{
+      std::make_shared<FileEntry>("foo", 6, 0),
+      std::make_shared<FileEntry>("pad0", 10, 6),
+      std::make_shared<FileEntry>("bar", 4, 16),
+      std::make_shared<FileEntry>("pad1", 2, 20)};
+  files[1]->setPadFile(true);
+  files[3]->setPadFile(true);
+  dctx->setFileEntries(std::begin(files), std::end(files));
+
+  DefaultPieceStorage ps(dctx, option_.get());
+  // Piece 1 contains the last part of foo.  Piece 5 is the last piece,
+  // which is shorter than the others.
+  CPPUNIT_ASSERT(!ps.hasPiece(1));
+  CPPUNIT_ASSERT(ps.hasPiece(2));
+  CPPUNIT_ASSERT(ps.hasPiece(3));
+  CPPUNIT_ASSERT(!ps.hasPiece(4));
+  CPPUNIT_ASSERT(ps.hasPiece(5));
+  CPPUNIT_ASSERT_EQUAL((int64_t)10, ps.getCompletedLength());
+}
+
 void DefaultPieceStorageTest::testGetNextUsedIndex()
 {
   DefaultPieceStorage pss(dctx_, option_.get());
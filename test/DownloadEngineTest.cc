@@ -0,0 +1,129 @@
+#include "DownloadEngine.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "SelectEventPoll.h"
+#include "SocketCore.h"
+#include "A2STR.h"
+#include "wallclock.h"
+
+namespace aria2 {
+
+class DownloadEngineTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(DownloadEngineTest);
+  CPPUNIT_TEST(testPopPooledSocket);
+  CPPUNIT_TEST(testPoolSocket_maxPerKey);
+  CPPUNIT_TEST(testPopPooledSocket_closedByPeer);
+  CPPUNIT_TEST(testEvictSocketPool);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::unique_ptr<DownloadEngine> e_;
+  std::shared_ptr<SocketCore> listenSocket_;
+  uint16_t listenPort_;
+  // Keep server side of connections open
+  std::vector<std::shared_ptr<SocketCore>> serverSockets_;
+
+  std::shared_ptr<SocketCore> connect()
+  {
+    auto socket = std::make_shared<SocketCore>();
+    socket->establishConnection("localhost", listenPort_);
+    while (!socket->isWritable(0))
+      ;
+    serverSockets_.push_back(listenSocket_->acceptConnection());
+    return socket;
+  }
+
+public:
+  void setUp()
+  {
+    e_ = make_unique<DownloadEngine>(make_unique<SelectEventPoll>());
+    listenSocket_ = std::make_shared<SocketCore>();
+    listenSocket_->bind(0);
+    listenSocket_->beginListen();
+    listenSocket_->setBlockingMode();
+    listenPort_ = listenSocket_->getAddrInfo().port;
+  }
+
+  void tearDown() { serverSockets_.clear(); }
+
+  void testPopPooledSocket();
+  void testPoolSocket_maxPerKey();
+  void testPopPooledSocket_closedByPeer();
+  void testEvictSocketPool();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(DownloadEngineTest);
+
+void DownloadEngineTest::testPopPooledSocket()
+{
+  auto s1 = connect();
+  auto s2 = connect();
+  e_->poolSocket("192.168.0.1", 80, A2STR::NIL, 0, s1);
+  e_->poolSocket("192.168.0.1", 80, A2STR::NIL, 0, s2);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, e_->getSocketPoolSize());
+  CPPUNIT_ASSERT(!e_->popPooledSocket("192.168.0.1", 8080, A2STR::NIL, 0));
+  // The most recently pooled one comes first
+  CPPUNIT_ASSERT(s2 == e_->popPooledSocket("192.168.0.1", 80, A2STR::NIL, 0));
+  CPPUNIT_ASSERT(s1 == e_->popPooledSocket("192.168.0.1", 80, A2STR::NIL, 0));
+  CPPUNIT_ASSERT(!e_->popPooledSocket("192.168.0.1", 80, A2STR::NIL, 0));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, e_->getSocketPoolSize());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)2, e_->getSocketPoolHits());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)2, e_->getSocketPoolMisses());
+
+  std::string options;
+  e_->poolSocket("192.168.0.1", 21, "alpha", A2STR::NIL, 0, s1,
+                 "baseWorkingDir");
+  CPPUNIT_ASSERT(!e_->popPooledSocket(options, "192.168.0.1", 21, "bravo",
+                                      A2STR::NIL, 0));
+  CPPUNIT_ASSERT(s1 == e_->popPooledSocket(options, "192.168.0.1", 21, "alpha",
+                                           A2STR::NIL, 0));
+  CPPUNIT_ASSERT_EQUAL(std::string("baseWorkingDir"), options);
+}
+
+void DownloadEngineTest::testPoolSocket_maxPerKey()
+{
+  std::shared_ptr<SocketCore> last;
+  for (int i = 0; i < 17; ++i) {
+    last = connect();
+    e_->poolSocket("192.168.0.1", 80, A2STR::NIL, 0, last);
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)16, e_->getSocketPoolSize());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)1, e_->getSocketPoolEvicted());
+  CPPUNIT_ASSERT(last == e_->popPooledSocket("192.168.0.1", 80, A2STR::NIL, 0));
+}
+
+void DownloadEngineTest::testPopPooledSocket_closedByPeer()
+{
+  auto s1 = connect();
+  auto s2 = connect();
+  e_->poolSocket("192.168.0.1", 80, A2STR::NIL, 0, s1);
+  e_->poolSocket("192.168.0.1", 80, A2STR::NIL, 0, s2);
+  serverSockets_[1]->closeConnection();
+  while (!s2->isReadable(0))
+    ;
+  // s2 is closed by peer and evicted.
+  CPPUNIT_ASSERT(s1 == e_->popPooledSocket("192.168.0.1", 80, A2STR::NIL, 0));
+  CPPUNIT_ASSERT_EQUAL((uint64_t)1, e_->getSocketPoolEvicted());
+  CPPUNIT_ASSERT_EQUAL((size_t)0, e_->getSocketPoolSize());
+}
+
+void DownloadEngineTest::testEvictSocketPool()
+{
+  auto origin = global::wallclock();
+  // SocketPoolEntry records the current time, not global::wallclock().
+  global::wallclock().reset();
+  e_->poolSocket("192.168.0.1", 80, A2STR::NIL, 0, connect(), 10_s);
+  e_->poolSocket("192.168.0.1", 80, A2STR::NIL, 0, connect(), 30_s);
+  e_->poolSocket("192.168.0.2", 80, A2STR::NIL, 0, connect(), 10_s);
+  global::wallclock().advance(20_s);
+  e_->evictSocketPool();
+  global::wallclock() = origin;
+  CPPUNIT_ASSERT_EQUAL((size_t)1, e_->getSocketPoolSize());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)2, e_->getSocketPoolEvicted());
+  CPPUNIT_ASSERT(!e_->popPooledSocket("192.168.0.2", 80, A2STR::NIL, 0));
+  CPPUNIT_ASSERT(e_->popPooledSocket("192.168.0.1", 80, A2STR::NIL, 0));
+}
+
+} // namespace aria2
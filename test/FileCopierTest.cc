@@ -0,0 +1,127 @@
+#include "FileCopier.h"
+
+#include <fstream>
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "File.h"
+#include "TimeA2.h"
+#include "Exception.h"
+#include "TestUtil.h"
+#include "a2functional.h"
+#include "a2io.h"
+#include "util.h"
+
+namespace aria2 {
+
+class FileCopierTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(FileCopierTest);
+  CPPUNIT_TEST(testCopyChunk);
+  CPPUNIT_TEST(testCopyChunk_empty);
+  CPPUNIT_TEST(testCopyChunk_srcNotFound);
+  CPPUNIT_TEST(testRemovePartialCopy);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testCopyChunk();
+  void testCopyChunk_empty();
+  void testCopyChunk_srcNotFound();
+  void testRemovePartialCopy();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(FileCopierTest);
+
+namespace {
+std::string createData(const std::string& path, size_t length)
+{
+  std::string data;
+  for (size_t i = 0; i < length; ++i) {
+    data += static_cast<char>(i % 251);
+  }
+  std::ofstream out(path.c_str(), std::ios::binary);
+  out << data;
+  return data;
+}
+} // namespace
+
+void FileCopierTest::testCopyChunk()
+{
+  std::string src = A2_TEST_OUT_DIR "/aria2_FileCopierTest_testCopyChunk";
+  std::string dest = src + "_dest";
+  auto data = createData(src, 1_m + 100);
+  File(src).utime(Time(100000), Time(200000));
+#ifndef __MINGW32__
+  chmod(src.c_str(), 0640);
+#endif // !__MINGW32__
+  // The destination is replaced.
+  createFile(dest, 2_m);
+
+  FileCopier copier(src, dest);
+  copier.copyChunk();
+  CPPUNIT_ASSERT(!copier.finished());
+  CPPUNIT_ASSERT_EQUAL((int64_t)1_m, copier.getCurrentLength());
+  while (!copier.finished()) {
+    copier.copyChunk();
+  }
+  CPPUNIT_ASSERT_EQUAL((int64_t)1_m + 100, copier.getCurrentLength());
+  CPPUNIT_ASSERT(data == readFile(dest));
+  CPPUNIT_ASSERT_EQUAL((time_t)200000,
+                       File(dest).getModifiedTime().getTimeFromEpoch());
+#ifndef __MINGW32__
+  a2_struct_stat st;
+  CPPUNIT_ASSERT_EQUAL(0, a2stat(utf8ToWChar(dest).c_str(), &st));
+  CPPUNIT_ASSERT_EQUAL((mode_t)0640, (mode_t)(st.st_mode & 07777));
+#endif // !__MINGW32__
+  CPPUNIT_ASSERT(File(src).isFile());
+}
+
+void FileCopierTest::testCopyChunk_empty()
+{
+  std::string src = A2_TEST_OUT_DIR "/aria2_FileCopierTest_testCopyChunk_empty";
+  std::string dest = src + "_dest";
+  createFile(src, 0);
+  File(dest).remove();
+  {
+    FileCopier copier(src, dest);
+    copier.copyChunk();
+    CPPUNIT_ASSERT(copier.finished());
+  }
+  CPPUNIT_ASSERT(File(dest).isFile());
+  CPPUNIT_ASSERT_EQUAL((int64_t)0, File(dest).size());
+}
+
+void FileCopierTest::testCopyChunk_srcNotFound()
+{
+  std::string src =
+      A2_TEST_OUT_DIR "/aria2_FileCopierTest_testCopyChunk_srcNotFound";
+  std::string dest = src + "_dest";
+  File(src).remove();
+  File(dest).remove();
+  FileCopier copier(src, dest);
+  try {
+    copier.copyChunk();
+    CPPUNIT_FAIL("exception must be thrown.");
+  }
+  catch (Exception& e) {
+  }
+  CPPUNIT_ASSERT(!copier.finished());
+  CPPUNIT_ASSERT(!File(dest).exists());
+}
+
+void FileCopierTest::testRemovePartialCopy()
+{
+  std::string src =
+      A2_TEST_OUT_DIR "/aria2_FileCopierTest_testRemovePartialCopy";
+  std::string dest = src + "_dest";
+  createData(src, 1_m + 100);
+  {
+    FileCopier copier(src, dest);
+    copier.copyChunk();
+    CPPUNIT_ASSERT(File(dest).isFile());
+  }
+  CPPUNIT_ASSERT(!File(dest).exists());
+  CPPUNIT_ASSERT(File(src).isFile());
+}
+
+} // namespace aria2
@@ -23,6 +23,7 @@ class FileTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testGetDirname);
   CPPUNIT_TEST(testGetBasename);
   CPPUNIT_TEST(testRenameTo);
+  CPPUNIT_TEST(testCopyTo);
   CPPUNIT_TEST(testUtime);
   CPPUNIT_TEST_SUITE_END();
 
@@ -39,6 +40,7 @@ public:
   void testGetDirname();
   void testGetBasename();
   void testRenameTo();
+  void testCopyTo();
   void testUtime();
 };
 
@@ -253,6 +255,34 @@ void FileTest::testRenameTo()
   CPPUNIT_ASSERT(f.renameTo(fname));
 }
 
+void FileTest::testCopyTo()
+{
+  std::string fname = A2_TEST_OUT_DIR "/aria2_FileTest_testCopyTo.txt";
+  std::string dest = A2_TEST_OUT_DIR "/aria2_FileTest_testCopyTo_dest.txt";
+  {
+    std::ofstream of(fname.c_str(), std::ios::binary);
+    of << "aria2 copy";
+  }
+  File f(fname);
+  f.utime(Time(100000), Time(200000));
+  // The destination is replaced.
+  createFile(dest, 100);
+  CPPUNIT_ASSERT(f.copyTo(dest));
+  CPPUNIT_ASSERT(f.exists());
+  CPPUNIT_ASSERT_EQUAL(std::string("aria2 copy"), readFile(dest));
+  CPPUNIT_ASSERT_EQUAL((time_t)200000,
+                       File(dest).getModifiedTime().getTimeFromEpoch());
+
+  File notFound(A2_TEST_OUT_DIR "/aria2_FileTest_testCopyTo_notFound");
+  notFound.remove();
+  CPPUNIT_ASSERT(!notFound.copyTo(dest));
+  CPPUNIT_ASSERT(!notFound.moveTo(dest));
+  // Renamed on the same file system.
+  CPPUNIT_ASSERT(f.moveTo(dest));
+  CPPUNIT_ASSERT(!File(fname).exists());
+  CPPUNIT_ASSERT_EQUAL(dest, f.getPath());
+}
+
 void FileTest::testUtime()
 {
   File f(A2_TEST_OUT_DIR "/aria2_FileTest_testUTime");
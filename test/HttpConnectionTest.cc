@@ -0,0 +1,175 @@
+#include "HttpConnection.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "SocketCore.h"
+#include "SocketRecvBuffer.h"
+#include "HttpRequest.h"
+#include "HttpResponse.h"
+#include "HttpHeader.h"
+#include "Request.h"
+#include "PiecedSegment.h"
+#include "Piece.h"
+#include "FileEntry.h"
+#include "Option.h"
+#include "AuthConfigFactory.h"
+#include "RecoverableException.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+class HttpConnectionTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(HttpConnectionTest);
+  CPPUNIT_TEST(testCalculatePipeliningDepth);
+  CPPUNIT_TEST(testIsPipelinedRequestIgnored);
+  CPPUNIT_TEST(testIsPipelinedRequestIgnored_partialResponse);
+  CPPUNIT_TEST(testIsPipelinedRequestIgnored_secondResponse);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::shared_ptr<SocketCore> clientSocket_;
+  std::shared_ptr<SocketCore> serverSocket_;
+  std::shared_ptr<Request> request_;
+  std::shared_ptr<FileEntry> fileEntry_;
+  std::unique_ptr<Option> option_;
+  std::unique_ptr<AuthConfigFactory> authConfigFactory_;
+
+  std::unique_ptr<HttpRequest> createHttpRequest(size_t index);
+
+  // Sends 3 requests, the second and third of which are pipelined.
+  std::unique_ptr<HttpConnection> createPipelinedConnection();
+
+public:
+  void setUp()
+  {
+    SocketCore listenSocket;
+    listenSocket.bind(0);
+    listenSocket.beginListen();
+    listenSocket.setBlockingMode();
+    clientSocket_ = std::make_shared<SocketCore>();
+    clientSocket_->establishConnection("localhost",
+                                       listenSocket.getAddrInfo().port);
+    clientSocket_->setBlockingMode();
+    serverSocket_ = listenSocket.acceptConnection();
+    serverSocket_->setBlockingMode();
+
+    request_ = std::make_shared<Request>();
+    request_->setUri("http://localhost/aria2.tar.bz2");
+    request_->setPipeliningHint(true);
+    fileEntry_ = std::make_shared<FileEntry>("aria2.tar.bz2", 10_k, 0);
+    option_ = make_unique<Option>();
+    authConfigFactory_ = make_unique<AuthConfigFactory>();
+  }
+
+  void testCalculatePipeliningDepth();
+  void testIsPipelinedRequestIgnored();
+  void testIsPipelinedRequestIgnored_partialResponse();
+  void testIsPipelinedRequestIgnored_secondResponse();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(HttpConnectionTest);
+
+void HttpConnectionTest::testCalculatePipeliningDepth()
+{
+  auto socket = std::make_shared<SocketCore>();
+  HttpConnection conn(1, socket, std::make_shared<SocketRecvBuffer>(socket));
+  // No RTT sample yet
+  CPPUNIT_ASSERT_EQUAL(2, conn.calculatePipeliningDepth(1_m, 1_m, 8));
+  CPPUNIT_ASSERT_EQUAL(1, conn.calculatePipeliningDepth(1_m, 1_m, 1));
+
+  conn.setRTT(200_ms);
+  // 1MiB/s * 200ms = 204.8KiB in flight, which is 4 segments of
+  // 64KiB, plus the one being downloaded.
+  CPPUNIT_ASSERT_EQUAL(5, conn.calculatePipeliningDepth(64_k, 1_m, 8));
+  // Limited by maxDepth
+  CPPUNIT_ASSERT_EQUAL(8, conn.calculatePipeliningDepth(16_k, 1_m, 8));
+  // Large segments need no deep pipeline
+  CPPUNIT_ASSERT_EQUAL(2, conn.calculatePipeliningDepth(1_m, 1_m, 8));
+  // Unknown speed
+  CPPUNIT_ASSERT_EQUAL(2, conn.calculatePipeliningDepth(64_k, 0, 8));
+}
+
+std::unique_ptr<HttpRequest> HttpConnectionTest::createHttpRequest(size_t index)
+{
+  auto httpRequest = make_unique<HttpRequest>();
+  httpRequest->setRequest(request_);
+  httpRequest->setSegment(std::make_shared<PiecedSegment>(
+      1_k, std::make_shared<Piece>(index, 1_k)));
+  httpRequest->setFileEntry(fileEntry_);
+  httpRequest->setAuthConfigFactory(authConfigFactory_.get());
+  httpRequest->setOption(option_.get());
+  return httpRequest;
+}
+
+std::unique_ptr<HttpConnection> HttpConnectionTest::createPipelinedConnection()
+{
+  auto conn = make_unique<HttpConnection>(
+      1, clientSocket_, std::make_shared<SocketRecvBuffer>(clientSocket_));
+  for (size_t i = 0; i < 3; ++i) {
+    conn->sendRequest(createHttpRequest(i));
+  }
+  CPPUNIT_ASSERT(!conn->isPipelinedResponsePending());
+  CPPUNIT_ASSERT(!conn->isPipelinedRequestIgnored());
+  return conn;
+}
+
+namespace {
+const std::string RESPONSE_HEADER = "HTTP/1.1 206 Partial Content\r\n"
+                                    "Content-Length: 0\r\n"
+                                    "\r\n";
+} // namespace
+
+void HttpConnectionTest::testIsPipelinedRequestIgnored()
+{
+  auto conn = createPipelinedConnection();
+  serverSocket_->writeData(RESPONSE_HEADER);
+  serverSocket_->closeConnection();
+  CPPUNIT_ASSERT(conn->receiveResponse());
+  CPPUNIT_ASSERT(conn->isPipelinedResponsePending());
+  try {
+    conn->receiveResponse();
+    CPPUNIT_FAIL("exception must be thrown.");
+  }
+  catch (RecoverableException& e) {
+    // The server closed the connection after the first response.
+    CPPUNIT_ASSERT(conn->isPipelinedRequestIgnored());
+  }
+}
+
+void HttpConnectionTest::testIsPipelinedRequestIgnored_partialResponse()
+{
+  auto conn = createPipelinedConnection();
+  serverSocket_->writeData(RESPONSE_HEADER + "HTTP/1.1 206");
+  serverSocket_->closeConnection();
+  CPPUNIT_ASSERT(conn->receiveResponse());
+  try {
+    while (!conn->receiveResponse())
+      ;
+    CPPUNIT_FAIL("exception must be thrown.");
+  }
+  catch (RecoverableException& e) {
+    // The server started to answer the pipelined request.
+    CPPUNIT_ASSERT(!conn->isPipelinedRequestIgnored());
+  }
+}
+
+void HttpConnectionTest::testIsPipelinedRequestIgnored_secondResponse()
+{
+  auto conn = createPipelinedConnection();
+  serverSocket_->writeData(RESPONSE_HEADER + RESPONSE_HEADER);
+  serverSocket_->closeConnection();
+  CPPUNIT_ASSERT(conn->receiveResponse());
+  CPPUNIT_ASSERT(conn->receiveResponse());
+  try {
+    conn->receiveResponse();
+    CPPUNIT_FAIL("exception must be thrown.");
+  }
+  catch (RecoverableException& e) {
+    // The server answered a pipelined request before, so the closure
+    // is not blamed on pipelining.
+    CPPUNIT_ASSERT(!conn->isPipelinedRequestIgnored());
+  }
+}
+
+} // namespace aria2
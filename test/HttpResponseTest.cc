@@ -338,6 +338,28 @@ void HttpResponseTest::testGetContentEncodingStreamFilter()
                          filter->getName());
   }
 #endif // HAVE_ZLIB
+#ifdef HAVE_LIBBROTLI
+  httpResponse.setHttpHeader(make_unique<HttpHeader>());
+  httpResponse.getHttpHeader()->put(HttpHeader::CONTENT_ENCODING, "br");
+  {
+    std::shared_ptr<StreamFilter> filter =
+        httpResponse.getContentEncodingStreamFilter();
+    CPPUNIT_ASSERT(filter);
+    CPPUNIT_ASSERT_EQUAL(std::string("BrotliDecodingStreamFilter"),
+                         filter->getName());
+  }
+#endif // HAVE_LIBBROTLI
+#ifdef HAVE_LIBZSTD
+  httpResponse.setHttpHeader(make_unique<HttpHeader>());
+  httpResponse.getHttpHeader()->put(HttpHeader::CONTENT_ENCODING, "zstd");
+  {
+    std::shared_ptr<StreamFilter> filter =
+        httpResponse.getContentEncodingStreamFilter();
+    CPPUNIT_ASSERT(filter);
+    CPPUNIT_ASSERT_EQUAL(std::string("ZstdDecodingStreamFilter"),
+                         filter->getName());
+  }
+#endif // HAVE_LIBZSTD
   httpResponse.setHttpHeader(make_unique<HttpHeader>());
   httpResponse.getHttpHeader()->put(HttpHeader::CONTENT_ENCODING, "bzip2");
   {
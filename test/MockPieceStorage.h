@@ -7,6 +7,7 @@
 
 #include "BitfieldMan.h"
 #include "FatalException.h"
+#include "DlAbortEx.h"
 #include "Piece.h"
 #include "DiskAdaptor.h"
 
@@ -26,6 +27,7 @@ private:
   std::deque<std::shared_ptr<Piece>> inFlightPieces;
   bool downloadFinished_;
   bool allDownloadFinished_;
+  bool syncDataFailure_;
 
 public:
   MockPieceStorage()
@@ -37,7 +39,8 @@ public:
         selectiveDownloadingMode(false),
         endGame(false),
         downloadFinished_(false),
-        allDownloadFinished_(false)
+        allDownloadFinished_(false),
+        syncDataFailure_(false)
   {
   }
 
@@ -184,6 +187,8 @@ public:
 
   virtual void initStorage() CXX11_OVERRIDE {}
 
+  virtual void reopenStorage() CXX11_OVERRIDE {}
+
   virtual const unsigned char* getBitfield() CXX11_OVERRIDE
   {
     return bitfieldMan->getBitfield();
@@ -221,6 +226,10 @@ public:
 
   virtual void enterEndGame() CXX11_OVERRIDE { this->endGame = true; }
 
+  virtual void addEndGameDuplicateLength(int64_t length) CXX11_OVERRIDE {}
+
+  virtual int64_t getEndGameDuplicateLength() CXX11_OVERRIDE { return 0; }
+
   virtual std::shared_ptr<DiskAdaptor> getDiskAdaptor() CXX11_OVERRIDE
   {
     return diskAdaptor;
@@ -228,8 +237,19 @@ public:
 
   virtual WrDiskCache* getWrDiskCache() CXX11_OVERRIDE { return 0; }
 
+  virtual RdDiskCache* getRdDiskCache() CXX11_OVERRIDE { return 0; }
+
   virtual void flushWrDiskCacheEntry() CXX11_OVERRIDE {}
 
+  virtual void syncData() CXX11_OVERRIDE
+  {
+    if (syncDataFailure_) {
+      throw DL_ABORT_EX("sync failure");
+    }
+  }
+
+  void setSyncDataFailure(bool f) { syncDataFailure_ = f; }
+
   void setDiskAdaptor(const std::shared_ptr<DiskAdaptor>& adaptor)
   {
     this->diskAdaptor = adaptor;
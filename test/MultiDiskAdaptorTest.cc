@@ -13,6 +13,7 @@
 #include "TestUtil.h"
 #include "DiskWriter.h"
 #include "WrDiskCacheEntry.h"
+#include "util.h"
 
 namespace aria2 {
 
@@ -26,6 +27,9 @@ class MultiDiskAdaptorTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testUtime);
   CPPUNIT_TEST(testResetDiskWriterEntries);
   CPPUNIT_TEST(testWriteCache);
+  CPPUNIT_TEST(testPadFile);
+  CPPUNIT_TEST(testPartsStore);
+  CPPUNIT_TEST(testPartsStore_move);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -45,6 +49,9 @@ public:
   void testUtime();
   void testResetDiskWriterEntries();
   void testWriteCache();
+  void testPadFile();
+  void testPartsStore();
+  void testPartsStore_move();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(MultiDiskAdaptorTest);
@@ -483,4 +490,115 @@ void MultiDiskAdaptorTest::testWriteCache()
   CPPUNIT_ASSERT_EQUAL(data2, readFile(entries[0]->getPath()).substr(123));
 }
 
+void MultiDiskAdaptorTest::testPadFile()
+{
+  std::string prefix =
+      A2_TEST_OUT_DIR "/aria2_MultiDiskAdaptorTest_testPadFile_";
+  auto entries = std::vector<std::shared_ptr<FileEntry>>{
+      std::make_shared<FileEntry>(prefix + "1", 3, 0),
+      std::make_shared<FileEntry>(prefix + "pad", 5, 3),
+      std::make_shared<FileEntry>(prefix + "2", 2, 8)};
+  entries[1]->setPadFile(true);
+  for (const auto& i : entries) {
+    File(i->getPath()).remove();
+  }
+  adaptor->setFileEntries(std::begin(entries), std::end(entries));
+  adaptor->openFile();
+  adaptor->writeData(reinterpret_cast<const unsigned char*>("abcxxxxxde"), 10,
+                     0);
+  // The pad file is not created, but counted in the size.
+  CPPUNIT_ASSERT(!File(prefix + "pad").exists());
+  CPPUNIT_ASSERT_EQUAL((int64_t)10, adaptor->size());
+  unsigned char buf[10];
+  CPPUNIT_ASSERT_EQUAL((ssize_t)10, adaptor->readData(buf, sizeof(buf), 0));
+  CPPUNIT_ASSERT_EQUAL(std::string("abc\0\0\0\0\0de", 10),
+                       std::string(buf, buf + 10));
+  CPPUNIT_ASSERT_EQUAL((ssize_t)3, adaptor->readData(buf, 3, 6));
+  CPPUNIT_ASSERT_EQUAL(std::string("\0\0d", 3), std::string(buf, buf + 3));
+  adaptor->closeFile();
+}
+
+void MultiDiskAdaptorTest::testPartsStore()
+{
+  std::string prefix =
+      A2_TEST_OUT_DIR "/aria2_MultiDiskAdaptorTest_testPartsStore_";
+  auto entries = std::vector<std::shared_ptr<FileEntry>>{
+      std::make_shared<FileEntry>(prefix + "1", 6, 0),
+      std::make_shared<FileEntry>(prefix + "2", 4, 6),
+      std::make_shared<FileEntry>(prefix + "3", 4, 10),
+      std::make_shared<FileEntry>(prefix + "4", 2, 14)};
+  entries[1]->setRequested(false);
+  entries[2]->setRequested(false);
+  for (const auto& i : entries) {
+    File(i->getPath()).remove();
+  }
+  File(prefix + "parts").remove();
+  adaptor->setPieceLength(4);
+  adaptor->setPartsStorePath(prefix + "parts");
+  adaptor->setFileEntries(std::begin(entries), std::end(entries));
+  adaptor->openFile();
+  adaptor->writeData(reinterpret_cast<const unsigned char*>("0123456789abcdef"),
+                     16, 0);
+  // Pieces 1 and 3 are shared with the selected files.
+  CPPUNIT_ASSERT(!File(prefix + "2").exists());
+  CPPUNIT_ASSERT(!File(prefix + "3").exists());
+  CPPUNIT_ASSERT(File(prefix + "parts").exists());
+  unsigned char buf[16];
+  CPPUNIT_ASSERT_EQUAL((ssize_t)16, adaptor->readData(buf, sizeof(buf), 0));
+  CPPUNIT_ASSERT_EQUAL(std::string("01234567\0\0\0\0cdef", 16),
+                       std::string(buf, buf + 16));
+  adaptor->closeFile();
+
+  // The data of the file selected now are moved out of the store.
+  entries[2]->setRequested(true);
+  adaptor->openFile();
+  CPPUNIT_ASSERT_EQUAL(std::string("\0\0cd", 4), readFile(prefix + "3"));
+  CPPUNIT_ASSERT_EQUAL((ssize_t)4, adaptor->readData(buf, 4, 6));
+  CPPUNIT_ASSERT_EQUAL(std::string("67\0\0", 4), std::string(buf, buf + 4));
+  adaptor->closeFile();
+}
+
+void MultiDiskAdaptorTest::testPartsStore_move()
+{
+  std::string prefix =
+      A2_TEST_OUT_DIR "/aria2_MultiDiskAdaptorTest_testPartsStore_move_";
+  std::string movedPrefix = prefix + "moved_";
+  auto entries = std::vector<std::shared_ptr<FileEntry>>{
+      std::make_shared<FileEntry>(prefix + "1", 6, 0),
+      std::make_shared<FileEntry>(prefix + "2", 4, 6),
+      std::make_shared<FileEntry>(prefix + "3", 2, 10)};
+  entries[1]->setRequested(false);
+  for (const auto& i : entries) {
+    File(i->getPath()).remove();
+  }
+  File(prefix + "parts").remove();
+  File(movedPrefix + "parts").remove();
+  adaptor->setPieceLength(4);
+  adaptor->setPartsStorePath(prefix + "parts");
+  adaptor->setFileEntries(std::begin(entries), std::end(entries));
+  adaptor->openFile();
+  adaptor->writeData(reinterpret_cast<const unsigned char*>("0123456789ab"),
+                     12, 0);
+  adaptor->closeFile();
+
+  // Move the selected files and the store as --completed-dir does.
+  for (size_t i = 0; i < entries.size(); ++i) {
+    auto path = movedPrefix + util::itos(i + 1);
+    if (entries[i]->isRequested()) {
+      File(path).remove();
+      CPPUNIT_ASSERT(File(entries[i]->getPath()).renameTo(path));
+    }
+    entries[i]->setPath(path);
+  }
+  CPPUNIT_ASSERT(File(prefix + "parts").renameTo(movedPrefix + "parts"));
+  adaptor->setPartsStorePath(movedPrefix + "parts");
+  adaptor->openFile();
+  // Piece 1 is shared by the 1st and the 2nd files.
+  unsigned char buf[4];
+  CPPUNIT_ASSERT_EQUAL((ssize_t)4, adaptor->readData(buf, 4, 4));
+  CPPUNIT_ASSERT_EQUAL(std::string("4567"), std::string(buf, buf + 4));
+  CPPUNIT_ASSERT(!File(prefix + "parts").exists());
+  adaptor->closeFile();
+}
+
 } // namespace aria2
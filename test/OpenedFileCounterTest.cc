@@ -0,0 +1,161 @@
+#include "OpenedFileCounter.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "MultiDiskAdaptor.h"
+#include "DiskWriter.h"
+#include "FileEntry.h"
+#include "TestUtil.h"
+
+namespace aria2 {
+
+class OpenedFileCounterTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(OpenedFileCounterTest);
+  CPPUNIT_TEST(testEvictLeastRecentlyUsed);
+  CPPUNIT_TEST(testSetMaxOpenFiles);
+  CPPUNIT_TEST(testDeactivate);
+  CPPUNIT_TEST(testEntryWithoutDiskWriter);
+  CPPUNIT_TEST(testDirectIO);
+  CPPUNIT_TEST_SUITE_END();
+
+private:
+  std::shared_ptr<OpenedFileCounter> counter_;
+  std::unique_ptr<MultiDiskAdaptor> adaptor_;
+
+public:
+  void setUp()
+  {
+    std::vector<std::shared_ptr<FileEntry>> entries{
+        std::make_shared<FileEntry>(A2_TEST_OUT_DIR "/aria2_OFCT_0", 4, 0),
+        std::make_shared<FileEntry>(A2_TEST_OUT_DIR "/aria2_OFCT_1", 4, 4),
+        std::make_shared<FileEntry>(A2_TEST_OUT_DIR "/aria2_OFCT_2", 4, 8),
+    };
+    for (auto& fe : entries) {
+      File(fe->getPath()).remove();
+    }
+    counter_ = std::make_shared<OpenedFileCounter>(2);
+    adaptor_ = make_unique<MultiDiskAdaptor>();
+    adaptor_->setFileEntries(std::begin(entries), std::end(entries));
+    adaptor_->setOpenedFileCounter(counter_);
+  }
+
+  void tearDown() { adaptor_.reset(); }
+
+  void testEvictLeastRecentlyUsed();
+  void testSetMaxOpenFiles();
+  void testDeactivate();
+  void testEntryWithoutDiskWriter();
+  void testDirectIO();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(OpenedFileCounterTest);
+
+void OpenedFileCounterTest::testEvictLeastRecentlyUsed()
+{
+  // Opening 3 files with the limit of 2 closes the first one.
+  adaptor_->openFile();
+  auto& entries = adaptor_->getDiskWriterEntries();
+  CPPUNIT_ASSERT(!entries[0]->isOpen());
+  CPPUNIT_ASSERT(entries[1]->isOpen());
+  CPPUNIT_ASSERT(entries[2]->isOpen());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, counter_->getNumOpenFiles());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)3, counter_->getMisses());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)1, counter_->getEvictions());
+
+  // Use file 1 so that file 2 becomes the least recently used one.
+  unsigned char buf[4];
+  adaptor_->writeData(reinterpret_cast<const unsigned char*>("1111"), 4, 4);
+  CPPUNIT_ASSERT_EQUAL((uint64_t)1, counter_->getHits());
+
+  adaptor_->writeData(reinterpret_cast<const unsigned char*>("0000"), 4, 0);
+  CPPUNIT_ASSERT(entries[0]->isOpen());
+  CPPUNIT_ASSERT(entries[1]->isOpen());
+  CPPUNIT_ASSERT(!entries[2]->isOpen());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)4, counter_->getMisses());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)2, counter_->getEvictions());
+
+  // Reading across files 1 and 2 closes file 0.  File 2 is still
+  // empty.
+  CPPUNIT_ASSERT_EQUAL((ssize_t)2, adaptor_->readData(buf, 4, 6));
+  CPPUNIT_ASSERT(!entries[0]->isOpen());
+  CPPUNIT_ASSERT(entries[1]->isOpen());
+  CPPUNIT_ASSERT(entries[2]->isOpen());
+  CPPUNIT_ASSERT_EQUAL(std::string("11"), std::string(&buf[0], &buf[2]));
+
+  adaptor_->closeFile();
+  CPPUNIT_ASSERT_EQUAL((size_t)0, counter_->getNumOpenFiles());
+  CPPUNIT_ASSERT(!entries[1]->isOpen());
+  CPPUNIT_ASSERT(!entries[2]->isOpen());
+}
+
+void OpenedFileCounterTest::testSetMaxOpenFiles()
+{
+  adaptor_->openFile();
+  auto& entries = adaptor_->getDiskWriterEntries();
+  counter_->setMaxOpenFiles(1);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, counter_->getNumOpenFiles());
+  CPPUNIT_ASSERT(!entries[1]->isOpen());
+  CPPUNIT_ASSERT(entries[2]->isOpen());
+  adaptor_->closeFile();
+}
+
+void OpenedFileCounterTest::testDeactivate()
+{
+  adaptor_->openFile();
+  counter_->deactivate();
+  CPPUNIT_ASSERT_EQUAL((size_t)0, counter_->getNumOpenFiles());
+  // Files are still closed by their owner.
+  adaptor_->closeFile();
+  auto& entries = adaptor_->getDiskWriterEntries();
+  CPPUNIT_ASSERT(!entries[1]->isOpen());
+  CPPUNIT_ASSERT(!entries[2]->isOpen());
+}
+
+void OpenedFileCounterTest::testEntryWithoutDiskWriter()
+{
+  std::vector<std::shared_ptr<FileEntry>> entries{
+      std::make_shared<FileEntry>(A2_TEST_OUT_DIR "/aria2_OFCT_0", 4, 0),
+      std::make_shared<FileEntry>(A2_TEST_OUT_DIR "/aria2_OFCT_1", 4, 4),
+      std::make_shared<FileEntry>(A2_TEST_OUT_DIR "/aria2_OFCT_2", 4, 8),
+      std::make_shared<FileEntry>(A2_TEST_OUT_DIR "/aria2_OFCT_3", 4, 12),
+  };
+  for (auto& fe : entries) {
+    File(fe->getPath()).remove();
+  }
+  // Unselected files which don't exist get no DiskWriter.
+  entries[1]->setRequested(false);
+  entries[3]->setRequested(false);
+  adaptor_->closeFile();
+  adaptor_->setFileEntries(std::begin(entries), std::end(entries));
+  adaptor_->openFile();
+  auto& dwents = adaptor_->getDiskWriterEntries();
+  CPPUNIT_ASSERT(!dwents[1]->getDiskWriter());
+  CPPUNIT_ASSERT(!dwents[3]->getDiskWriter());
+  // They don't take a slot, so the 2 selected files stay open.
+  CPPUNIT_ASSERT(dwents[0]->isOpen());
+  CPPUNIT_ASSERT(dwents[2]->isOpen());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, counter_->getNumOpenFiles());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)0, counter_->getEvictions());
+  adaptor_->closeFile();
+}
+
+void OpenedFileCounterTest::testDirectIO()
+{
+  // A file opened for direct I/O may use 2 file descriptors, so only
+  // one file fits in the limit of 2.
+  adaptor_->enableDirectIO();
+  adaptor_->openFile();
+  auto& entries = adaptor_->getDiskWriterEntries();
+  CPPUNIT_ASSERT(!entries[0]->isOpen());
+  CPPUNIT_ASSERT(!entries[1]->isOpen());
+  CPPUNIT_ASSERT(entries[2]->isOpen());
+  CPPUNIT_ASSERT_EQUAL((size_t)1, counter_->getNumOpenFiles());
+  CPPUNIT_ASSERT_EQUAL(entries[2]->getDiskWriter()->getNumOpenFds(),
+                       counter_->getNumOpenFds());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)2, counter_->getEvictions());
+  adaptor_->closeFile();
+  CPPUNIT_ASSERT_EQUAL((size_t)0, counter_->getNumOpenFds());
+}
+
+} // namespace aria2
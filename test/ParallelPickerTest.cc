@@ -0,0 +1,71 @@
+#include "ParallelPicker.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "a2functional.h"
+
+namespace aria2 {
+
+class ParallelPickerTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(ParallelPickerTest);
+  CPPUNIT_TEST(testPick);
+  CPPUNIT_TEST(testSetMaxPicked);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testPick();
+  void testSetMaxPicked();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(ParallelPickerTest);
+
+void ParallelPickerTest::testPick()
+{
+  ParallelPicker<int> picker(2);
+
+  CPPUNIT_ASSERT(!picker.isPicked());
+  CPPUNIT_ASSERT(!picker.hasNext());
+  CPPUNIT_ASSERT(picker.canPick());
+
+  picker.pushEntry(make_unique<int>(1));
+  picker.pushEntry(make_unique<int>(2));
+  picker.pushEntry(make_unique<int>(3));
+  CPPUNIT_ASSERT_EQUAL((size_t)3, picker.countEntryInQueue());
+
+  int* one = picker.pickNext();
+  CPPUNIT_ASSERT_EQUAL(1, *one);
+  CPPUNIT_ASSERT(picker.canPick());
+  CPPUNIT_ASSERT_EQUAL(2, *picker.pickNext());
+  CPPUNIT_ASSERT(!picker.canPick());
+  CPPUNIT_ASSERT(!picker.pickNext());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, picker.getPickedEntries().size());
+  CPPUNIT_ASSERT_EQUAL((size_t)1, picker.countEntryInQueue());
+
+  picker.dropPickedEntry(one);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, picker.getPickedEntries().size());
+  CPPUNIT_ASSERT_EQUAL(2, *picker.getPickedEntries()[0]);
+  CPPUNIT_ASSERT(picker.canPick());
+  CPPUNIT_ASSERT_EQUAL(3, *picker.pickNext());
+  CPPUNIT_ASSERT(!picker.hasNext());
+}
+
+void ParallelPickerTest::testSetMaxPicked()
+{
+  ParallelPicker<int> picker(2);
+  picker.pushEntry(make_unique<int>(1));
+  picker.pushEntry(make_unique<int>(2));
+  picker.pushEntry(make_unique<int>(3));
+  int* one = picker.pickNext();
+  picker.pickNext();
+
+  picker.setMaxPicked(1);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, picker.getPickedEntries().size());
+  picker.dropPickedEntry(one);
+  CPPUNIT_ASSERT(!picker.canPick());
+
+  picker.setMaxPicked(0);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, picker.getMaxPicked());
+}
+
+} // namespace aria2
@@ -0,0 +1,104 @@
+#include "PartsStore.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "TestUtil.h"
+#include "File.h"
+#include "a2functional.h"
+
+namespace aria2 {
+
+class PartsStoreTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(PartsStoreTest);
+  CPPUNIT_TEST(testWriteData);
+  CPPUNIT_TEST(testReset);
+  CPPUNIT_TEST(testLoad_broken);
+  CPPUNIT_TEST_SUITE_END();
+
+  std::string filename_;
+
+public:
+  void setUp()
+  {
+    filename_ = A2_TEST_OUT_DIR "/aria2_PartsStoreTest.parts";
+    File(filename_).remove();
+  }
+
+  std::string read(PartsStore& ps, size_t len, int64_t offset)
+  {
+    std::string s(len, 'X');
+    ps.readData(reinterpret_cast<unsigned char*>(&s[0]), len, offset);
+    return s;
+  }
+
+  void write(PartsStore& ps, const std::string& s, int64_t offset)
+  {
+    ps.writeData(reinterpret_cast<const unsigned char*>(s.data()), s.size(),
+                 offset);
+  }
+
+  void testWriteData();
+  void testReset();
+  void testLoad_broken();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(PartsStoreTest);
+
+void PartsStoreTest::testWriteData()
+{
+  PartsStore ps(filename_, 4);
+  CPPUNIT_ASSERT(!ps.load());
+  ps.reset({1, 3}, {2});
+  CPPUNIT_ASSERT(File(filename_).exists());
+  // Only pieces 1 and 3 are stored.
+  write(ps, "0123456789abcdef", 0);
+  CPPUNIT_ASSERT_EQUAL(std::string("\0\0\0\0" "4567" "\0\0\0\0" "cdef", 16),
+                       read(ps, 16, 0));
+  CPPUNIT_ASSERT_EQUAL(std::string("67\0", 3), read(ps, 3, 6));
+  CPPUNIT_ASSERT_EQUAL(std::string("\0\0", 2), read(ps, 2, 1_k));
+  ps.closeFile();
+
+  PartsStore ps2(filename_, 4);
+  CPPUNIT_ASSERT(ps2.load());
+  CPPUNIT_ASSERT(ps2.hasPiece(3));
+  CPPUNIT_ASSERT(!ps2.hasPiece(2));
+  CPPUNIT_ASSERT_EQUAL((size_t)1, ps2.getFiles().size());
+  CPPUNIT_ASSERT_EQUAL((size_t)2, ps2.getFiles()[0]);
+  CPPUNIT_ASSERT_EQUAL(std::string("cdef"), read(ps2, 4, 12));
+}
+
+void PartsStoreTest::testReset()
+{
+  PartsStore ps(filename_, 4);
+  ps.reset({1, 3}, {2});
+  write(ps, "4567", 4);
+  write(ps, "cdef", 12);
+  // Piece 3 is kept and piece 1 is dropped.
+  ps.reset({0, 3, 5}, {2, 3});
+  CPPUNIT_ASSERT_EQUAL(std::string("\0\0\0\0", 4), read(ps, 4, 4));
+  CPPUNIT_ASSERT_EQUAL(std::string("cdef"), read(ps, 4, 12));
+  // Not written yet
+  CPPUNIT_ASSERT_EQUAL(std::string("\0\0\0\0", 4), read(ps, 4, 20));
+  CPPUNIT_ASSERT(!File(filename_ + ".tmp").exists());
+
+  PartsStore ps2(filename_, 4);
+  CPPUNIT_ASSERT(ps2.load());
+  CPPUNIT_ASSERT_EQUAL((size_t)3, ps2.getPieces().size());
+  CPPUNIT_ASSERT_EQUAL(std::string("cdef"), read(ps2, 4, 12));
+  // No pieces are needed any more.
+  ps2.reset({}, {});
+  CPPUNIT_ASSERT(!File(filename_).exists());
+}
+
+void PartsStoreTest::testLoad_broken()
+{
+  createFile(filename_, 3);
+  PartsStore ps(filename_, 4);
+  CPPUNIT_ASSERT(!ps.load());
+  ps.reset({1}, {0});
+  write(ps, "4567", 4);
+  CPPUNIT_ASSERT_EQUAL(std::string("4567"), read(ps, 4, 4));
+}
+
+} // namespace aria2
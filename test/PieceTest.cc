@@ -21,6 +21,7 @@ class PieceTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST(testGetDigestWithWrCache);
   CPPUNIT_TEST(testUpdateHash);
+  CPPUNIT_TEST(testBlockRequester);
 
   CPPUNIT_TEST_SUITE_END();
 
@@ -44,6 +45,7 @@ public:
 
   void testGetDigestWithWrCache();
   void testUpdateHash();
+  void testBlockRequester();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(PieceTest);
@@ -159,4 +161,23 @@ void PieceTest::testUpdateHash()
                        util::toHex(p.getDigest()));
 }
 
+void PieceTest::testBlockRequester()
+{
+  Piece p(0, 64_k);
+  CPPUNIT_ASSERT_EQUAL((size_t)0, p.countBlockRequester(1));
+  p.addBlockRequester(1, 100);
+  p.addBlockRequester(1, 200);
+  // Adding same requester again is no-op.
+  p.addBlockRequester(1, 100);
+  p.addBlockRequester(2, 100);
+  CPPUNIT_ASSERT_EQUAL((size_t)2, p.countBlockRequester(1));
+  CPPUNIT_ASSERT_EQUAL((size_t)1, p.countBlockRequester(2));
+
+  p.removeBlockRequester(1, 100);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, p.countBlockRequester(1));
+  CPPUNIT_ASSERT_EQUAL((size_t)1, p.countBlockRequester(2));
+  p.removeBlockRequester(1, 200);
+  CPPUNIT_ASSERT_EQUAL((size_t)0, p.countBlockRequester(1));
+}
+
 } // namespace aria2
@@ -0,0 +1,118 @@
+#include "RdDiskCache.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+#include "TestUtil.h"
+#include "DirectDiskAdaptor.h"
+#include "ByteArrayDiskWriter.h"
+
+namespace aria2 {
+
+class RdDiskCacheTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(RdDiskCacheTest);
+  CPPUNIT_TEST(testReadData);
+  CPPUNIT_TEST(testReadData_evict);
+  CPPUNIT_TEST(testReadData_beforeCachedPart);
+  CPPUNIT_TEST(testReadData_tooLarge);
+  CPPUNIT_TEST(testRemove);
+  CPPUNIT_TEST_SUITE_END();
+
+  std::shared_ptr<DirectDiskAdaptor> adaptor_;
+  unsigned char buf_[16];
+
+public:
+  void setUp()
+  {
+    adaptor_ = std::make_shared<DirectDiskAdaptor>();
+    auto dw = make_unique<ByteArrayDiskWriter>();
+    // 3 pieces of length 8, 8 and 4.
+    dw->setString("0123456789abcdefghij");
+    adaptor_->setDiskWriter(std::move(dw));
+  }
+
+  // Reads 2 bytes at |begin| of the piece |index| of the download 1.
+  std::string read(RdDiskCache& dc, size_t index, int32_t begin)
+  {
+    int32_t pieceLength = index == 2 ? 4 : 8;
+    auto r = dc.readData(buf_, 2, 1, index, begin, index * 8, pieceLength,
+                         adaptor_.get());
+    CPPUNIT_ASSERT_EQUAL((ssize_t)2, r);
+    return std::string(&buf_[0], &buf_[2]);
+  }
+
+  void testReadData();
+  void testReadData_evict();
+  void testReadData_beforeCachedPart();
+  void testReadData_tooLarge();
+  void testRemove();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(RdDiskCacheTest);
+
+void RdDiskCacheTest::testReadData()
+{
+  RdDiskCache dc(16);
+  CPPUNIT_ASSERT_EQUAL(std::string("01"), read(dc, 0, 0));
+  CPPUNIT_ASSERT_EQUAL((uint64_t)1, dc.getMisses());
+  // The whole piece was read ahead.
+  CPPUNIT_ASSERT_EQUAL((size_t)8, dc.getSize());
+  CPPUNIT_ASSERT_EQUAL(std::string("23"), read(dc, 0, 2));
+  CPPUNIT_ASSERT_EQUAL(std::string("67"), read(dc, 0, 6));
+  CPPUNIT_ASSERT_EQUAL((uint64_t)2, dc.getHits());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)1, dc.getMisses());
+}
+
+void RdDiskCacheTest::testReadData_evict()
+{
+  RdDiskCache dc(16);
+  read(dc, 0, 0);
+  // Piece 0 is now protected.
+  read(dc, 0, 2);
+  read(dc, 1, 0);
+  CPPUNIT_ASSERT_EQUAL((size_t)16, dc.getSize());
+  // Piece 1, which was read only once, is evicted, not piece 0.
+  CPPUNIT_ASSERT_EQUAL(std::string("gh"), read(dc, 2, 0));
+  CPPUNIT_ASSERT_EQUAL((size_t)12, dc.getSize());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)3, dc.getMisses());
+  CPPUNIT_ASSERT_EQUAL(std::string("45"), read(dc, 0, 4));
+  CPPUNIT_ASSERT_EQUAL((uint64_t)3, dc.getMisses());
+  CPPUNIT_ASSERT_EQUAL(std::string("ab"), read(dc, 1, 2));
+  CPPUNIT_ASSERT_EQUAL((uint64_t)4, dc.getMisses());
+}
+
+void RdDiskCacheTest::testReadData_beforeCachedPart()
+{
+  RdDiskCache dc(16);
+  CPPUNIT_ASSERT_EQUAL(std::string("45"), read(dc, 0, 4));
+  CPPUNIT_ASSERT_EQUAL((size_t)4, dc.getSize());
+  CPPUNIT_ASSERT_EQUAL(std::string("01"), read(dc, 0, 0));
+  CPPUNIT_ASSERT_EQUAL((uint64_t)2, dc.getMisses());
+  CPPUNIT_ASSERT_EQUAL((size_t)8, dc.getSize());
+}
+
+void RdDiskCacheTest::testReadData_tooLarge()
+{
+  RdDiskCache dc(4);
+  CPPUNIT_ASSERT_EQUAL(std::string("89"), read(dc, 1, 0));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, dc.getSize());
+  CPPUNIT_ASSERT_EQUAL(std::string("ef"), read(dc, 1, 6));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, dc.getSize());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)2, dc.getMisses());
+}
+
+void RdDiskCacheTest::testRemove()
+{
+  RdDiskCache dc(32);
+  read(dc, 0, 0);
+  read(dc, 1, 0);
+  CPPUNIT_ASSERT_EQUAL((size_t)16, dc.getSize());
+  dc.remove(2);
+  CPPUNIT_ASSERT_EQUAL((size_t)16, dc.getSize());
+  dc.remove(1);
+  CPPUNIT_ASSERT_EQUAL((size_t)0, dc.getSize());
+  read(dc, 0, 0);
+  CPPUNIT_ASSERT_EQUAL((uint64_t)3, dc.getMisses());
+}
+
+} // namespace aria2
@@ -7,6 +7,9 @@
 #include "FileEntry.h"
 #include "PieceStorage.h"
 #include "DownloadResult.h"
+#include "File.h"
+#include "TestUtil.h"
+#include "FileCopier.h"
 
 namespace aria2 {
 
@@ -16,6 +19,8 @@ class RequestGroupTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testGetFirstFilePath);
   CPPUNIT_TEST(testTryAutoFileRenaming);
   CPPUNIT_TEST(testCreateDownloadResult);
+  CPPUNIT_TEST(testMoveCompletedFiles);
+  CPPUNIT_TEST(testFinishMovingCompletedFiles);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -27,6 +32,8 @@ public:
   void testGetFirstFilePath();
   void testTryAutoFileRenaming();
   void testCreateDownloadResult();
+  void testMoveCompletedFiles();
+  void testFinishMovingCompletedFiles();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(RequestGroupTest);
@@ -147,4 +154,93 @@ void RequestGroupTest::testCreateDownloadResult()
   }
 }
 
+void RequestGroupTest::testMoveCompletedFiles()
+{
+  std::string dir = A2_TEST_OUT_DIR "/aria2_RequestGroupTest_staging";
+  std::string dest = A2_TEST_OUT_DIR "/aria2_RequestGroupTest_completed";
+  std::string path = dir + "/sub/myfile";
+  std::string newPath = dest + "/sub/myfile";
+  createFile(path, 1_k);
+  File(newPath).remove();
+  option_->put(PREF_DIR, dir);
+  option_->put(PREF_COMPLETED_DIR, dest);
+  auto ctx = std::make_shared<DownloadContext>(1_k, 1_k, path);
+  RequestGroup group(GroupId::create(), option_);
+  group.setDownloadContext(ctx);
+  group.initPieceStorage();
+
+  // Renamed on the same file system, without a command.
+  CPPUNIT_ASSERT(!group.moveCompletedFiles(nullptr));
+  CPPUNIT_ASSERT_EQUAL(newPath, group.getFirstFilePath());
+  CPPUNIT_ASSERT(File(newPath).isFile());
+  CPPUNIT_ASSERT(!File(path).exists());
+  CPPUNIT_ASSERT_EQUAL(dest, option_->get(PREF_DIR));
+  CPPUNIT_ASSERT_EQUAL(newPath, ctx->getBasePath());
+  // Nothing to do for the files already moved.
+  CPPUNIT_ASSERT(!group.moveCompletedFiles(nullptr));
+  CPPUNIT_ASSERT_EQUAL(newPath, group.getFirstFilePath());
+
+  // The file in the destination is not overwritten.
+  createFile(path, 1_k);
+  auto option = std::make_shared<Option>();
+  option->put(PREF_DIR, dir);
+  option->put(PREF_COMPLETED_DIR, dest);
+  auto ctx2 = std::make_shared<DownloadContext>(1_k, 1_k, path);
+  RequestGroup group2(GroupId::create(), option);
+  group2.setDownloadContext(ctx2);
+  group2.initPieceStorage();
+  CPPUNIT_ASSERT(!group2.moveCompletedFiles(nullptr));
+  CPPUNIT_ASSERT_EQUAL(path, group2.getFirstFilePath());
+  CPPUNIT_ASSERT(File(path).isFile());
+  CPPUNIT_ASSERT_EQUAL(dir, option->get(PREF_DIR));
+}
+
+void RequestGroupTest::testFinishMovingCompletedFiles()
+{
+  std::string dir = A2_TEST_OUT_DIR "/aria2_RequestGroupTest_finish_staging";
+  std::string dest = A2_TEST_OUT_DIR "/aria2_RequestGroupTest_finish_completed";
+  std::string path1 = dir + "/myfile1";
+  std::string path2 = dir + "/myfile2";
+  createFile(path1, 1_k);
+  createFile(path2, 1_k);
+  File(dest).mkdirs();
+  option_->put(PREF_DIR, dir);
+  option_->put(PREF_COMPLETED_DIR, dest);
+  auto ctx = std::make_shared<DownloadContext>();
+  auto entries = std::vector<std::shared_ptr<FileEntry>>{
+      std::make_shared<FileEntry>(path1, 1_k, 0),
+      std::make_shared<FileEntry>(path2, 1_k, 1_k)};
+  ctx->setFileEntries(std::begin(entries), std::end(entries));
+  ctx->setPieceLength(1_k);
+  ctx->setBasePath(dir + "/base");
+  RequestGroup group(GroupId::create(), option_);
+  group.setDownloadContext(ctx);
+  group.initPieceStorage();
+
+  // The copy of myfile2 was not finished.
+  std::vector<std::unique_ptr<FileCopier>> copiers;
+  copiers.push_back(make_unique<FileCopier>(path1, dest + "/myfile1"));
+  copiers.push_back(make_unique<FileCopier>(path2, dest + "/myfile2"));
+  while (!copiers[0]->finished()) {
+    copiers[0]->copyChunk();
+  }
+  group.finishMovingCompletedFiles(copiers, false);
+  copiers.clear();
+  CPPUNIT_ASSERT(!File(path1).exists());
+  CPPUNIT_ASSERT_EQUAL(dest + "/myfile1", entries[0]->getPath());
+  CPPUNIT_ASSERT(File(path2).isFile());
+  CPPUNIT_ASSERT_EQUAL(path2, entries[1]->getPath());
+  // Not all files are in the new directory.
+  CPPUNIT_ASSERT_EQUAL(dir, option_->get(PREF_DIR));
+
+  copiers.push_back(make_unique<FileCopier>(path2, dest + "/myfile2"));
+  while (!copiers[0]->finished()) {
+    copiers[0]->copyChunk();
+  }
+  group.finishMovingCompletedFiles(copiers, false);
+  CPPUNIT_ASSERT_EQUAL(dest + "/myfile2", entries[1]->getPath());
+  CPPUNIT_ASSERT_EQUAL(dest, option_->get(PREF_DIR));
+  CPPUNIT_ASSERT_EQUAL(dest + "/base", ctx->getBasePath());
+}
+
 } // namespace aria2
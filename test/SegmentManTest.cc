@@ -10,6 +10,8 @@
 #include "PieceSelector.h"
 #include "FileEntry.h"
 #include "PeerStat.h"
+#include "Request.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
@@ -23,6 +25,12 @@ class SegmentManTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testCancelAllSegments);
   CPPUNIT_TEST(testGetPeerStat);
   CPPUNIT_TEST(testGetCleanSegmentIfOwnerIsIdle);
+  CPPUNIT_TEST(testGetCleanSegmentIfOwnerIsIdle_requestPeerStat);
+  CPPUNIT_TEST(testStealSegment);
+  CPPUNIT_TEST(testStealSegment_requestPeerStat);
+  CPPUNIT_TEST(testGetSegment_yieldToFasterConnections);
+  CPPUNIT_TEST(testGetSegment_yieldToFasterConnections_rtt);
+  CPPUNIT_TEST(testGetSegment_yieldToFasterConnections_noStat);
   CPPUNIT_TEST_SUITE_END();
 
 private:
@@ -49,6 +57,12 @@ public:
   void testCancelAllSegments();
   void testGetPeerStat();
   void testGetCleanSegmentIfOwnerIsIdle();
+  void testGetCleanSegmentIfOwnerIsIdle_requestPeerStat();
+  void testStealSegment();
+  void testStealSegment_requestPeerStat();
+  void testGetSegment_yieldToFasterConnections();
+  void testGetSegment_yieldToFasterConnections_rtt();
+  void testGetSegment_yieldToFasterConnections_noStat();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(SegmentManTest);
@@ -175,6 +189,10 @@ void SegmentManTest::testGetPeerStat()
   std::shared_ptr<PeerStat> peerStat1(new PeerStat(1));
   segmentMan_->registerPeerStat(peerStat1);
   CPPUNIT_ASSERT_EQUAL((cuid_t)1, segmentMan_->getPeerStat(1)->getCuid());
+  // The latest one wins
+  std::shared_ptr<PeerStat> peerStat2(new PeerStat(1));
+  segmentMan_->registerPeerStat(peerStat2);
+  CPPUNIT_ASSERT(peerStat2 == segmentMan_->getPeerStat(1));
 }
 
 void SegmentManTest::testGetCleanSegmentIfOwnerIsIdle()
@@ -195,4 +213,159 @@ void SegmentManTest::testGetCleanSegmentIfOwnerIsIdle()
   CPPUNIT_ASSERT(!segmentMan_->getCleanSegmentIfOwnerIsIdle(5, 1));
 }
 
+void SegmentManTest::testGetCleanSegmentIfOwnerIsIdle_requestPeerStat()
+{
+  // The owner's PeerStat comes from Request::initPeerStat(), and it
+  // has the owner's CUID.  While the owner is downloading, its clean
+  // segment is not handed to another command.
+  Request req;
+  req.setUri("http://localhost/aria2.tar.bz2");
+  auto owner = req.initPeerStat(1);
+  owner->downloadStart();
+  segmentMan_->registerPeerStat(owner);
+  CPPUNIT_ASSERT(segmentMan_->getSegmentWithIndex(1, 0));
+  CPPUNIT_ASSERT(!segmentMan_->getCleanSegmentIfOwnerIsIdle(2, 0));
+  owner->downloadStop();
+  auto seg = segmentMan_->getCleanSegmentIfOwnerIsIdle(2, 0);
+  CPPUNIT_ASSERT(seg);
+  CPPUNIT_ASSERT_EQUAL((size_t)0, seg->getIndex());
+  std::vector<std::shared_ptr<Segment>> segments;
+  segmentMan_->getInFlightSegment(segments, 1);
+  CPPUNIT_ASSERT(segments.empty());
+}
+
+void SegmentManTest::testStealSegment()
+{
+  auto seg1 = segmentMan_->getSegmentWithIndex(1, 0);
+  auto seg2 = segmentMan_->getSegmentWithIndex(2, 1);
+  auto seg3 = segmentMan_->getSegmentWithIndex(3, 2);
+  // Almost finished; not worth stealing.
+  seg3->updateWrittenLength(1_m - 16_k);
+  std::shared_ptr<PeerStat> peerStats[4];
+  for (int i = 0; i < 4; ++i) {
+    peerStats[i] = std::make_shared<PeerStat>(i + 1);
+    peerStats[i]->downloadStart();
+    segmentMan_->registerPeerStat(peerStats[i]);
+  }
+  peerStats[0]->updateDownload(100_k);
+  peerStats[1]->updateDownload(300_k);
+  peerStats[3]->updateDownload(150_k);
+  auto origin = global::wallclock();
+  global::wallclock().advance(10_s);
+  // No stat is registered for CUID#5
+  CPPUNIT_ASSERT(!segmentMan_->stealSegment(5));
+  // CUID#4 is not fast enough to steal from CUID#1
+  CPPUNIT_ASSERT(!segmentMan_->stealSegment(4));
+  peerStats[3]->updateDownload(1_m);
+  auto seg = segmentMan_->stealSegment(4);
+  CPPUNIT_ASSERT(seg);
+  CPPUNIT_ASSERT_EQUAL((size_t)0, seg->getIndex());
+  CPPUNIT_ASSERT(!segmentMan_->getSegmentWithIndex(1, 0));
+  std::vector<std::shared_ptr<Segment>> segments;
+  segmentMan_->getInFlightSegment(segments, 1);
+  CPPUNIT_ASSERT(segments.empty());
+  segmentMan_->getInFlightSegment(segments, 4);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, segments.size());
+  global::wallclock() = origin;
+}
+
+void SegmentManTest::testStealSegment_requestPeerStat()
+{
+  // PeerStat is created by Request::initPeerStat() and registered by
+  // DownloadCommand.  stealSegment() must find them by CUID.
+  Request slowReq, fastReq;
+  slowReq.setUri("http://slow.example.org/aria2.tar.bz2");
+  fastReq.setUri("http://fast.example.org/aria2.tar.bz2");
+  auto slow = slowReq.initPeerStat(1);
+  auto fast = fastReq.initPeerStat(2);
+  CPPUNIT_ASSERT_EQUAL((cuid_t)1, slow->getCuid());
+  CPPUNIT_ASSERT_EQUAL((cuid_t)2, fast->getCuid());
+  slow->downloadStart();
+  fast->downloadStart();
+  segmentMan_->registerPeerStat(slow);
+  segmentMan_->registerPeerStat(fast);
+  CPPUNIT_ASSERT(segmentMan_->getSegmentWithIndex(1, 5));
+  slow->updateDownload(10_k);
+  fast->updateDownload(1_m);
+  auto origin = global::wallclock();
+  global::wallclock().advance(10_s);
+  auto seg = segmentMan_->stealSegment(2);
+  CPPUNIT_ASSERT(seg);
+  CPPUNIT_ASSERT_EQUAL((size_t)5, seg->getIndex());
+  std::vector<std::shared_ptr<Segment>> segments;
+  segmentMan_->getInFlightSegment(segments, 1);
+  CPPUNIT_ASSERT(segments.empty());
+  global::wallclock() = origin;
+}
+
+void SegmentManTest::testGetSegment_yieldToFasterConnections()
+{
+  auto fast = std::make_shared<PeerStat>(1);
+  auto slow = std::make_shared<PeerStat>(2);
+  fast->downloadStart();
+  slow->downloadStart();
+  segmentMan_->registerPeerStat(fast);
+  segmentMan_->registerPeerStat(slow);
+  fast->updateDownload(1000_k);
+  slow->updateDownload(100_k);
+  auto origin = global::wallclock();
+  global::wallclock().advance(10_s);
+  // Plenty of segments left
+  CPPUNIT_ASSERT(segmentMan_->getSegment(2, 1_m));
+  segmentMan_->cancelSegment(2);
+  // 2MiB left.  The slow connection needs 100 seconds for 1 segment,
+  // while all connections finish in about 19 seconds.
+  pieceStorage_->markPiecesDone(62_m);
+  CPPUNIT_ASSERT(!segmentMan_->getSegment(2, 1_m));
+  CPPUNIT_ASSERT(segmentMan_->getSegment(1, 1_m));
+  // No other active connection
+  fast->downloadStop();
+  CPPUNIT_ASSERT(segmentMan_->getSegment(2, 1_m));
+  global::wallclock() = origin;
+}
+
+void SegmentManTest::testGetSegment_yieldToFasterConnections_rtt()
+{
+  auto a = std::make_shared<PeerStat>(1);
+  auto b = std::make_shared<PeerStat>(2);
+  a->downloadStart();
+  b->downloadStart();
+  segmentMan_->registerPeerStat(a);
+  segmentMan_->registerPeerStat(b);
+  a->updateDownload(10_m);
+  b->updateDownload(10_m);
+  auto origin = global::wallclock();
+  global::wallclock().advance(10_s);
+  // 3MiB left.  Both connections download 1MiB/s, so one segment
+  // takes 1 second, while all connections finish in 1.5 seconds.
+  pieceStorage_->markPiecesDone(61_m);
+  b->setRTT(std::chrono::milliseconds(400));
+  CPPUNIT_ASSERT(segmentMan_->getSegment(2, 1_m));
+  segmentMan_->cancelSegment(2);
+  // With 600ms RTT, the connection needs 1.6 seconds for a segment.
+  b->setRTT(std::chrono::milliseconds(600));
+  CPPUNIT_ASSERT(!segmentMan_->getSegment(2, 1_m));
+  CPPUNIT_ASSERT(segmentMan_->getSegment(1, 1_m));
+  global::wallclock() = origin;
+}
+
+void SegmentManTest::testGetSegment_yieldToFasterConnections_noStat()
+{
+  auto fast = std::make_shared<PeerStat>(1);
+  fast->downloadStart();
+  segmentMan_->registerPeerStat(fast);
+  fast->updateDownload(10_m);
+  auto slow = std::make_shared<PeerStat>(2);
+  segmentMan_->registerPeerStat(slow);
+  auto origin = global::wallclock();
+  global::wallclock().advance(10_s);
+  pieceStorage_->markPiecesDone(63_m);
+  // No stat for CUID#3, and no speed known for CUID#2.  They are
+  // not refused.
+  CPPUNIT_ASSERT(segmentMan_->getSegment(3, 1_m));
+  segmentMan_->cancelSegment(3);
+  CPPUNIT_ASSERT(segmentMan_->getSegment(2, 1_m));
+  global::wallclock() = origin;
+}
+
 } // namespace aria2
@@ -18,6 +18,7 @@ class ServerStatManTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testAddAndFind);
   CPPUNIT_TEST(testSave);
   CPPUNIT_TEST(testLoad);
+  CPPUNIT_TEST(testLoad_pipelining);
   CPPUNIT_TEST(testRemoveStaleServerStat);
   CPPUNIT_TEST_SUITE_END();
 
@@ -29,6 +30,7 @@ public:
   void testAddAndFind();
   void testSave();
   void testLoad();
+  void testLoad_pipelining();
   void testRemoveStaleServerStat();
 };
 
@@ -143,6 +145,39 @@ void ServerStatManTest::testLoad()
   CPPUNIT_ASSERT_EQUAL(ServerStat::A2_ERROR, mirror->getStatus());
 }
 
+void ServerStatManTest::testLoad_pipelining()
+{
+  const char* filename =
+      A2_TEST_OUT_DIR "/aria2_ServerStatManTest_testLoad_pipelining";
+  std::string in =
+      "host=localhost, protocol=http, dl_speed=25000, last_updated=1210000000, "
+      "status=OK, pipelining=OK, pipelining_depth=6\n"
+      "host=mirror, protocol=http, dl_speed=0, last_updated=1210000002, "
+      "status=OK, pipelining=BROKEN, pipelining_depth=1\n"
+      "host=old, protocol=http, dl_speed=0, last_updated=1210000002, "
+      "status=OK\n";
+  BufferedFile fp(filename, BufferedFile::WRITE);
+  CPPUNIT_ASSERT_EQUAL((size_t)in.size(), fp.write(in.data(), in.size()));
+  CPPUNIT_ASSERT(fp.close() != EOF);
+
+  ServerStatMan ssm;
+  CPPUNIT_ASSERT(ssm.load(filename));
+
+  auto localhost = ssm.find("localhost", "http");
+  CPPUNIT_ASSERT(localhost);
+  CPPUNIT_ASSERT_EQUAL(ServerStat::PIPELINING_OK, localhost->getPipelining());
+  CPPUNIT_ASSERT_EQUAL(6, localhost->getPipeliningDepth());
+
+  auto mirror = ssm.find("mirror", "http");
+  CPPUNIT_ASSERT(mirror);
+  CPPUNIT_ASSERT(mirror->isPipeliningBroken());
+
+  auto old = ssm.find("old", "http");
+  CPPUNIT_ASSERT(old);
+  CPPUNIT_ASSERT_EQUAL(ServerStat::PIPELINING_UNKNOWN, old->getPipelining());
+  CPPUNIT_ASSERT_EQUAL(0, old->getPipeliningDepth());
+}
+
 void ServerStatManTest::testRemoveStaleServerStat()
 {
   Time now;
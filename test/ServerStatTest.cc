@@ -15,6 +15,7 @@ class ServerStatTest : public CppUnit::TestFixture {
   CPPUNIT_TEST_SUITE(ServerStatTest);
   CPPUNIT_TEST(testSetStatus);
   CPPUNIT_TEST(testToString);
+  CPPUNIT_TEST(testPipelining);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -24,6 +25,7 @@ public:
 
   void testSetStatus();
   void testToString();
+  void testPipelining();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(ServerStatTest);
@@ -71,4 +73,37 @@ void ServerStatTest::testToString()
       localhost_ftp.toString());
 }
 
+void ServerStatTest::testPipelining()
+{
+  ServerStat ss("localhost", "http");
+  CPPUNIT_ASSERT_EQUAL(ServerStat::PIPELINING_UNKNOWN, ss.getPipelining());
+  ss.setLastUpdated(Time(1000));
+  ss.updatePipeliningDepth(4);
+  CPPUNIT_ASSERT_EQUAL(ServerStat::PIPELINING_OK, ss.getPipelining());
+  CPPUNIT_ASSERT_EQUAL(4, ss.getPipeliningDepth());
+  CPPUNIT_ASSERT(ss.getLastUpdated().getTimeFromEpoch() > 1000);
+
+  ss.setLastUpdated(Time(1000));
+  CPPUNIT_ASSERT_EQUAL(
+      std::string("host=localhost, protocol=http, dl_speed=0,"
+                  " sc_avg_speed=0, mc_avg_speed=0,"
+                  " last_updated=1000, counter=0, status=OK,"
+                  " pipelining=OK, pipelining_depth=4"),
+      ss.toString());
+
+  ss.setPipeliningBroken();
+  CPPUNIT_ASSERT(ss.isPipeliningBroken());
+  CPPUNIT_ASSERT_EQUAL(1, ss.getPipeliningDepth());
+  // Once broken, successful responses do not enable it again.
+  ss.updatePipeliningDepth(8);
+  CPPUNIT_ASSERT(ss.isPipeliningBroken());
+  CPPUNIT_ASSERT_EQUAL(1, ss.getPipeliningDepth());
+
+  // See undefined string will not change current status.
+  ss.setPipelining("__BAD");
+  CPPUNIT_ASSERT_EQUAL(ServerStat::PIPELINING_BROKEN, ss.getPipelining());
+  ss.setPipelining("OK");
+  CPPUNIT_ASSERT_EQUAL(ServerStat::PIPELINING_OK, ss.getPipelining());
+}
+
 } // namespace aria2
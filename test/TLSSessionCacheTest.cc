@@ -0,0 +1,74 @@
+#include "TLSSessionCache.h"
+
+#include <cppunit/extensions/HelperMacros.h>
+
+namespace aria2 {
+
+class TLSSessionCacheTest : public CppUnit::TestFixture {
+
+  CPPUNIT_TEST_SUITE(TLSSessionCacheTest);
+  CPPUNIT_TEST(testPutGet);
+  CPPUNIT_TEST(testEvict);
+  CPPUNIT_TEST(testRemove);
+  CPPUNIT_TEST(testCountHandshake);
+  CPPUNIT_TEST_SUITE_END();
+
+public:
+  void testPutGet();
+  void testEvict();
+  void testRemove();
+  void testCountHandshake();
+};
+
+CPPUNIT_TEST_SUITE_REGISTRATION(TLSSessionCacheTest);
+
+void TLSSessionCacheTest::testPutGet()
+{
+  TLSSessionCache cache;
+  CPPUNIT_ASSERT_EQUAL(std::string(), cache.get("localhost", 443));
+  cache.put("localhost", 443, "alpha");
+  cache.put("localhost", 8443, "bravo");
+  CPPUNIT_ASSERT_EQUAL(std::string("alpha"), cache.get("localhost", 443));
+  CPPUNIT_ASSERT_EQUAL(std::string("bravo"), cache.get("localhost", 8443));
+  // Replace
+  cache.put("localhost", 443, "charlie");
+  CPPUNIT_ASSERT_EQUAL(std::string("charlie"), cache.get("localhost", 443));
+  CPPUNIT_ASSERT_EQUAL((size_t)2, cache.size());
+}
+
+void TLSSessionCacheTest::testEvict()
+{
+  TLSSessionCache cache(2);
+  cache.put("alpha", 443, "1");
+  cache.put("bravo", 443, "2");
+  // alpha becomes the most recently used one
+  CPPUNIT_ASSERT_EQUAL(std::string("1"), cache.get("alpha", 443));
+  cache.put("charlie", 443, "3");
+  CPPUNIT_ASSERT_EQUAL((size_t)2, cache.size());
+  CPPUNIT_ASSERT_EQUAL(std::string(), cache.get("bravo", 443));
+  CPPUNIT_ASSERT_EQUAL(std::string("1"), cache.get("alpha", 443));
+  CPPUNIT_ASSERT_EQUAL(std::string("3"), cache.get("charlie", 443));
+}
+
+void TLSSessionCacheTest::testRemove()
+{
+  TLSSessionCache cache;
+  cache.put("localhost", 443, "alpha");
+  cache.remove("localhost", 443);
+  CPPUNIT_ASSERT_EQUAL(std::string(), cache.get("localhost", 443));
+  CPPUNIT_ASSERT_EQUAL((size_t)0, cache.size());
+  // Removing non-existent entry is no-op
+  cache.remove("localhost", 443);
+}
+
+void TLSSessionCacheTest::testCountHandshake()
+{
+  TLSSessionCache cache;
+  cache.countHandshake(false);
+  cache.countHandshake(true);
+  cache.countHandshake(true);
+  CPPUNIT_ASSERT_EQUAL((uint64_t)2, cache.getHits());
+  CPPUNIT_ASSERT_EQUAL((uint64_t)1, cache.getMisses());
+}
+
+} // namespace aria2
@@ -7,6 +7,7 @@
 #include "TestUtil.h"
 #include "UDPTrackerRequest.h"
 #include "bittorrent_helper.h"
+#include "File.h"
 #include "wallclock.h"
 
 namespace aria2 {
@@ -19,6 +20,8 @@ class UDPTrackerClientTest : public CppUnit::TestFixture {
   CPPUNIT_TEST(testConnectFollowedByAnnounce);
   CPPUNIT_TEST(testRequestFailure);
   CPPUNIT_TEST(testTimeout);
+  CPPUNIT_TEST(testReceiveReply_sameTransactionId);
+  CPPUNIT_TEST(testSaveLoadConnectionIds);
   CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -29,6 +32,8 @@ public:
   void testConnectFollowedByAnnounce();
   void testRequestFailure();
   void testTimeout();
+  void testReceiveReply_sameTransactionId();
+  void testSaveLoadConnectionIds();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(UDPTrackerClientTest);
@@ -468,4 +473,110 @@ void UDPTrackerClientTest::testTimeout()
   }
 }
 
+void UDPTrackerClientTest::testReceiveReply_sameTransactionId()
+{
+  ssize_t rv;
+  unsigned char data[100];
+  std::string remoteAddr;
+  uint16_t remotePort;
+  Timer now;
+  UDPTrackerClient tr;
+  std::shared_ptr<UDPTrackerRequest> recvReq;
+
+  std::shared_ptr<UDPTrackerRequest> req1(
+      createAnnounce("192.168.0.1", 6991, 0));
+  std::shared_ptr<UDPTrackerRequest> req2(
+      createAnnounce("192.168.0.2", 6991, 0));
+  tr.addRequest(req1);
+  tr.addRequest(req2);
+  std::vector<uint32_t> transactionIds;
+  for (int i = 0; i < 2; ++i) {
+    rv = tr.createRequest(data, sizeof(data), remoteAddr, remotePort, now);
+    CPPUNIT_ASSERT_EQUAL((ssize_t)16, rv);
+    transactionIds.push_back(bittorrent::getIntParam(data, 12));
+    tr.requestSent(now);
+  }
+  CPPUNIT_ASSERT_EQUAL((size_t)2, tr.getInflightRequests().size());
+
+  // Reply from wrong host is rejected.
+  rv = createConnectReply(data, sizeof(data), 12345, transactionIds[1]);
+  CPPUNIT_ASSERT_EQUAL(-1, tr.receiveReply(recvReq, data, rv, "192.168.0.1",
+                                           6991, now));
+  CPPUNIT_ASSERT_EQUAL((size_t)2, tr.getInflightRequests().size());
+
+  rv = createConnectReply(data, sizeof(data), 12345, transactionIds[1]);
+  CPPUNIT_ASSERT_EQUAL(0, tr.receiveReply(recvReq, data, rv, "192.168.0.2",
+                                          6991, now));
+  CPPUNIT_ASSERT_EQUAL(std::string("192.168.0.2"), recvReq->remoteAddr);
+  CPPUNIT_ASSERT_EQUAL((size_t)1, tr.getInflightRequests().size());
+  // Duplicate reply is rejected.
+  CPPUNIT_ASSERT_EQUAL(-1, tr.receiveReply(recvReq, data, rv, "192.168.0.2",
+                                           6991, now));
+
+  rv = createConnectReply(data, sizeof(data), 12345, transactionIds[0]);
+  CPPUNIT_ASSERT_EQUAL(0, tr.receiveReply(recvReq, data, rv, "192.168.0.1",
+                                          6991, now));
+  CPPUNIT_ASSERT(tr.getInflightRequests().empty());
+}
+
+void UDPTrackerClientTest::testSaveLoadConnectionIds()
+{
+  ssize_t rv;
+  unsigned char data[100];
+  std::string remoteAddr;
+  uint16_t remotePort;
+  Timer now;
+  std::shared_ptr<UDPTrackerRequest> recvReq;
+  std::string filename =
+      A2_TEST_OUT_DIR "/aria2_UDPTrackerClientTest_testSaveLoadConnectionIds";
+  File(filename).remove();
+  {
+    UDPTrackerClient tr;
+    tr.addRequest(createAnnounce("192.168.0.1", 6991, 0));
+    tr.addRequest(createAnnounce("192.168.0.2", 6991, 0));
+    std::vector<uint32_t> transactionIds;
+    for (int i = 0; i < 2; ++i) {
+      rv = tr.createRequest(data, sizeof(data), remoteAddr, remotePort, now);
+      CPPUNIT_ASSERT_EQUAL((ssize_t)16, rv);
+      transactionIds.push_back(bittorrent::getIntParam(data, 12));
+      tr.requestSent(now);
+    }
+    for (int i = 0; i < 2; ++i) {
+      rv = createConnectReply(data, sizeof(data), INT64_MAX - i,
+                              transactionIds[i]);
+      Timer t = now;
+      // Connection ID of 192.168.0.2 has already expired.
+      t.sub(std::chrono::seconds(10 + 60 * i));
+      CPPUNIT_ASSERT_EQUAL(0, tr.receiveReply(recvReq, data, rv,
+                                              "192.168.0." + util::uitos(i + 1),
+                                              6991, t));
+    }
+    CPPUNIT_ASSERT(tr.saveConnectionIds(filename, now));
+  }
+  {
+    UDPTrackerClient tr;
+    Timer future = now;
+    future.advance(1_h);
+    CPPUNIT_ASSERT(tr.loadConnectionIds(filename, future));
+
+    std::shared_ptr<UDPTrackerRequest> req1(
+        createAnnounce("192.168.0.1", 6991, 0));
+    tr.addRequest(req1);
+    // Loaded connection ID is used without CONNECT request.
+    rv = tr.createRequest(data, sizeof(data), remoteAddr, remotePort, future);
+    CPPUNIT_ASSERT_EQUAL((ssize_t)100, rv);
+    CPPUNIT_ASSERT_EQUAL((int64_t)INT64_MAX,
+                         (int64_t)bittorrent::getLLIntParam(data, 0));
+    tr.requestSent(future);
+
+    std::shared_ptr<UDPTrackerRequest> req2(
+        createAnnounce("192.168.0.2", 6991, 0));
+    tr.addRequest(req2);
+    rv = tr.createRequest(data, sizeof(data), remoteAddr, remotePort, future);
+    CPPUNIT_ASSERT_EQUAL((ssize_t)16, rv);
+    CPPUNIT_ASSERT_EQUAL((int64_t)UDPT_INITIAL_CONNECTION_ID,
+                         (int64_t)bittorrent::getLLIntParam(data, 0));
+  }
+}
+
 } // namespace aria2
@@ -7,6 +7,8 @@
 #include "TestUtil.h"
 #include "DirectDiskAdaptor.h"
 #include "ByteArrayDiskWriter.h"
+#include "WrDiskCacheEntry.h"
+#include "wallclock.h"
 
 namespace aria2 {
 
@@ -14,6 +16,8 @@ class WrDiskCacheTest : public CppUnit::TestFixture {
 
   CPPUNIT_TEST_SUITE(WrDiskCacheTest);
   CPPUNIT_TEST(testAdd);
+  CPPUNIT_TEST(testFlushBackground);
+  CPPUNIT_TEST(testFlushIdle);
   CPPUNIT_TEST_SUITE_END();
 
   std::shared_ptr<DirectDiskAdaptor> adaptor_;
@@ -29,6 +33,8 @@ public:
   }
 
   void testAdd();
+  void testFlushBackground();
+  void testFlushIdle();
 };
 
 CPPUNIT_TEST_SUITE_REGISTRATION(WrDiskCacheTest);
@@ -74,4 +80,58 @@ void WrDiskCacheTest::testAdd()
   CPPUNIT_ASSERT_EQUAL((size_t)0, dc.getSize());
 }
 
+void WrDiskCacheTest::testFlushBackground()
+{
+  WrDiskCache dc(40);
+  WrDiskCacheEntry e1(adaptor_);
+  e1.cacheData(createDataCell(0, "twelve bytes"));
+  CPPUNIT_ASSERT(dc.add(&e1));
+  WrDiskCacheEntry e2(adaptor_);
+  e2.cacheData(createDataCell(12, "0123456789"));
+  CPPUNIT_ASSERT(dc.add(&e2));
+  // Below the high watermark (30 bytes)
+  dc.flushBackground();
+  CPPUNIT_ASSERT_EQUAL((size_t)22, dc.getSize());
+  CPPUNIT_ASSERT_EQUAL(std::string(), writer_->getString());
+
+  WrDiskCacheEntry e3(adaptor_);
+  e3.cacheData(createDataCell(22, "abcdefghij"));
+  CPPUNIT_ASSERT(dc.add(&e3));
+  dc.flushBackground();
+  // Only the largest entry is written to reach the low watermark (20
+  // bytes).
+  CPPUNIT_ASSERT_EQUAL((size_t)20, dc.getSize());
+  CPPUNIT_ASSERT_EQUAL(std::string("twelve bytes"), writer_->getString());
+  CPPUNIT_ASSERT_EQUAL((size_t)0, e1.getSize());
+  CPPUNIT_ASSERT_EQUAL((size_t)10, e2.getSize());
+  CPPUNIT_ASSERT_EQUAL((size_t)10, e3.getSize());
+}
+
+void WrDiskCacheTest::testFlushIdle()
+{
+  WrDiskCache dc(100);
+  WrDiskCacheEntry e1(adaptor_);
+  e1.cacheData(createDataCell(10, "0123456789"));
+  CPPUNIT_ASSERT(dc.add(&e1));
+  WrDiskCacheEntry e2(adaptor_);
+  e2.cacheData(createDataCell(0, "who knows?"));
+  CPPUNIT_ASSERT(dc.add(&e2));
+  WrDiskCacheEntry e3(adaptor_);
+  e3.cacheData(createDataCell(20, "hello"));
+  CPPUNIT_ASSERT(dc.add(&e3));
+
+  dc.flushIdle(30_s);
+  CPPUNIT_ASSERT_EQUAL((size_t)25, dc.getSize());
+
+  Timer t = global::wallclock();
+  t.sub(30_s);
+  e1.setLastUpdateTime(t);
+  e2.setLastUpdateTime(t);
+  dc.flushIdle(30_s);
+  CPPUNIT_ASSERT_EQUAL((size_t)5, dc.getSize());
+  CPPUNIT_ASSERT_EQUAL(std::string("who knows?0123456789"),
+                       writer_->getString());
+  CPPUNIT_ASSERT_EQUAL((size_t)5, e3.getSize());
+}
+
 } // namespace aria2